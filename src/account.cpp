@@ -73,7 +73,7 @@ m_CurrentState(Account::EditState::READY),
 m_pAccountNumber(nullptr),m_pKeyExchangeModel(nullptr),m_pSecurityEvaluationModel(nullptr),m_pTlsMethodModel(nullptr),
 m_pCaCert(nullptr),m_pTlsCert(nullptr),m_pPrivateKey(nullptr),m_isLoaded(true),m_pCipherModel(nullptr),
 m_pStatusModel(nullptr),m_LastTransportCode(0),m_RegistrationState(Account::RegistrationState::UNREGISTERED),
-m_UseDefaultPort(false),m_pProtocolModel(nullptr),m_pBootstrapModel(nullptr),m_RemoteEnabledState(false)
+m_UseDefaultPort(false),m_pProtocolModel(nullptr),m_pBootstrapModel(nullptr),m_RemoteEnabledState(false),m_VolatileSeq(0)
 {
    Q_Q(Account);
 }
@@ -91,6 +91,22 @@ Account::Account():QObject(AccountModel::instance()),d_ptr(new AccountPrivate(th
 
 ///Build an account from it'id
 Account* AccountPrivate::buildExistingAccountFromId(const QByteArray& _accountId)
+{
+   ConfigurationManagerInterface& configurationManager = DBus::ConfigurationManager::instance();
+
+   return buildExistingAccountFromId(_accountId,
+      configurationManager.getAccountDetails        (QString(_accountId)),
+      configurationManager.getVolatileAccountDetails(QString(_accountId))
+   );
+}
+
+/**
+ * Build an account from details already fetched by the caller.
+ *
+ * This allow many accounts to be fetched at once, see
+ * AccountModel::updateAccounts()
+ */
+Account* AccountPrivate::buildExistingAccountFromId(const QByteArray& _accountId, const MapStringString& details, const MapStringString& volatileDetails)
 {
 //    qDebug() << "Building an account from id: " << _accountId;
    Account* a = new Account();
@@ -98,7 +114,12 @@ Account* AccountPrivate::buildExistingAccountFromId(const QByteArray& _accountId
    a->d_ptr->setObjectName(_accountId);
    a->d_ptr->m_RemoteEnabledState = true;
 
-   a->performAction(Account::EditAction::RELOAD);
+   //Equivalent to the RELOAD action of a new account
+   a->d_ptr->reload(details, volatileDetails);
+
+   //Also keep the transport state, as volatileAccountDetailsChanged would
+   if (!volatileDetails.isEmpty())
+      AccountModel::instance()->d_ptr->applyVolatileDetails(a, volatileDetails);
 
    //If a placeholder exist for this account, upgrade it
    if (AccountModel::instance()->d_ptr->m_hsPlaceHolder[_accountId]) {
@@ -1607,7 +1628,15 @@ bool AccountPrivate::updateState()
 {
    if(! q_ptr->isNew()) {
       ConfigurationManagerInterface& configurationManager = DBus::ConfigurationManager::instance();
-      const MapStringString details        = configurationManager.getVolatileAccountDetails(q_ptr->id());
+      return updateState(configurationManager.getVolatileAccountDetails(q_ptr->id()));
+   }
+   return true;
+}
+
+///Update the account from volatile details already fetched
+bool AccountPrivate::updateState(const MapStringString& details)
+{
+   if(! q_ptr->isNew()) {
       const QString         status         = details[DRing::Account::VolatileProperties::Registration::STATUS];
       const Account::RegistrationState cst = q_ptr->registrationState();
       const Account::RegistrationState st  = AccountModelPrivate::fromDaemonName(status);
@@ -1698,52 +1727,63 @@ void AccountPrivate::save()
 void AccountPrivate::reload()
 {
    if (!q_ptr->isNew()) {
-      if (m_hAccountDetails.size())
-         qDebug() << "Reloading" << q_ptr->id() << q_ptr->alias();
-      else
-         qDebug() << "Loading" << q_ptr->id();
       ConfigurationManagerInterface& configurationManager = DBus::ConfigurationManager::instance();
-      QMap<QString,QString> aDetails = configurationManager.getAccountDetails(q_ptr->id());
+      applyDetails(configurationManager.getAccountDetails(q_ptr->id()));
 
-      if (!aDetails.count()) {
-         qDebug() << "Account not found";
-      }
-      else {
-         m_hAccountDetails.clear();
-         QMutableMapIterator<QString, QString> iter(aDetails);
-         while (iter.hasNext()) {
-            iter.next();
-            m_hAccountDetails[iter.key()] = iter.value();
-         }
-         q_ptr->setHostname(m_hAccountDetails[DRing::Account::ConfProperties::HOSTNAME]);
-         m_RemoteEnabledState = q_ptr->isEnabled();
-      }
-      m_CurrentState = Account::EditState::READY;
+      //The registration state is cached, update that cache
+      updateState();
 
-      //TODO port this to the URI class helpers, this doesn't cover all corner cases
-      const QString currentUri = QString("%1@%2").arg(q_ptr->username()).arg(m_HostName);
+      AccountModel::instance()->d_ptr->fetchVolatileDetails(q_ptr);
+   }
+}
 
-      if (!m_pAccountNumber || (m_pAccountNumber && m_pAccountNumber->uri() != currentUri)) {
-         if (m_pAccountNumber) {
-            disconnect(m_pAccountNumber,SIGNAL(presenceMessageChanged(QString)),this,SLOT(slotPresenceMessageChanged(QString)));
-            disconnect(m_pAccountNumber,SIGNAL(presentChanged(bool)),this,SLOT(slotPresentChanged(bool)));
-         }
-         m_pAccountNumber = PhoneDirectoryModel::instance()->getNumber(currentUri,q_ptr);
-         m_pAccountNumber->setType(ContactMethod::Type::ACCOUNT);
-         connect(m_pAccountNumber,SIGNAL(presenceMessageChanged(QString)),this,SLOT(slotPresenceMessageChanged(QString)));
-         connect(m_pAccountNumber,SIGNAL(presentChanged(bool)),this,SLOT(slotPresentChanged(bool)));
-      }
+///Reload from details already fetched, without any round-trip to the daemon
+void AccountPrivate::reload(const MapStringString& details, const MapStringString& volatileDetails)
+{
+   if (!q_ptr->isNew()) {
+      applyDetails(details);
+      updateState(volatileDetails);
+   }
+}
 
-      //If the credential model is loaded, then update it
-      if (m_pCredentials)
-         m_pCredentials << CredentialModel::EditAction::RELOAD;
-      emit q_ptr->changed(q_ptr);
+///Replace the account details
+void AccountPrivate::applyDetails(const MapStringString& aDetails)
+{
+   if (m_hAccountDetails.size())
+      qDebug() << "Reloading" << q_ptr->id() << q_ptr->alias();
+   else
+      qDebug() << "Loading" << q_ptr->id();
 
-      //The registration state is cached, update that cache
-      updateState();
+   if (!aDetails.count()) {
+      qDebug() << "Account not found";
+   }
+   else {
+      m_hAccountDetails.clear();
+      for (auto iter = aDetails.constBegin(); iter != aDetails.constEnd(); ++iter)
+         m_hAccountDetails[iter.key()] = iter.value();
+      q_ptr->setHostname(m_hAccountDetails[DRing::Account::ConfProperties::HOSTNAME]);
+      m_RemoteEnabledState = q_ptr->isEnabled();
+   }
+   m_CurrentState = Account::EditState::READY;
+
+   //TODO port this to the URI class helpers, this doesn't cover all corner cases
+   const QString currentUri = QString("%1@%2").arg(q_ptr->username()).arg(m_HostName);
 
-      AccountModel::instance()->d_ptr->slotVolatileAccountDetailsChange(q_ptr->id(),configurationManager.getVolatileAccountDetails(q_ptr->id()));
+   if (!m_pAccountNumber || (m_pAccountNumber && m_pAccountNumber->uri() != currentUri)) {
+      if (m_pAccountNumber) {
+         disconnect(m_pAccountNumber,SIGNAL(presenceMessageChanged(QString)),this,SLOT(slotPresenceMessageChanged(QString)));
+         disconnect(m_pAccountNumber,SIGNAL(presentChanged(bool)),this,SLOT(slotPresentChanged(bool)));
+      }
+      m_pAccountNumber = PhoneDirectoryModel::instance()->getNumber(currentUri,q_ptr);
+      m_pAccountNumber->setType(ContactMethod::Type::ACCOUNT);
+      connect(m_pAccountNumber,SIGNAL(presenceMessageChanged(QString)),this,SLOT(slotPresenceMessageChanged(QString)));
+      connect(m_pAccountNumber,SIGNAL(presentChanged(bool)),this,SLOT(slotPresentChanged(bool)));
    }
+
+   //If the credential model is loaded, then update it
+   if (m_pCredentials)
+      m_pCredentials << CredentialModel::EditAction::RELOAD;
+   emit q_ptr->changed(q_ptr);
 }
 
 void AccountPrivate::nothing()
@@ -24,6 +24,10 @@
 #include <QtCore/QCoreApplication>
 #include <QtCore/QItemSelectionModel>
 #include <QtCore/QMimeData>
+#include <QtCore/QSharedPointer>
+
+//STD
+#include <algorithm>
 
 //Ring daemon
 #include <account_const.h>
@@ -39,6 +43,7 @@
 #include "dbus/configurationmanager.h"
 #include "dbus/callmanager.h"
 #include "dbus/instancemanager.h"
+#include "dbus/asyncquery.h"
 
 QHash<QByteArray,AccountPlaceHolder*> AccountModelPrivate::m_hsPlaceHolder;
 AccountModel*     AccountModelPrivate::m_spAccountList;
@@ -49,7 +54,7 @@ m_lSupportedProtocols {{
    /* SIP  */ false,
    /* IAX  */ false,
    /* RING */ false,
-}}
+}},m_IsLoaded(false)
 {
 }
 
@@ -147,6 +152,12 @@ QHash<int,QByteArray> AccountModel::roleNames() const
 }
 #undef CAST
 
+///If the first account list was received, see accountsLoaded()
+bool AccountModel::isLoaded() const
+{
+   return d_ptr->m_IsLoaded;
+}
+
 ///Get the IP2IP account
 Account* AccountModel::ip2ip() const
 {
@@ -279,7 +290,7 @@ void AccountModelPrivate::slotDaemonAccountChanged(const QString& account, const
 
       //Make sure volatile details get reloaded
       //TODO eventually remove this call and trust the signal
-      slotVolatileAccountDetailsChange(account,configurationManager.getVolatileAccountDetails(account));
+      fetchVolatileDetails(a);
 
       emit q_ptr->accountStateChanged(a,a->registrationState());
    }
@@ -330,82 +341,250 @@ void AccountModelPrivate::slotVolatileAccountDetailsChange(const QString& accoun
 {
    Account* a = q_ptr->getById(accountId.toLatin1());
    if (a) {
-      const int     transportCode = details[DRing::Account::VolatileProperties::Transport::STATE_CODE].toInt();
-      const QString transportDesc = details[DRing::Account::VolatileProperties::Transport::STATE_DESC];
-      const QString status        = details[DRing::Account::VolatileProperties::Registration::STATUS];
+      //The replies to the queries sent before are now outdated
+      ++a->d_ptr->m_VolatileSeq;
+      applyVolatileDetails(a, details);
+   }
+}
 
-      a->statusModel()->addTransportEvent(transportDesc,transportCode);
+/**
+ * Query the volatile details without blocking.
+ *
+ * The reply is dropped if the details were updated in the meantime, either
+ * by the volatileAccountDetailsChanged signal or by a more recent query.
+ */
+void AccountModelPrivate::fetchVolatileDetails(Account* a)
+{
+   const uint seq = ++a->d_ptr->m_VolatileSeq;
 
-      a->d_ptr->m_LastTransportCode    = transportCode;
-      a->d_ptr->m_LastTransportMessage = transportDesc;
+   DBus::AsyncQuery::getVolatileAccountDetails(a->id(), a->d_ptr, [this, a, seq](const MapStringString& details, bool ok) {
+      if (ok && a->d_ptr->m_VolatileSeq == seq)
+         applyVolatileDetails(a, details);
+   });
+}
 
-      const Account::RegistrationState state = fromDaemonName(a->d_ptr->accountDetail(DRing::Account::ConfProperties::Registration::STATUS));
-      a->d_ptr->m_RegistrationState = state;
-   }
+///Record the transport state and the registration state
+void AccountModelPrivate::applyVolatileDetails(Account* a, const MapStringString& details)
+{
+   const int     transportCode = details[DRing::Account::VolatileProperties::Transport::STATE_CODE].toInt();
+   const QString transportDesc = details[DRing::Account::VolatileProperties::Transport::STATE_DESC];
+   const QString status        = details[DRing::Account::VolatileProperties::Registration::STATUS];
+
+   a->statusModel()->addTransportEvent(transportDesc,transportCode);
+
+   a->d_ptr->m_LastTransportCode    = transportCode;
+   a->d_ptr->m_LastTransportMessage = transportDesc;
+
+   const Account::RegistrationState state = fromDaemonName(a->d_ptr->accountDetail(DRing::Account::ConfProperties::Registration::STATUS));
+   a->d_ptr->m_RegistrationState = state;
 }
 
 ///Update accounts
 void AccountModel::update()
 {
    ConfigurationManagerInterface & configurationManager = DBus::ConfigurationManager::instance();
-   QList<Account*> tmp;
-   for (int i = 0; i < d_ptr->m_lAccounts.size(); i++)
-      tmp << d_ptr->m_lAccounts[i];
 
-   for (int i = 0; i < tmp.size(); i++) {
-      Account* current = tmp[i];
-      if (!current->isNew() && (current->editState() != Account::EditState::NEW
-         && current->editState() != Account::EditState::MODIFIED
-         && current->editState() != Account::EditState::OUTDATED))
-         remove(current);
-   }
    //ask for the list of accounts ids to the configurationManager
    const QStringList accountIds = configurationManager.getAccountList();
-   for (int i = 0; i < accountIds.size(); ++i) {
-      if (d_ptr->m_lDeletedAccounts.indexOf(accountIds[i]) == -1) {
-         Account* a = AccountPrivate::buildExistingAccountFromId(accountIds[i].toLatin1());
-         d_ptr->m_lAccounts.insert(i, a);
-         emit dataChanged(index(i,0),index(size()-1,0));
-         connect(a,SIGNAL(changed(Account*)),d_ptr,SLOT(slotAccountChanged(Account*)));
-         //connect(a,SIGNAL(propertyChanged(Account*,QString,QString,QString)),d_ptr,SLOT(slotAccountChanged(Account*)));
-         connect(a,SIGNAL(presenceEnabledChanged(bool)),d_ptr,SLOT(slotAccountPresenceEnabledChanged(bool)));
-         emit layoutChanged();
-
-         if (a->id() != DRing::Account::ProtocolNames::IP2IP)
-            d_ptr->enableProtocol(a->protocol());
-      }
+
+   QStringList newIds;
+   foreach(const QString& id, accountIds) {
+      if (d_ptr->m_lDeletedAccounts.indexOf(id) == -1)
+         newIds << id;
    }
+
+   //Fetch everything without blocking, then rebuild the list in a single reset
+   QSharedPointer<AccountModelPrivate::Replies> r { new AccountModelPrivate::Replies { {}, {}, 2 } };
+
+   const auto done = [this, r, accountIds, newIds]() {
+      if (--r->pending)
+         return;
+
+      QList<Account*> tmp;
+      for (int i = 0; i < d_ptr->m_lAccounts.size(); i++)
+         tmp << d_ptr->m_lAccounts[i];
+
+      for (int i = 0; i < tmp.size(); i++) {
+         Account* current = tmp[i];
+         if (!current->isNew() && (current->editState() != Account::EditState::NEW
+            && current->editState() != Account::EditState::MODIFIED
+            && current->editState() != Account::EditState::OUTDATED))
+            remove(current);
+      }
+
+      d_ptr->addAccounts(accountIds, newIds, r->details, r->volatileDetails);
+   };
+
+   DBus::AsyncQuery::accountDetails(newIds, d_ptr, [r, done](const QHash<QString,MapStringString>& details) {
+      r->details = details;
+      done();
+   });
+
+   DBus::AsyncQuery::volatileAccountDetails(newIds, d_ptr, [r, done](const QHash<QString,MapStringString>& details) {
+      r->volatileDetails = details;
+      done();
+   });
 } //update
 
-///Update accounts
+/**
+ * Update accounts
+ *
+ * The details of the new accounts, and of the existing ones which have to
+ * be reloaded, are fetched without blocking. accountListUpdated() is
+ * emitted once they are applied.
+ */
 void AccountModel::updateAccounts()
 {
    qDebug() << "Updating all accounts";
    ConfigurationManagerInterface& configurationManager = DBus::ConfigurationManager::instance();
    QStringList accountIds = configurationManager.getAccountList();
-   //m_lAccounts.clear();
-   for (int i = 0; i < accountIds.size(); ++i) {
-      Account* acc = getById(accountIds[i].toLatin1());
-      if (!acc) {
-         Account* a = AccountPrivate::buildExistingAccountFromId(accountIds[i].toLatin1());
-         beginInsertRows(QModelIndex(),d_ptr->m_lAccounts.size(),d_ptr->m_lAccounts.size());
-         d_ptr->m_lAccounts += a;
-         endInsertRows();
-         connect(a,SIGNAL(changed(Account*)),d_ptr,SLOT(slotAccountChanged(Account*)));
-         //connect(a,SIGNAL(propertyChanged(Account*,QString,QString,QString)),d_ptr,SLOT(slotAccountChanged(Account*)));
-         connect(a,SIGNAL(presenceEnabledChanged(bool)),d_ptr,SLOT(slotAccountPresenceEnabledChanged(bool)));
-         emit dataChanged(index(size()-1,0),index(size()-1,0));
-
-         if (a->id() != DRing::Account::ProtocolNames::IP2IP)
-            d_ptr->enableProtocol(a->protocol());
-      }
-      else {
+
+   QStringList        newIds;
+   QHash<QString,uint> seqs  ; /*!< The accounts to reload */
+   foreach(const QString& id, accountIds) {
+      Account* acc = getById(id.toLatin1());
+      if (!acc)
+         newIds << id;
+      //Only the READY accounts reload the details, see the RELOAD action
+      else if (acc->editState() == Account::EditState::READY)
+         seqs[id] = ++acc->d_ptr->m_VolatileSeq;
+      else
          acc->performAction(Account::EditAction::RELOAD);
-      }
    }
-   emit accountListUpdated();
+
+   const QStringList ids = newIds + seqs.keys();
+
+   if (ids.isEmpty()) {
+      d_ptr->listUpdated();
+      return;
+   }
+
+   //Pipeline the queries instead of paying a round-trip per account
+   QSharedPointer<AccountModelPrivate::Replies> r { new AccountModelPrivate::Replies { {}, {}, 2 } };
+
+   const auto done = [this, r, accountIds, newIds, seqs]() {
+      if (--r->pending)
+         return;
+
+      d_ptr->reloadAccounts(seqs                , r->details, r->volatileDetails);
+      d_ptr->addAccounts   (accountIds, newIds, r->details, r->volatileDetails);
+
+      d_ptr->listUpdated();
+   };
+
+   DBus::AsyncQuery::accountDetails(ids, d_ptr, [r, done](const QHash<QString,MapStringString>& details) {
+      r->details = details;
+      done();
+   });
+
+   DBus::AsyncQuery::volatileAccountDetails(ids, d_ptr, [r, done](const QHash<QString,MapStringString>& details) {
+      r->volatileDetails = details;
+      done();
+   });
 } //updateAccounts
 
+/**
+ * Apply the details fetched for the existing accounts.
+ *
+ * This is the RELOAD action, without the round-trips. The accounts edited
+ * since the query was sent get the action instead, to be outdated. The
+ * volatile details are dropped if newer ones were received meanwhile.
+ */
+void AccountModelPrivate::reloadAccounts(const QHash<QString,uint>& seqs, const QHash<QString,MapStringString>& details,
+                                         const QHash<QString,MapStringString>& volatileDetails)
+{
+   for (auto i = seqs.constBegin(); i != seqs.constEnd(); ++i) {
+      Account* a = q_ptr->getById(i.key().toLatin1());
+
+      //Removed meanwhile, or the query failed
+      if ((!a) || !details.contains(i.key()))
+         continue;
+
+      if (a->editState() != Account::EditState::READY) {
+         a->performAction(Account::EditAction::RELOAD);
+         continue;
+      }
+
+      a->d_ptr->applyDetails(details[i.key()]);
+
+      if (volatileDetails.contains(i.key()) && a->d_ptr->m_VolatileSeq == i.value()) {
+         a->d_ptr->updateState(volatileDetails[i.key()]);
+         applyVolatileDetails(a, volatileDetails[i.key()]);
+      }
+   }
+}
+
+///Notify the list update, and the first load
+void AccountModelPrivate::listUpdated()
+{
+   emit q_ptr->accountListUpdated();
+
+   if (!m_IsLoaded) {
+      m_IsLoaded = true;
+      emit q_ptr->accountsLoaded();
+   }
+}
+
+/**
+ * Build the accounts from the fetched details and add them to the model.
+ *
+ * The rows follow the daemon order (accountIds), the accounts unknown to
+ * the daemon, such as the new ones, stay after them.
+ */
+void AccountModelPrivate::addAccounts(const QStringList& accountIds, const QStringList& ids,
+                                      const QHash<QString,MapStringString>& details,
+                                      const QHash<QString,MapStringString>& volatileDetails)
+{
+   QList<Account*> added;
+   added.reserve(ids.size());
+
+   foreach(const QString& id, ids) {
+      //Already added by a concurrent update, or the query failed
+      if (q_ptr->getById(id.toLatin1()) || !details.contains(id))
+         continue;
+
+      added << AccountPrivate::buildExistingAccountFromId(id.toLatin1(), details[id], volatileDetails.value(id));
+   }
+
+   if (added.isEmpty())
+      return;
+
+   const auto rank = [&accountIds](Account* a) {
+      const int i = accountIds.indexOf(QString::fromLatin1(a->id()));
+      return i == -1 ? accountIds.size() : i;
+   };
+
+   //A single reset is much cheaper for the views than one insertion per row
+   if (added.size() > 1) {
+      q_ptr->beginResetModel();
+      m_lAccounts += added.toVector();
+      std::stable_sort(m_lAccounts.begin(), m_lAccounts.end(), [&rank](Account* a, Account* b) {
+         return rank(a) < rank(b);
+      });
+      q_ptr->endResetModel();
+   }
+   else {
+      Account* a   = added.first();
+      int      row = 0;
+
+      while (row < m_lAccounts.size() && rank(m_lAccounts[row]) <= rank(a))
+         row++;
+
+      q_ptr->beginInsertRows(QModelIndex(),row,row);
+      m_lAccounts.insert(row, a);
+      q_ptr->endInsertRows();
+   }
+
+   foreach(Account* a, added) {
+      connect(a,SIGNAL(changed(Account*)),this,SLOT(slotAccountChanged(Account*)));
+      //connect(a,SIGNAL(propertyChanged(Account*,QString,QString,QString)),this,SLOT(slotAccountChanged(Account*)));
+      connect(a,SIGNAL(presenceEnabledChanged(bool)),this,SLOT(slotAccountPresenceEnabledChanged(bool)));
+
+      if (a->id() != DRing::Account::ProtocolNames::IP2IP)
+         enableProtocol(a->protocol());
+   }
+}
+
 ///Save accounts details and reload it
 void AccountModel::save()
 {
@@ -626,7 +805,9 @@ bool AccountModel::isIAXSupported() const
 bool AccountModel::isIP2IPSupported() const
 {
    //When this account isn't enable, it is as it wasn't there at all
-   return ip2ip()->isEnabled();
+   //It is also missing until the accounts are loaded
+   Account* a = ip2ip();
+   return a && a->isEnabled();
 }
 
 bool AccountModel::isRingSupported() const
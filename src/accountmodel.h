@@ -29,7 +29,15 @@
 //Private
 class AccountModelPrivate;
 
-///AccountList: List of all daemon accounts
+/**
+ * AccountList: List of all daemon accounts
+ *
+ * The accounts are loaded without blocking: the model is empty when
+ * instance() returns and getById(), ip2ip() or the current account are
+ * null until the first list is received. accountsLoaded() is emitted once
+ * it is, isLoaded() tells if it already happened. Use getById() with a
+ * placeholder to reference an account before that.
+ */
 class LIB_EXPORT AccountModel : public QAbstractListModel {
    #pragma GCC diagnostic push
    #pragma GCC diagnostic ignored "-Wzero-as-null-pointer-constant"
@@ -38,6 +46,7 @@ class LIB_EXPORT AccountModel : public QAbstractListModel {
 
 public:
    Q_PROPERTY(Account*       ip2ip                      READ ip2ip                                            )
+   Q_PROPERTY(bool           loaded                     READ isLoaded         NOTIFY accountsLoaded           )
    Q_PROPERTY(bool           presenceEnabled            READ isPresenceEnabled                                )
    Q_PROPERTY(bool           presencePublishSupported   READ isPresencePublishSupported                       )
    Q_PROPERTY(bool           presenceSubscribeSupported READ isPresenceSubscribeSupported                     )
@@ -61,6 +70,7 @@ public:
    Account*             getAccountByModelIndex      ( const QModelIndex& item              ) const;
    static QString       getSimilarAliasIndex        ( const QString& alias                 )      ;
    Account*             ip2ip                       (                                      ) const;
+   bool                 isLoaded                    (                                      ) const;
    bool                 isPresenceEnabled           (                                      ) const;
    bool                 isPresencePublishSupported  (                                      ) const;
    bool                 isPresenceSubscribeSupported(                                      ) const;
@@ -119,6 +129,8 @@ public Q_SLOTS:
 Q_SIGNALS:
    ///The account list changed
    void accountListUpdated(                                          );
+   ///The first account list has been loaded, see isLoaded()
+   void accountsLoaded(                                              );
    ///Emitted when an account enable attribute change
    void accountEnabledChanged( Account* source                       );
    ///Emitted when the default account change
@@ -0,0 +1,77 @@
+/****************************************************************************
+ *   Copyright (C) 2015 by Savoir-Faire Linux                               *
+ *   Author : Emmanuel Lepage Vallee <emmanuel.lepage@savoirfairelinux.com> *
+ *                                                                          *
+ *   This library is free software; you can redistribute it and/or          *
+ *   modify it under the terms of the GNU Lesser General Public             *
+ *   License as published by the Free Software Foundation; either           *
+ *   version 2.1 of the License, or (at your option) any later version.     *
+ *                                                                          *
+ *   This library is distributed in the hope that it will be useful,        *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU      *
+ *   Lesser General Public License for more details.                        *
+ *                                                                          *
+ *   You should have received a copy of the GNU General Public License      *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>.  *
+ ***************************************************************************/
+
+//Qt
+#include <QtCore/QCommandLineParser>
+#include <QtCore/QCoreApplication>
+#include <QtCore/QTextStream>
+
+//Ring
+#include "rendererbenchmark.h"
+
+int main(int argc, char** argv)
+{
+   QCoreApplication app(argc, argv);
+
+   QCommandLineParser parser;
+   parser.setApplicationDescription("Measure the shared memory video rendering path, without a daemon");
+   parser.addHelpOption();
+
+   const QCommandLineOption width   ({"W","width"   }, "Frame width"                                 , "px"     , "1280");
+   const QCommandLineOption height  ({"H","height"  }, "Frame height"                                , "px"     , "720" );
+   const QCommandLineOption fps     ({"f","fps"     }, "Frames published per second"                 , "fps"    , "30"  );
+   const QCommandLineOption duration({"d","duration"}, "Duration of the run"                         , "ms"     , "10000");
+   const QCommandLineOption resize  ({"r","resize"  }, "Alternate the resolution every ms, 0 to never", "ms"     , "0"   );
+   const QCommandLineOption protocol({"p","protocol"}, "Shared memory protocol version, 1 or 2"      , "version", "2"   );
+   const QCommandLineOption noFifo  ("no-fifo"       , "Do not create the notification FIFO"         );
+
+   parser.addOptions({width, height, fps, duration, resize, protocol, noFifo});
+   parser.process(app);
+
+   Video::RendererBenchmark benchmark;
+
+   benchmark.setResolution     ( QSize(parser.value(width).toInt(), parser.value(height).toInt()) );
+   benchmark.setFrameRate      ( parser.value(fps     ).toInt()  );
+   benchmark.setDuration       ( parser.value(duration).toInt()  );
+   benchmark.setResizeInterval ( parser.value(resize  ).toInt()  );
+   benchmark.setProtocolVersion( parser.value(protocol).toUInt() );
+   benchmark.setNotification   ( !parser.isSet(noFifo)           );
+
+   QObject::connect(&benchmark, &Video::RendererBenchmark::finished, [&app](const Video::RendererBenchmark::Result& r) {
+      QTextStream out(stdout);
+      out << "Produced frames:  " << r.producedFrames           << '\n'
+          << "Rendered frames:  " << r.renderedFrames           << '\n'
+          << "Throughput:       " << r.throughput    << " fps"  << '\n'
+          << "Mean latency:     " << r.meanLatency   << " ms"   << '\n'
+          << "P99 latency:      " << r.p99Latency    << " ms"   << '\n'
+          << "Max latency:      " << r.maxLatency    << " ms"   << '\n'
+          << "CPU per frame:    " << r.cpuPerFrame   << " us"   << '\n'
+          << "Lock wait time:   " << r.lockWaitTime  << " us"   << '\n'
+          << "Dropped frames:   " << r.droppedFrames            << '\n'
+          << "Remaps:           " << r.remapCount               << '\n'
+          << "Remap time:       " << r.remapTime     << " us"   << '\n';
+      app.quit();
+   });
+
+   if (!benchmark.start()) {
+      QTextStream(stderr) << "The benchmark could not be started\n";
+      return 1;
+   }
+
+   return app.exec();
+}
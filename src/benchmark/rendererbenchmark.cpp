@@ -0,0 +1,403 @@
+/****************************************************************************
+ *   Copyright (C) 2015 by Savoir-Faire Linux                               *
+ *   Author : Emmanuel Lepage Vallee <emmanuel.lepage@savoirfairelinux.com> *
+ *                                                                          *
+ *   This library is free software; you can redistribute it and/or          *
+ *   modify it under the terms of the GNU Lesser General Public             *
+ *   License as published by the Free Software Foundation; either           *
+ *   version 2.1 of the License, or (at your option) any later version.     *
+ *                                                                          *
+ *   This library is distributed in the hope that it will be useful,        *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU      *
+ *   Lesser General Public License for more details.                        *
+ *                                                                          *
+ *   You should have received a copy of the GNU General Public License      *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>.  *
+ ***************************************************************************/
+#include "rendererbenchmark.h"
+
+//Qt
+#include <QtCore/QMutex>
+#include <QtCore/QThread>
+#include <QtCore/QTimer>
+#include <QtCore/QVector>
+
+//System
+#include <time.h>
+#include <unistd.h>
+
+//libstdc++
+#include <algorithm>
+
+//Ring
+#include "video/renderer.h"
+#include "private/shmrenderer.h"
+#include "shmproducer.h"
+
+namespace Video {
+
+/**
+ * Own the renderer of a run.
+ *
+ * The driver live in the renderer thread, so the renderer is created,
+ * resized and destroyed from the thread it belong to, like the ones managed
+ * by VideoRendererManager.
+ */
+class RendererDriver : public QObject
+{
+   Q_OBJECT
+public:
+   RendererDriver(const QByteArray& id, const QString& path, Video::Renderer::Sink* sink);
+
+   //Attributes
+   QByteArray                   m_Id        ;
+   QString                      m_Path      ;
+   Video::Renderer::Sink*       m_pSink     ;
+   Video::ShmRenderer*          m_pRenderer ;
+   Video::Renderer::Statistics  m_Statistics; /*!< Set once stopped */
+
+public Q_SLOTS:
+   bool start (const QSize& size);
+   void resize(const QSize& size);
+   void stop  ();
+};
+
+class RendererBenchmarkPrivate : public QObject, public Video::Renderer::Sink
+{
+   Q_OBJECT
+public:
+   RendererBenchmarkPrivate(RendererBenchmark* parent);
+
+   //Attributes
+   QSize                      m_Resolution     ;
+   int                        m_FrameRate      ;
+   int                        m_Duration       ;
+   int                        m_ResizeInterval ;
+   uint                       m_ProtocolVersion;
+   bool                       m_Notification   ;
+   QSize                      m_CurrentSize    ; /*!< Last size sent to the producer */
+   Video::ShmProducer*        m_pProducer      ;
+   Video::RendererDriver*     m_pDriver        ;
+   QThread*                   m_pThread        ; /*!< The producer thread            */
+   QThread*                   m_pRendererThread;
+   QTimer*                    m_pDurationTimer ;
+   QTimer*                    m_pResizeTimer   ;
+   qint64                     m_StartTime      ;
+   qint64                     m_StartCpu       ;
+   QMutex                     m_Mutex          ; /*!< Protect m_lLatencies */
+   QVector<qint64>            m_lLatencies     ; /*!< In µs                */
+   RendererBenchmark::Result  m_Result         ;
+
+   //Helpers
+   static qint64 now(clockid_t clock);
+   void cleanup();
+
+   //Sink
+   virtual void frameReady(const Video::Renderer::SharedFrame& frame) override;
+
+private:
+   RendererBenchmark* q_ptr;
+
+public Q_SLOTS:
+   void slotResize();
+};
+
+}
+
+Video::RendererDriver::RendererDriver(const QByteArray& id, const QString& path, Video::Renderer::Sink* sink) :
+QObject(), m_Id(id), m_Path(path), m_pSink(sink), m_pRenderer(nullptr), m_Statistics{}
+{
+}
+
+///Create the renderer and start reading the frames
+bool Video::RendererDriver::start(const QSize& size)
+{
+   m_pRenderer = new Video::ShmRenderer(m_Id, m_Path, size);
+   m_pRenderer->addSink(m_pSink);
+   m_pRenderer->startRendering();
+
+   return m_pRenderer->isRendering();
+}
+
+///Follow a producer resize, as VideoRendererManager does for the daemon
+void Video::RendererDriver::resize(const QSize& size)
+{
+   if (m_pRenderer)
+      m_pRenderer->setSize(size);
+}
+
+///Collect the statistics and destroy the renderer
+void Video::RendererDriver::stop()
+{
+   if (!m_pRenderer)
+      return;
+
+   m_pRenderer->removeSink(m_pSink);
+   m_Statistics = m_pRenderer->statistics();
+   m_pRenderer->stopRendering();
+
+   delete m_pRenderer;
+   m_pRenderer = nullptr;
+}
+
+Video::RendererBenchmarkPrivate::RendererBenchmarkPrivate(RendererBenchmark* parent) : QObject(parent), q_ptr(parent),
+m_Resolution(1280, 720), m_FrameRate(30), m_Duration(10000), m_ResizeInterval(0), m_ProtocolVersion(2),
+m_Notification(true), m_pProducer(nullptr), m_pDriver(nullptr), m_pThread(nullptr), m_pRendererThread(nullptr),
+m_pDurationTimer(new QTimer(this)), m_pResizeTimer(new QTimer(this)), m_StartTime(0), m_StartCpu(0), m_Result{}
+{
+   m_pDurationTimer->setSingleShot(true);
+
+   connect(m_pDurationTimer, &QTimer::timeout, q_ptr, &RendererBenchmark::stop    );
+   connect(m_pResizeTimer  , &QTimer::timeout, this , &RendererBenchmarkPrivate::slotResize);
+}
+
+Video::RendererBenchmark::RendererBenchmark(QObject* parent) : QObject(parent),
+d_ptr(new RendererBenchmarkPrivate(this))
+{
+}
+
+Video::RendererBenchmark::~RendererBenchmark()
+{
+   stop();
+   delete d_ptr;
+}
+
+///A clock value, in µs
+qint64 Video::RendererBenchmarkPrivate::now(clockid_t clock)
+{
+   timespec t;
+   ::clock_gettime(clock, &t);
+   return static_cast<qint64>(t.tv_sec) * 1000000 + t.tv_nsec / 1000;
+}
+
+///Stop both threads and free the run objects
+void Video::RendererBenchmarkPrivate::cleanup()
+{
+   m_pRendererThread->quit();
+   m_pRendererThread->wait();
+
+   m_pThread->quit();
+   m_pThread->wait();
+
+   {
+      QMutexLocker lk {&m_Mutex};
+      m_pProducer->close();
+      delete m_pProducer;
+      m_pProducer = nullptr;
+   }
+
+   delete m_pDriver        ;
+   delete m_pRendererThread;
+   delete m_pThread        ;
+
+   m_pDriver         = nullptr;
+   m_pRendererThread = nullptr;
+   m_pThread         = nullptr;
+}
+
+///Measure the latency of each frame, called from the renderer thread
+void Video::RendererBenchmarkPrivate::frameReady(const Video::Renderer::SharedFrame& frame)
+{
+   const qint64 received = now(CLOCK_MONOTONIC);
+
+   QMutexLocker lk {&m_Mutex};
+
+   // A frame may still be in flight when the run is stopped
+   if (!m_pProducer)
+      return;
+
+   const qint64 published = m_pProducer->publishTime(frame.frameGen);
+
+   if (published)
+      m_lLatencies << received - published;
+}
+
+///Alternate between the full and half resolution
+void Video::RendererBenchmarkPrivate::slotResize()
+{
+   m_CurrentSize = m_CurrentSize == m_Resolution ? m_Resolution / 2 : m_Resolution;
+
+   QMetaObject::invokeMethod(m_pProducer, "setResolution", Qt::QueuedConnection, Q_ARG(QSize, m_CurrentSize));
+
+   // Each object is resized from its own thread
+   QMetaObject::invokeMethod(m_pDriver  , "resize"       , Qt::QueuedConnection, Q_ARG(QSize, m_CurrentSize));
+}
+
+/*****************************************************************************
+ *                                                                           *
+ *                                 Getters                                   *
+ *                                                                           *
+ ****************************************************************************/
+
+bool Video::RendererBenchmark::isRunning() const
+{
+   return d_ptr->m_pProducer;
+}
+
+///The result of the last run
+Video::RendererBenchmark::Result Video::RendererBenchmark::result() const
+{
+   return d_ptr->m_Result;
+}
+
+/*****************************************************************************
+ *                                                                           *
+ *                                 Setters                                   *
+ *                                                                           *
+ ****************************************************************************/
+
+void Video::RendererBenchmark::setResolution(const QSize& size)
+{
+   d_ptr->m_Resolution = size;
+}
+
+void Video::RendererBenchmark::setFrameRate(int fps)
+{
+   d_ptr->m_FrameRate = fps;
+}
+
+///How long a run last, in ms
+void Video::RendererBenchmark::setDuration(int ms)
+{
+   d_ptr->m_Duration = ms;
+}
+
+///Resize the frames every ms, 0 to keep the same resolution
+void Video::RendererBenchmark::setResizeInterval(int ms)
+{
+   d_ptr->m_ResizeInterval = ms;
+}
+
+///The shared memory protocol used by the producer, 1 for the semaphore only one
+void Video::RendererBenchmark::setProtocolVersion(uint version)
+{
+   d_ptr->m_ProtocolVersion = version;
+}
+
+///Let the producer create a notification FIFO
+void Video::RendererBenchmark::setNotification(bool enabled)
+{
+   d_ptr->m_Notification = enabled;
+}
+
+/*****************************************************************************
+ *                                                                           *
+ *                                   Slots                                   *
+ *                                                                           *
+ ****************************************************************************/
+
+///Start a run, finished() is emitted once it is over
+bool Video::RendererBenchmark::start()
+{
+   static int count = 0;
+
+   if (isRunning() || d_ptr->m_Resolution.isEmpty())
+      return false;
+
+   const QString    path = QString("/ringclient-benchmark-%1-%2").arg(::getpid()).arg(++count);
+   const QByteArray id   = QString("benchmark:%1").arg(count).toLatin1();
+
+   d_ptr->m_CurrentSize = d_ptr->m_Resolution;
+   d_ptr->m_pProducer   = new Video::ShmProducer(path);
+
+   d_ptr->m_pProducer->setResolution     ( d_ptr->m_Resolution      );
+   d_ptr->m_pProducer->setFrameRate      ( d_ptr->m_FrameRate       );
+   d_ptr->m_pProducer->setProtocolVersion( d_ptr->m_ProtocolVersion );
+   d_ptr->m_pProducer->setNotification   ( d_ptr->m_Notification    );
+
+   if (!d_ptr->m_pProducer->open()) {
+      delete d_ptr->m_pProducer;
+      d_ptr->m_pProducer = nullptr;
+      return false;
+   }
+
+   d_ptr->m_pThread         = new QThread();
+   d_ptr->m_pRendererThread = new QThread();
+   d_ptr->m_pDriver         = new Video::RendererDriver(id, path, d_ptr);
+
+   d_ptr->m_pProducer->moveToThread(d_ptr->m_pThread        );
+   d_ptr->m_pDriver  ->moveToThread(d_ptr->m_pRendererThread);
+
+   d_ptr->m_pThread        ->start();
+   d_ptr->m_pRendererThread->start();
+
+   d_ptr->m_lLatencies.clear();
+   d_ptr->m_Result = Result{};
+
+   d_ptr->m_StartTime = RendererBenchmarkPrivate::now(CLOCK_MONOTONIC         );
+   d_ptr->m_StartCpu  = RendererBenchmarkPrivate::now(CLOCK_PROCESS_CPUTIME_ID);
+
+   bool started = false;
+
+   QMetaObject::invokeMethod(d_ptr->m_pDriver, "start", Qt::BlockingQueuedConnection,
+      Q_RETURN_ARG(bool, started), Q_ARG(QSize, d_ptr->m_Resolution)
+   );
+
+   if (!started) {
+      QMetaObject::invokeMethod(d_ptr->m_pDriver, "stop", Qt::BlockingQueuedConnection);
+      d_ptr->cleanup();
+      return false;
+   }
+
+   QMetaObject::invokeMethod(d_ptr->m_pProducer, "start", Qt::QueuedConnection);
+
+   d_ptr->m_pDurationTimer->start(d_ptr->m_Duration);
+
+   if (d_ptr->m_ResizeInterval > 0)
+      d_ptr->m_pResizeTimer->start(d_ptr->m_ResizeInterval);
+
+   return true;
+}
+
+///Stop the run and compute the result
+void Video::RendererBenchmark::stop()
+{
+   if (!isRunning())
+      return;
+
+   d_ptr->m_pDurationTimer->stop();
+   d_ptr->m_pResizeTimer->stop();
+
+   QMetaObject::invokeMethod(d_ptr->m_pProducer, "stop", Qt::BlockingQueuedConnection);
+   QMetaObject::invokeMethod(d_ptr->m_pDriver  , "stop", Qt::BlockingQueuedConnection);
+
+   const qint64 elapsed = RendererBenchmarkPrivate::now(CLOCK_MONOTONIC         ) - d_ptr->m_StartTime;
+   const qint64 cpu     = RendererBenchmarkPrivate::now(CLOCK_PROCESS_CPUTIME_ID) - d_ptr->m_StartCpu
+      - d_ptr->m_pProducer->cpuTime();
+
+   Result& r = d_ptr->m_Result;
+
+   const Video::Renderer::Statistics& s = d_ptr->m_pDriver->m_Statistics;
+   r.lockWaitTime  = s.lockWaitTime ;
+   r.droppedFrames = s.droppedFrames;
+   r.remapCount    = s.remapCount   ;
+   r.remapTime     = s.remapTime    ;
+   r.producedFrames = d_ptr->m_pProducer->frameGen();
+
+   // The renderer is gone, no more frames can reach the sink
+   QVector<qint64> latencies = d_ptr->m_lLatencies;
+
+   d_ptr->cleanup();
+
+   std::sort(latencies.begin(), latencies.end());
+
+   r.renderedFrames = latencies.size();
+   r.throughput     = elapsed ? r.renderedFrames * 1000000.0 / elapsed : 0;
+
+   if (!latencies.isEmpty()) {
+      qint64 total = 0;
+
+      for (const qint64 l : latencies)
+         total += l;
+
+      r.meanLatency = total / 1000.0 / latencies.size();
+      r.p99Latency  = latencies[(latencies.size() - 1) * 99 / 100] / 1000.0;
+      r.maxLatency  = latencies.last() / 1000.0;
+      r.cpuPerFrame = static_cast<double>(cpu) / latencies.size();
+   }
+
+   emit finished(r);
+}
+
+#include <rendererbenchmark.moc>
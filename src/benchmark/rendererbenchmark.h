@@ -0,0 +1,94 @@
+/****************************************************************************
+ *   Copyright (C) 2015 by Savoir-Faire Linux                               *
+ *   Author : Emmanuel Lepage Vallee <emmanuel.lepage@savoirfairelinux.com> *
+ *                                                                          *
+ *   This library is free software; you can redistribute it and/or          *
+ *   modify it under the terms of the GNU Lesser General Public             *
+ *   License as published by the Free Software Foundation; either           *
+ *   version 2.1 of the License, or (at your option) any later version.     *
+ *                                                                          *
+ *   This library is distributed in the hope that it will be useful,        *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU      *
+ *   Lesser General Public License for more details.                        *
+ *                                                                          *
+ *   You should have received a copy of the GNU General Public License      *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>.  *
+ ***************************************************************************/
+#ifndef VIDEO_RENDERERBENCHMARK_H
+#define VIDEO_RENDERERBENCHMARK_H
+
+//Qt
+#include <QtCore/QObject>
+#include <QtCore/QSize>
+
+namespace Video {
+
+class RendererBenchmarkPrivate;
+
+/**
+ * Measure the shared memory rendering path without a daemon.
+ *
+ * A local producer publish synthetic frames using the same shared memory
+ * protocol as the daemon. A ShmRenderer, owned by its own thread like the
+ * ones VideoRendererManager create, read them up to a sink, where the
+ * latency is measured. Neither the daemon signals nor the renderer manager
+ * are involved, so the client own renderers are left untouched.
+ */
+class RendererBenchmark : public QObject
+{
+   #pragma GCC diagnostic push
+   #pragma GCC diagnostic ignored "-Wzero-as-null-pointer-constant"
+   Q_OBJECT
+   #pragma GCC diagnostic pop
+
+public:
+   ///The outcome of a run
+   struct Result {
+      uint   producedFrames; /*!< Frames published by the producer                       */
+      uint   renderedFrames; /*!< Frames received by the sink                            */
+      double throughput    ; /*!< Rendered frames per second                             */
+      double meanLatency   ; /*!< From the publication to the sink, in ms                */
+      double p99Latency    ; /*!< 99th percentile of the latency, in ms                  */
+      double maxLatency    ; /*!< In ms                                                  */
+      double cpuPerFrame   ; /*!< Process CPU time per rendered frame, producer excluded, in µs */
+      qint64 lockWaitTime  ; /*!< Time the renderer waited for the producer lock, in µs  */
+      uint   droppedFrames ; /*!< See Video::Renderer::Statistics                        */
+      uint   remapCount    ;
+      qint64 remapTime     ; /*!< In µs                                                  */
+   };
+
+   //Constructor
+   explicit RendererBenchmark(QObject* parent = nullptr);
+   virtual ~RendererBenchmark();
+
+   //Getters
+   bool   isRunning() const;
+   Result result   () const;
+
+   //Setters
+   void setResolution     ( const QSize& size );
+   void setFrameRate      ( int fps           );
+   void setDuration       ( int ms            );
+   void setResizeInterval ( int ms            );
+   void setProtocolVersion( uint version      );
+   void setNotification   ( bool enabled      );
+
+private:
+   RendererBenchmarkPrivate* d_ptr;
+   Q_DECLARE_PRIVATE(RendererBenchmark)
+
+public Q_SLOTS:
+   bool start();
+   void stop ();
+
+Q_SIGNALS:
+   ///The run is over, either because the duration elapsed or stop() was called
+   void finished(const Video::RendererBenchmark::Result& result);
+};
+
+}
+
+Q_DECLARE_METATYPE(Video::RendererBenchmark::Result)
+
+#endif
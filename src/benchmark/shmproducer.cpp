@@ -0,0 +1,383 @@
+/****************************************************************************
+ *   Copyright (C) 2015 by Savoir-Faire Linux                               *
+ *   Author : Emmanuel Lepage Vallee <emmanuel.lepage@savoirfairelinux.com> *
+ *                                                                          *
+ *   This library is free software; you can redistribute it and/or          *
+ *   modify it under the terms of the GNU Lesser General Public             *
+ *   License as published by the Free Software Foundation; either           *
+ *   version 2.1 of the License, or (at your option) any later version.     *
+ *                                                                          *
+ *   This library is distributed in the hope that it will be useful,        *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU      *
+ *   Lesser General Public License for more details.                        *
+ *                                                                          *
+ *   You should have received a copy of the GNU General Public License      *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>.  *
+ ***************************************************************************/
+#include "shmproducer.h"
+
+//Qt
+#include <QtCore/QDebug>
+#include <QtCore/QTimer>
+
+//System
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <errno.h>
+#include <time.h>
+
+//libstdc++
+#include <cstring>
+#include <new>
+#include <utility>
+
+//Ring
+#include "private/shmheader.h"
+
+///Monotonic time, in µs
+static qint64 nowUs()
+{
+   timespec t;
+   ::clock_gettime(CLOCK_MONOTONIC, &t);
+   return static_cast<qint64>(t.tv_sec) * 1000000 + t.tv_nsec / 1000;
+}
+
+///CPU time of the calling thread, in µs
+static qint64 threadCpuUs()
+{
+   timespec t;
+   ::clock_gettime(CLOCK_THREAD_CPUTIME_ID, &t);
+   return static_cast<qint64>(t.tv_sec) * 1000000 + t.tv_nsec / 1000;
+}
+
+Video::ShmProducer::ShmProducer(const QString& path, QObject* parent) : QObject(parent),
+m_Path(path), m_fd(-1), m_NotifyFd(-1), m_pShmArea((SHMHeader*)MAP_FAILED), m_ShmAreaLen(0),
+m_DataOffset(0), m_ProtocolVersion(SHM_PROTOCOL_VERSION), m_Notification(true), m_FrameRate(30),
+m_Resolution(640, 480), m_PendingSize(640, 480), m_FrameGen(0), m_CpuTime(0), m_pTimer(nullptr)
+{
+   for (std::atomic<qint64>& t : m_lPublishTime)
+      t = 0;
+}
+
+Video::ShmProducer::~ShmProducer()
+{
+   close();
+}
+
+/*****************************************************************************
+ *                                                                           *
+ *                                 Getters                                   *
+ *                                                                           *
+ ****************************************************************************/
+
+///The shared memory name, as sent by the daemon with startedDecoding
+const QString& Video::ShmProducer::path() const
+{
+   return m_Path;
+}
+
+QSize Video::ShmProducer::resolution() const
+{
+   return m_Resolution;
+}
+
+///The generation of the last published frame
+uint Video::ShmProducer::frameGen() const
+{
+   return m_FrameGen;
+}
+
+///When a recent frame was published, in µs on the monotonic clock, 0 if unknown
+qint64 Video::ShmProducer::publishTime(uint frameGen) const
+{
+   return m_lPublishTime[frameGen % PUBLISH_HISTORY];
+}
+
+///CPU time spent producing the frames, in µs
+qint64 Video::ShmProducer::cpuTime() const
+{
+   return m_CpuTime;
+}
+
+/*****************************************************************************
+ *                                                                           *
+ *                                 Setters                                   *
+ *                                                                           *
+ ****************************************************************************/
+
+///Resize the frames, this take effect with the next published frame
+void Video::ShmProducer::setResolution(const QSize& size)
+{
+   if (!size.isEmpty())
+      m_PendingSize = size;
+}
+
+void Video::ShmProducer::setFrameRate(int fps)
+{
+   m_FrameRate = fps > 0 ? fps : 1;
+
+   if (m_pTimer)
+      m_pTimer->setInterval(1000 / m_FrameRate);
+}
+
+///The protocol version to advertise, must be set before open()
+void Video::ShmProducer::setProtocolVersion(uint version)
+{
+   m_ProtocolVersion = version;
+}
+
+///Create a notification FIFO, must be set before open()
+void Video::ShmProducer::setNotification(bool enabled)
+{
+   m_Notification = enabled;
+}
+
+/*****************************************************************************
+ *                                                                           *
+ *                                 Mutators                                  *
+ *                                                                           *
+ ****************************************************************************/
+
+///Create the shared memory and publish the header
+bool Video::ShmProducer::open()
+{
+   if (m_fd != -1)
+      return true;
+
+   m_fd = ::shm_open(m_Path.toLatin1(), O_RDWR | O_CREAT | O_EXCL, S_IRUSR | S_IWUSR);
+
+   if (m_fd < 0) {
+      qWarning() << "Could not create shm area" << m_Path << ":" << strerror(errno);
+      return false;
+   }
+
+   m_DataOffset = m_ProtocolVersion >= 2 ? sizeof(SHMHeaderExt) : 0;
+   m_ShmAreaLen = sizeof(SHMHeader) + m_DataOffset;
+
+   if (::ftruncate(m_fd, m_ShmAreaLen)) {
+      qWarning() << "Could not size shm area:" << strerror(errno);
+      close();
+      return false;
+   }
+
+   m_pShmArea = (SHMHeader*) ::mmap(nullptr, m_ShmAreaLen, PROT_READ | PROT_WRITE, MAP_SHARED, m_fd, 0);
+
+   if (m_pShmArea == MAP_FAILED) {
+      qWarning() << "Could not map shm area:" << strerror(errno);
+      close();
+      return false;
+   }
+
+   ::sem_init(&m_pShmArea->mutex        , 1, 1);
+   ::sem_init(&m_pShmArea->frameGenMutex, 1, 0);
+
+   m_pShmArea->frameGen    = 0;
+   m_pShmArea->frameSize   = 0;
+   m_pShmArea->mapSize     = m_ShmAreaLen;
+   m_pShmArea->readOffset  = 0;
+   m_pShmArea->writeOffset = 0;
+
+   if (m_ProtocolVersion >= 2) {
+      SHMHeaderExt* e  = new (m_pShmArea->data) SHMHeaderExt;
+      e->magic         = SHM_MAGIC;
+      e->version       = m_ProtocolVersion;
+      e->seq           = 0;
+      e->clientVersion = 0;
+   }
+
+   if (m_Notification) {
+      const QByteArray fifo = "/dev/shm" + m_Path.toLatin1() + SHM_NOTIFY_SUFFIX;
+
+      // Open it for reading too, so writing never block nor fail without a reader
+      if (::mkfifo(fifo, S_IRUSR | S_IWUSR) || (m_NotifyFd = ::open(fifo, O_RDWR | O_NONBLOCK | O_CLOEXEC)) < 0)
+         qWarning() << "Could not create the notification FIFO:" << strerror(errno);
+   }
+
+   if (!lock()) {
+      close();
+      return false;
+   }
+
+   beginUpdate();
+   const bool ret = resize(m_PendingSize);
+   endUpdate();
+
+   unlock();
+
+   if (!ret)
+      close();
+
+   return ret;
+}
+
+///Destroy the shared memory, the renderers may still have it mapped
+void Video::ShmProducer::close()
+{
+   stop();
+
+   if (m_NotifyFd >= 0) {
+      ::close(m_NotifyFd);
+      ::unlink("/dev/shm" + m_Path.toLatin1() + SHM_NOTIFY_SUFFIX);
+      m_NotifyFd = -1;
+   }
+
+   if (m_pShmArea != MAP_FAILED) {
+      ::munmap(m_pShmArea, m_ShmAreaLen);
+      m_pShmArea   = (SHMHeader*) MAP_FAILED;
+      m_ShmAreaLen = 0;
+   }
+
+   if (m_fd >= 0) {
+      ::close(m_fd);
+      ::shm_unlink(m_Path.toLatin1());
+      m_fd = -1;
+   }
+}
+
+bool Video::ShmProducer::lock()
+{
+   return ::sem_wait(&m_pShmArea->mutex) >= 0;
+}
+
+void Video::ShmProducer::unlock()
+{
+   ::sem_post(&m_pShmArea->mutex);
+}
+
+///Make the header sequence odd, for the version 2 readers
+void Video::ShmProducer::beginUpdate()
+{
+   if (m_DataOffset)
+      reinterpret_cast<SHMHeaderExt*>(m_pShmArea->data)->seq.fetch_add(1, std::memory_order_acq_rel);
+}
+
+///Make the header sequence even again
+void Video::ShmProducer::endUpdate()
+{
+   if (m_DataOffset)
+      reinterpret_cast<SHMHeaderExt*>(m_pShmArea->data)->seq.fetch_add(1, std::memory_order_release);
+}
+
+/**
+ * Resize the frame buffers, with the lock held.
+ *
+ * Like the daemon, the shared memory follow the frame size. The version 2
+ * of the protocol forbid shrinking it, the unused tail is kept instead.
+ */
+bool Video::ShmProducer::resize(const QSize& size)
+{
+   const uint   frameSize  = size.width() * size.height() * 4;
+   const uint   bufferSize = (frameSize + 15) & ~15u;
+   const size_t mapSize    = sizeof(SHMHeader) + m_DataOffset + 2 * bufferSize;
+
+   if (mapSize > m_ShmAreaLen || (m_ProtocolVersion < 2 && mapSize < m_ShmAreaLen)) {
+      if (::ftruncate(m_fd, mapSize)) {
+         qWarning() << "Could not resize shm area:" << strerror(errno);
+         return false;
+      }
+
+      void* area = ::mremap(m_pShmArea, m_ShmAreaLen, mapSize, MREMAP_MAYMOVE);
+
+      if (area == MAP_FAILED) {
+         qWarning() << "Could not remap shm area:" << strerror(errno);
+         return false;
+      }
+
+      m_pShmArea   = static_cast<SHMHeader*>(area);
+      m_ShmAreaLen = mapSize;
+   }
+
+   m_pShmArea->frameSize   = frameSize;
+   m_pShmArea->mapSize     = m_ShmAreaLen;
+   m_pShmArea->readOffset  = 0;
+   m_pShmArea->writeOffset = bufferSize;
+
+   m_Resolution = size;
+
+   return true;
+}
+
+/*****************************************************************************
+ *                                                                           *
+ *                                   Slots                                   *
+ *                                                                           *
+ ****************************************************************************/
+
+///Publish frames at the frame rate, until stop()
+void Video::ShmProducer::start()
+{
+   if (!m_pTimer) {
+      m_pTimer = new QTimer(this);
+      m_pTimer->setTimerType(Qt::PreciseTimer);
+      connect(m_pTimer, &QTimer::timeout, this, &ShmProducer::publish);
+   }
+
+   m_pTimer->start(1000 / m_FrameRate);
+}
+
+void Video::ShmProducer::stop()
+{
+   if (m_pTimer)
+      m_pTimer->stop();
+}
+
+/**
+ * Draw and publish a new frame.
+ *
+ * The frame is drawn in the write buffer without the lock, then the buffers
+ * are swapped and the readers woken up, like the daemon sinks do.
+ */
+bool Video::ShmProducer::publish()
+{
+   if (m_pShmArea == MAP_FAILED)
+      return false;
+
+   const qint64 cpuStart = threadCpuUs();
+
+   if (m_PendingSize != m_Resolution) {
+      if (!lock())
+         return false;
+
+      beginUpdate();
+      const bool resized = resize(m_PendingSize);
+      endUpdate();
+
+      unlock();
+
+      if (!resized)
+         return false;
+   }
+
+   const uint gen = m_FrameGen + 1;
+
+   // A plain frame, its value change with each generation
+   ::memset(m_pShmArea->data + m_DataOffset + m_pShmArea->writeOffset, gen & 0xff, m_pShmArea->frameSize);
+
+   if (!lock())
+      return false;
+
+   beginUpdate();
+   std::swap(m_pShmArea->readOffset, m_pShmArea->writeOffset);
+   m_pShmArea->frameGen = gen;
+   endUpdate();
+
+   m_lPublishTime[gen % PUBLISH_HISTORY] = nowUs();
+   m_FrameGen = gen;
+
+   unlock();
+
+   ::sem_post(&m_pShmArea->frameGenMutex);
+
+   if (m_NotifyFd >= 0) {
+      const char c = 0;
+      if (::write(m_NotifyFd, &c, 1) < 0 && errno != EAGAIN)
+         qWarning() << "Could not notify the frame:" << strerror(errno);
+   }
+
+   m_CpuTime += threadCpuUs() - cpuStart;
+
+   return true;
+}
@@ -0,0 +1,112 @@
+/****************************************************************************
+ *   Copyright (C) 2015 by Savoir-Faire Linux                               *
+ *   Author : Emmanuel Lepage Vallee <emmanuel.lepage@savoirfairelinux.com> *
+ *                                                                          *
+ *   This library is free software; you can redistribute it and/or          *
+ *   modify it under the terms of the GNU Lesser General Public             *
+ *   License as published by the Free Software Foundation; either           *
+ *   version 2.1 of the License, or (at your option) any later version.     *
+ *                                                                          *
+ *   This library is distributed in the hope that it will be useful,        *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU      *
+ *   Lesser General Public License for more details.                        *
+ *                                                                          *
+ *   You should have received a copy of the GNU General Public License      *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>.  *
+ ***************************************************************************/
+#ifndef VIDEO_SHM_PRODUCER_H
+#define VIDEO_SHM_PRODUCER_H
+
+//Qt
+#include <QtCore/QObject>
+#include <QtCore/QSize>
+#include <QtCore/QString>
+
+//libstdc++
+#include <atomic>
+
+//Ring
+#include <typedefs.h>
+
+class QTimer;
+struct SHMHeader;
+
+namespace Video {
+
+/**
+ * A stand-in for the daemon side of the shared memory video protocol.
+ *
+ * It create the shared memory, publish synthetic double buffered frames at
+ * a fixed rate and resize them on demand, exactly like the daemon sinks.
+ * This allow the renderers to be exercised without a daemon.
+ *
+ * Once open(), the object should be moved to its own thread and driven
+ * with queued calls to its slots.
+ */
+class ShmProducer : public QObject
+{
+   #pragma GCC diagnostic push
+   #pragma GCC diagnostic ignored "-Wzero-as-null-pointer-constant"
+   Q_OBJECT
+   #pragma GCC diagnostic pop
+
+public:
+   //Constructor
+   explicit ShmProducer(const QString& path, QObject* parent = nullptr);
+   virtual ~ShmProducer();
+
+   //Getters
+   const QString& path          (                  ) const;
+   QSize          resolution    (                  ) const;
+   uint           frameGen      (                  ) const;
+   qint64         publishTime   ( uint frameGen    ) const;
+   qint64         cpuTime       (                  ) const;
+
+   //Setters
+   void setFrameRate      ( int fps           );
+   void setProtocolVersion( uint version      );
+   void setNotification   ( bool enabled      );
+
+   //Mutators
+   bool open ();
+   void close();
+
+private:
+   //Constants
+   constexpr static const int PUBLISH_HISTORY = 256;
+
+   //Attributes
+   QString             m_Path           ;
+   int                 m_fd             ;
+   int                 m_NotifyFd       ;
+   SHMHeader*          m_pShmArea       ;
+   size_t              m_ShmAreaLen     ;
+   size_t              m_DataOffset     ;
+   uint                m_ProtocolVersion;
+   bool                m_Notification   ;
+   int                 m_FrameRate      ;
+   QSize               m_Resolution     ;
+   QSize               m_PendingSize    ;
+   std::atomic_uint    m_FrameGen       ;
+   std::atomic<qint64> m_CpuTime        ; /*!< Producer thread CPU time, in µs         */
+   std::atomic<qint64> m_lPublishTime[PUBLISH_HISTORY]; /*!< In µs, by frame generation */
+   QTimer*             m_pTimer         ;
+
+   //Helpers
+   bool lock  ();
+   void unlock();
+   void beginUpdate();
+   void endUpdate  ();
+   bool resize     (const QSize& size);
+
+public Q_SLOTS:
+   void start        (                  );
+   void stop         (                  );
+   bool publish      (                  );
+   void setResolution( const QSize& size);
+};
+
+}
+
+#endif
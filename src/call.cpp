@@ -311,8 +311,13 @@ Call::~Call()
 Call* CallPrivate::buildExistingCall(const QString& callId)
 {
    CallManagerInterface& callManager = DBus::CallManager::instance();
-   MapStringString       details     = callManager.getCallDetails(callId);
 
+   return buildExistingCall(callId, callManager.getCallDetails(callId), callManager.getIsRecording(callId));
+}
+
+///Build a call already known by the daemon from prefetched details
+Call* CallPrivate::buildExistingCall(const QString& callId, const MapStringString& details, bool recording)
+{
    //Too noisy
    //qDebug() << "Constructing existing call with details : " << details;
 
@@ -320,11 +325,12 @@ Call* CallPrivate::buildExistingCall(const QString& callId)
    const QString peerName      = details[ CallPrivate::DetailsMapFields::PEER_NAME   ];
    const QString account       = details[ CallPrivate::DetailsMapFields::ACCOUNT_ID  ];
    Call::State   startState    = startStateFromDaemonCallState(details[CallPrivate::DetailsMapFields::STATE], details[CallPrivate::DetailsMapFields::TYPE]);
-   Account*      acc           = AccountModel::instance()->getById(account.toLatin1());
+   //The accounts may still be loading, a placeholder is upgraded once they are
+   Account*      acc           = account.isEmpty() ? nullptr : AccountModel::instance()->getById(account.toLatin1(), true);
    ContactMethod*  nb            = PhoneDirectoryModel::instance()->getNumber(peerNumber,acc);
    Call*         call          = new Call(startState, peerName, nb, acc);
    call->d_ptr->m_DringId      = callId;
-   call->d_ptr->m_Recording    = callManager.getIsRecording(callId);
+   call->d_ptr->m_Recording    = recording;
 
    if (!details[ CallPrivate::DetailsMapFields::TIMESTAMP_START ].isEmpty())
       call->d_ptr->setStartTimeStamp(details[ CallPrivate::DetailsMapFields::TIMESTAMP_START ].toInt());
@@ -376,7 +382,7 @@ Call* CallPrivate::buildIncomingCall(const QString& callId)
       return nullptr;
    }
 
-   Account*      acc           = AccountModel::instance()->getById(account.toLatin1());
+   Account*      acc           = AccountModel::instance()->getById(account.toLatin1(), true);
    ContactMethod*  nb          = PhoneDirectoryModel::instance()->getNumber(from,acc);
    Call* call                  = new Call(Call::State::INCOMING, peerName, nb, acc);
    call->d_ptr->m_DringId      = callId;
@@ -409,7 +415,7 @@ Call* CallPrivate::buildRingingCall(const QString & callId)
       return nullptr;
    }
 
-   Account*      acc           = AccountModel::instance()->getById(account.toLatin1());
+   Account*      acc           = AccountModel::instance()->getById(account.toLatin1(), true);
    ContactMethod*  nb          = PhoneDirectoryModel::instance()->getNumber(from,acc);
    Call* call                  = new Call(Call::State::RINGING, peerName, nb, acc);
    call->d_ptr->m_DringId      = callId;
@@ -462,7 +468,7 @@ Call* Call::buildHistoryCall(const QMap<QString,QString>& hc)
    if (!hc[ Call::HistoryMapFields::CONTACT_UID].isEmpty())
       ct = PersonModel::instance()->getPlaceHolder(contactUid.toLatin1());
 
-   Account*        acc            = AccountModel::instance()->getById(accId);
+   Account*        acc            = AccountModel::instance()->getById(accId, true);
    ContactMethod*  nb             = PhoneDirectoryModel::instance()->getNumber(number,ct,acc);
 
    Call*           call           = new Call(Call::State::OVER, (name == "empty")?QString():name, nb, acc );
@@ -471,7 +477,7 @@ Call* Call::buildHistoryCall(const QMap<QString,QString>& hc)
    call->d_ptr->m_pStopTimeStamp  = stopTimeStamp ;
    call->d_ptr->setStartTimeStamp(startTimeStamp);
    call->d_ptr->m_History         = true;
-   call->d_ptr->m_Account         = AccountModel::instance()->getById(accId);
+   call->d_ptr->m_Account         = acc;
 
    if (missed) {
       call->d_ptr->m_Missed = true;
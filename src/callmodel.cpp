@@ -22,6 +22,7 @@
 #include <QtCore/QCoreApplication>
 #include <QtCore/QMimeData>
 #include <QtCore/QItemSelectionModel>
+#include <QtCore/QSharedPointer>
 
 //Ring library
 #include "call.h"
@@ -34,6 +35,7 @@
 #include "dbus/callmanager.h"
 #include "dbus/configurationmanager.h"
 #include "dbus/instancemanager.h"
+#include "dbus/asyncquery.h"
 #include "private/videorenderermanager.h"
 #include "mime.h"
 #include "typedefs.h"
@@ -73,23 +75,37 @@ public:
       void init();
       Call* addCall2         ( Call* call                , Call* parent = nullptr );
       Call* addConference    ( const QString& confID                              );
+      Call* addConference    ( const QString& confID, const QStringList& callList );
       void  removeConference ( const QString& confId                              );
       void  removeCall       ( Call* call       , bool noEmit = false             );
       Call* addIncomingCall  ( const QString& callId                              );
       Call* addRingingCall   ( const QString& callId                              );
 
+      ///The replies of the startup queries, joined before building the tree
+      struct Bootstrap {
+         QStringList                    callList    ;
+         QStringList                    confList    ;
+         QHash<QString,MapStringString> details     ;
+         QHash<QString,bool           > recording   ;
+         QHash<QString,QStringList    > participants;
+         int                            pending     ; /*!< Queries not answered yet */
+      };
+
       //Attributes
       QList<InternalStruct*> m_lInternalModel;
       QHash< Call*       , InternalStruct* > m_shInternalMapping ;
       QHash< QString     , InternalStruct* > m_shDringId         ;
       QItemSelectionModel* m_pSelectionModel;
       UserActionModel*     m_pUserActionModel;
+      bool                 m_Bootstrapping   ; /*!< Inside the initial reset, no row signals */
+      QList<Call*>         m_lBootstrapCalls ; /*!< callAdded to emit once the reset is over */
 
 
       //Helpers
       bool isPartOf(const QModelIndex& confIdx, Call* call);
       void removeConference       ( Call* conf                    );
       void removeInternal(InternalStruct* internal);
+      void bootstrap(const Bootstrap& b);
 
    private:
       CallModel* q_ptr;
@@ -125,7 +141,7 @@ CallModel* CallModel::instance() {
 }
 
 CallModelPrivate::CallModelPrivate(CallModel* parent) : QObject(parent),q_ptr(parent),m_pSelectionModel(nullptr),
-m_pUserActionModel(nullptr)
+m_pUserActionModel(nullptr),m_Bootstrapping(false)
 {
 
 }
@@ -175,16 +191,69 @@ void CallModelPrivate::init()
 
    CallManagerInterface& callManager = DBus::CallManager::instance();
    const QStringList callList = callManager.getCallList();
-   foreach (const QString& callId, callList) {
-      Call* tmpCall = CallPrivate::buildExistingCall(callId);
+   const QStringList confList = callManager.getConferenceList();
+
+   //Send all the queries at once, the tree is built when the last reply arrive
+   QSharedPointer<Bootstrap> b { new Bootstrap { callList, confList, {}, {}, {}, 3 } };
+
+   DBus::AsyncQuery::callDetails(callList, this, [this, b](const QHash<QString,MapStringString>& details) {
+      b->details = details;
+      if (!--b->pending)
+         bootstrap(*b);
+   });
+
+   DBus::AsyncQuery::isRecording(callList, this, [this, b](const QHash<QString,bool>& recording) {
+      b->recording = recording;
+      if (!--b->pending)
+         bootstrap(*b);
+   });
+
+   DBus::AsyncQuery::participantLists(confList, this, [this, b](const QHash<QString,QStringList>& participants) {
+      b->participants = participants;
+      if (!--b->pending)
+         bootstrap(*b);
+   });
+}
+
+/**
+ * Build the whole tree at once, the views only have to reload it once.
+ *
+ * The calls and conferences signaled by the daemon while the queries were
+ * pending are already in the model and are skipped, so are the calls whose
+ * details could not be retrieved.
+ */
+void CallModelPrivate::bootstrap(const Bootstrap& b)
+{
+   QList<Call*> conferences;
+
+   q_ptr->beginResetModel();
+   m_Bootstrapping = true;
+
+   foreach (const QString& callId, b.callList) {
+      if (m_shDringId.value(callId) || !b.details.contains(callId))
+         continue;
+
+      Call* tmpCall = CallPrivate::buildExistingCall(callId, b.details[callId], b.recording.value(callId, false));
       addCall2(tmpCall);
    }
 
-   const QStringList confList = callManager.getConferenceList();
-   foreach (const QString& confId, confList) {
-      Call* conf = addConference(confId);
-      emit q_ptr->conferenceCreated(conf);
+   foreach (const QString& confId, b.confList) {
+      if (m_shDringId.value(confId) || !b.participants.contains(confId))
+         continue;
+
+      if (Call* conf = addConference(confId, b.participants[confId]))
+         conferences << conf;
    }
+
+   m_Bootstrapping = false;
+   q_ptr->endResetModel();
+
+   foreach (Call* call, m_lBootstrapCalls)
+      emit q_ptr->callAdded(call, nullptr);
+   m_lBootstrapCalls.clear();
+
+   foreach (Call* conf, conferences)
+      emit q_ptr->conferenceCreated(conf);
 }
 
 ///Destructor
@@ -393,9 +462,13 @@ Call* CallModelPrivate::addCall2(Call* call, Call* parentCall)
 
    m_shInternalMapping  [ call       ] = aNewStruct;
    if (call->lifeCycleState() != Call::LifeCycleState::FINISHED) {
-      q_ptr->beginInsertRows(QModelIndex(),m_lInternalModel.size(),m_lInternalModel.size());
-      m_lInternalModel << aNewStruct;
-      q_ptr->endInsertRows();
+      if (m_Bootstrapping)
+         m_lInternalModel << aNewStruct;
+      else {
+         q_ptr->beginInsertRows(QModelIndex(),m_lInternalModel.size(),m_lInternalModel.size());
+         m_lInternalModel << aNewStruct;
+         q_ptr->endInsertRows();
+      }
    }
 
    //Dialing calls don't have remote yet, it will be added later
@@ -404,16 +477,21 @@ Call* CallModelPrivate::addCall2(Call* call, Call* parentCall)
 
    //If the call is already finished, there is no point to track it here
    if (call->lifeCycleState() != Call::LifeCycleState::FINISHED) {
-      emit q_ptr->callAdded(call,parentCall);
-      const QModelIndex idx = q_ptr->index(m_lInternalModel.size()-1,0,QModelIndex());
-      emit q_ptr->dataChanged(idx, idx);
+      if (m_Bootstrapping)
+         m_lBootstrapCalls << call;
+      else {
+         emit q_ptr->callAdded(call,parentCall);
+         const QModelIndex idx = q_ptr->index(m_lInternalModel.size()-1,0,QModelIndex());
+         emit q_ptr->dataChanged(idx, idx);
+      }
       connect(call,SIGNAL(changed(Call*)),this,SLOT(slotCallChanged(Call*)));
       connect(call,&Call::stateChanged,this,&CallModelPrivate::slotStateChanged);
       connect(call,SIGNAL(dtmfPlayed(QString)),this,SLOT(slotDTMFPlayed(QString)));
       connect(call,&Call::videoStarted,[this,call](Video::Renderer* r){
          emit q_ptr->rendererAdded(call, r);
       });
-      emit q_ptr->layoutChanged();
+      if (!m_Bootstrapping)
+         emit q_ptr->layoutChanged();
    }
    return call;
 } //addCall
@@ -476,6 +554,12 @@ void CallModelPrivate::removeInternal(InternalStruct* internal)
       return;
    }
 
+   //The initial reset is still in progress, the views know nothing yet
+   if (m_Bootstrapping) {
+      m_lInternalModel.removeAt(idx);
+      return;
+   }
+
    //Using layoutChanged would SEGFAULT when an editor is open
    q_ptr->beginRemoveRows(QModelIndex(),idx,idx);
    m_lInternalModel.removeAt(idx);
@@ -583,9 +667,15 @@ void CallModel::transfer(Call* toTransfer, const ContactMethod* target)
 ///Add a new conference, get the call list and update the interface as needed
 Call* CallModelPrivate::addConference(const QString& confID)
 {
-   qDebug() << "Notified of a new conference " << confID;
    CallManagerInterface& callManager = DBus::CallManager::instance();
-   const QStringList callList = callManager.getParticipantList(confID);
+
+   return addConference(confID, callManager.getParticipantList(confID));
+}
+
+///Add a new conference from its already known participants
+Call* CallModelPrivate::addConference(const QString& confID, const QStringList& callList)
+{
+   qDebug() << "Notified of a new conference " << confID;
    qDebug() << "Paticiapants are:" << callList;
 
    if (!callList.size()) {
@@ -609,9 +699,13 @@ Call* CallModelPrivate::addConference(const QString& confID)
 
       m_shInternalMapping[newConf]  = aNewStruct;
       m_shDringId[confID] = aNewStruct;
-      q_ptr->beginInsertRows(QModelIndex(),m_lInternalModel.size(),m_lInternalModel.size());
-      m_lInternalModel << aNewStruct;
-      q_ptr->endInsertRows();
+      if (m_Bootstrapping)
+         m_lInternalModel << aNewStruct;
+      else {
+         q_ptr->beginInsertRows(QModelIndex(),m_lInternalModel.size(),m_lInternalModel.size());
+         m_lInternalModel << aNewStruct;
+         q_ptr->endInsertRows();
+      }
 
       foreach(const QString& callId,callList) {
          InternalStruct* callInt = m_shDringId[callId];
@@ -628,9 +722,11 @@ Call* CallModelPrivate::addConference(const QString& confID)
             qDebug() << "References to unknown call";
          }
       }
-      const QModelIndex idx = q_ptr->index(m_lInternalModel.size()-1,0,QModelIndex());
-      emit q_ptr->dataChanged(idx, idx);
-      emit q_ptr->layoutChanged();
+      if (!m_Bootstrapping) {
+         const QModelIndex idx = q_ptr->index(m_lInternalModel.size()-1,0,QModelIndex());
+         emit q_ptr->dataChanged(idx, idx);
+         emit q_ptr->layoutChanged();
+      }
       connect(newConf,SIGNAL(changed(Call*)),this,SLOT(slotCallChanged(Call*)));
    }
 
@@ -0,0 +1,453 @@
+/****************************************************************************
+ *   Copyright (C) 2015 by Savoir-Faire Linux                               *
+ *   Author : Emmanuel Lepage Vallee <emmanuel.lepage@savoirfairelinux.com> *
+ *                                                                          *
+ *   This library is free software; you can redistribute it and/or          *
+ *   modify it under the terms of the GNU Lesser General Public             *
+ *   License as published by the Free Software Foundation; either           *
+ *   version 2.1 of the License, or (at your option) any later version.     *
+ *                                                                          *
+ *   This library is distributed in the hope that it will be useful,        *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU      *
+ *   Lesser General Public License for more details.                        *
+ *                                                                          *
+ *   You should have received a copy of the GNU General Public License      *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>.  *
+ ***************************************************************************/
+#include "asyncquery.h"
+
+//Qt
+#include <QtCore/QCoreApplication>
+#include <QtCore/QDebug>
+#include <QtCore/QObject>
+#include <QtCore/QPointer>
+#include <QtCore/QSharedPointer>
+#include <QtCore/QThread>
+#ifdef ENABLE_LIBWRAP
+ #include <QtCore/QMutex>
+ #include <QtCore/QQueue>
+#else
+ #include <QtDBus/QDBusPendingCallWatcher>
+#endif
+
+//Ring
+#include "configurationmanager.h"
+#include "callmanager.h"
+#include "videomanager.h"
+#include "ipctrace.h"
+
+namespace DBus {
+
+///Hold a query callback until the reply is available
+class AsyncReply : public QObject
+{
+   Q_OBJECT
+public:
+   explicit AsyncReply(QObject* context);
+
+   //Attributes
+   QPointer<QObject>     m_pContext;
+   std::function<void()> m_Deliver ; /*!< Invoke the callback with the result */
+#ifndef ENABLE_LIBWRAP
+   std::function<quint64(QDBusPendingCallWatcher*)> m_Read; /*!< Store the reply, return its size */
+   const char*           m_pName   ; /*!< The method, for DBus::IpcTrace       */
+   qint64                m_Sent    ;
+#endif
+
+public Q_SLOTS:
+   void deliver();
+#ifndef ENABLE_LIBWRAP
+   void slotFinished(QDBusPendingCallWatcher* watcher);
+#endif
+};
+
+#ifdef ENABLE_LIBWRAP
+///Run the native queries in order, away from the caller thread
+class AsyncQueryWorker : public QObject
+{
+   Q_OBJECT
+public:
+   static AsyncQueryWorker* instance();
+
+   void post(const std::function<void()>& job);
+
+private:
+   explicit AsyncQueryWorker();
+
+   //Attributes
+   QThread*                      m_pThread  ;
+   QMutex                        m_Mutex    ;
+   QQueue<std::function<void()>> m_lJobs    ;
+   bool                          m_Scheduled; /*!< A process() is already queued */
+
+private Q_SLOTS:
+   void process();
+};
+#endif
+
+}
+
+DBus::AsyncReply::AsyncReply(QObject* context) :
+QObject(nullptr), m_pContext(context)
+#ifndef ENABLE_LIBWRAP
+, m_pName(nullptr), m_Sent(0)
+#endif
+{
+   // The reply is delivered in the context thread
+   if (context && context->thread() != thread())
+      moveToThread(context->thread());
+}
+
+///Invoke the callback, unless the context is gone
+void DBus::AsyncReply::deliver()
+{
+   if (m_pContext && m_Deliver)
+      m_Deliver();
+
+   deleteLater();
+}
+
+#ifdef ENABLE_LIBWRAP
+
+DBus::AsyncQueryWorker::AsyncQueryWorker() : QObject(nullptr), m_pThread(new QThread()),
+m_Scheduled(false)
+{
+   m_pThread->setObjectName("AsyncQueryWorker");
+   moveToThread(m_pThread);
+   m_pThread->start();
+
+   if (QCoreApplication::instance()) {
+      QObject::connect(QCoreApplication::instance(), &QCoreApplication::aboutToQuit, m_pThread, [this]() {
+         m_pThread->quit();
+         m_pThread->wait();
+      }, Qt::DirectConnection);
+   }
+}
+
+DBus::AsyncQueryWorker* DBus::AsyncQueryWorker::instance()
+{
+   static AsyncQueryWorker* w = new AsyncQueryWorker();
+   return w;
+}
+
+void DBus::AsyncQueryWorker::post(const std::function<void()>& job)
+{
+   QMutexLocker lk {&m_Mutex};
+
+   m_lJobs.enqueue(job);
+
+   if (!m_Scheduled) {
+      m_Scheduled = true;
+      QMetaObject::invokeMethod(this, "process", Qt::QueuedConnection);
+   }
+}
+
+///Run all the pending jobs, the mutex is not held while they run
+void DBus::AsyncQueryWorker::process()
+{
+   forever {
+      std::function<void()> job;
+
+      {
+         QMutexLocker lk {&m_Mutex};
+
+         if (m_lJobs.isEmpty()) {
+            m_Scheduled = false;
+            return;
+         }
+
+         job = m_lJobs.dequeue();
+      }
+
+      job();
+   }
+}
+
+/**
+ * Run a query on the worker and deliver the result to the context thread.
+ *
+ * The interfaces are lazily created QObjects, they are fetched by the
+ * callers so the worker is never the one creating them, with its own
+ * thread affinity.
+ */
+template<typename T>
+static void query(const std::function<T()>& q, QObject* context, const std::function<void(const T&, bool)>& callback)
+{
+   DBus::AsyncReply* r      = new DBus::AsyncReply(context);
+   QSharedPointer<T> result { new T() };
+
+   // The native calls can't fail
+   r->m_Deliver = [callback, result]() { callback(*result, true); };
+
+   DBus::AsyncQueryWorker::instance()->post([q, r, result]() {
+      *result = q();
+      QMetaObject::invokeMethod(r, "deliver", Qt::QueuedConnection);
+   });
+}
+
+void DBus::AsyncQuery::getAccountDetails(const QString& accountId, QObject* context, const DetailsCallback& callback)
+{
+   ConfigurationManagerInterface& configurationManager = DBus::ConfigurationManager::instance();
+
+   query<MapStringString>([&configurationManager, accountId]() {
+      return configurationManager.getAccountDetails(accountId);
+   }, context, callback);
+}
+
+void DBus::AsyncQuery::getVolatileAccountDetails(const QString& accountId, QObject* context, const DetailsCallback& callback)
+{
+   ConfigurationManagerInterface& configurationManager = DBus::ConfigurationManager::instance();
+
+   query<MapStringString>([&configurationManager, accountId]() {
+      return configurationManager.getVolatileAccountDetails(accountId);
+   }, context, callback);
+}
+
+void DBus::AsyncQuery::getCertificateDetails(const QString& path, QObject* context, const DetailsCallback& callback)
+{
+   ConfigurationManagerInterface& configurationManager = DBus::ConfigurationManager::instance();
+
+   query<MapStringString>([&configurationManager, path]() {
+      return configurationManager.getCertificateDetails(path);
+   }, context, callback);
+}
+
+void DBus::AsyncQuery::getCallDetails(const QString& callId, QObject* context, const DetailsCallback& callback)
+{
+   CallManagerInterface& callManager = DBus::CallManager::instance();
+
+   query<MapStringString>([&callManager, callId]() {
+      return callManager.getCallDetails(callId);
+   }, context, callback);
+}
+
+void DBus::AsyncQuery::getConferenceDetails(const QString& confId, QObject* context, const DetailsCallback& callback)
+{
+   CallManagerInterface& callManager = DBus::CallManager::instance();
+
+   query<MapStringString>([&callManager, confId]() {
+      return callManager.getConferenceDetails(confId);
+   }, context, callback);
+}
+
+void DBus::AsyncQuery::getCapabilities(const QString& deviceId, QObject* context, const CapabilitiesCallback& callback)
+{
+   VideoManagerInterface& videoManager = DBus::VideoManager::instance();
+
+   query<MapStringMapStringVectorString>([&videoManager, deviceId]() {
+      return videoManager.getCapabilities(deviceId);
+   }, context, callback);
+}
+
+static void getIsRecording(const QString& callId, QObject* context, const std::function<void(const bool&, bool)>& callback)
+{
+   CallManagerInterface& callManager = DBus::CallManager::instance();
+
+   query<bool>([&callManager, callId]() {
+      return callManager.getIsRecording(callId);
+   }, context, callback);
+}
+
+static void getParticipantList(const QString& confId, QObject* context, const std::function<void(const QStringList&, bool)>& callback)
+{
+   CallManagerInterface& callManager = DBus::CallManager::instance();
+
+   query<QStringList>([&callManager, confId]() {
+      return callManager.getParticipantList(confId);
+   }, context, callback);
+}
+
+#else
+
+///The bytes received, there is no conversion to count them with DBus
+static quint64 payloadSize(const MapStringString& m)
+{
+   quint64 ret = 0;
+
+   for (auto i = m.constBegin(); i != m.constEnd(); ++i)
+      ret += i.key().size() + i.value().size();
+
+   return ret;
+}
+
+static quint64 payloadSize(const QStringList& l)
+{
+   quint64 ret = 0;
+
+   foreach(const QString& s, l)
+      ret += s.size();
+
+   return ret;
+}
+
+static quint64 payloadSize(bool)
+{
+   return sizeof(bool);
+}
+
+static quint64 payloadSize(const MapStringMapStringVectorString& m)
+{
+   quint64 ret = 0;
+
+   for (auto i = m.constBegin(); i != m.constEnd(); ++i) {
+      ret += i.key().size();
+
+      for (auto j = i.value().constBegin(); j != i.value().constEnd(); ++j) {
+         ret += j.key().size();
+
+         foreach(const QString& s, j.value())
+            ret += s.size();
+      }
+   }
+
+   return ret;
+}
+
+void DBus::AsyncReply::slotFinished(QDBusPendingCallWatcher* watcher)
+{
+   const quint64 size = m_Read(watcher);
+
+   DBus::IpcTrace::record(DBus::IpcTrace::Kind::METHOD, m_pName, m_Sent, DBus::IpcTrace::now(), 0, size);
+
+   watcher->deleteLater();
+   deliver();
+}
+
+///Watch a pending DBus call and deliver the result to the context thread
+template<typename T>
+static void query(const QDBusPendingCall& call, const char* name, QObject* context, const std::function<void(const T&, bool)>& callback)
+{
+   DBus::AsyncReply* r      = new DBus::AsyncReply(context);
+   QSharedPointer<T> result { new T() };
+   QSharedPointer<bool> ok  { new bool(false) };
+
+   r->m_pName = name;
+   r->m_Sent  = DBus::IpcTrace::now();
+
+   r->m_Deliver = [callback, result, ok]() { callback(*result, *ok); };
+
+   r->m_Read = [result, ok](QDBusPendingCallWatcher* watcher) -> quint64 {
+      const QDBusPendingReply<T> reply = *watcher;
+
+      if (reply.isError()) {
+         qWarning() << "Asynchronous query failed" << reply.error().message();
+         return 0;
+      }
+
+      *result = reply.value();
+      *ok     = true;
+      return payloadSize(*result);
+   };
+
+   QDBusPendingCallWatcher* w = new QDBusPendingCallWatcher(call, r);
+
+   QObject::connect(w, &QDBusPendingCallWatcher::finished, r, &DBus::AsyncReply::slotFinished);
+}
+
+void DBus::AsyncQuery::getAccountDetails(const QString& accountId, QObject* context, const DetailsCallback& callback)
+{
+   query<MapStringString>(DBus::ConfigurationManager::instance().getAccountDetails(accountId), "getAccountDetails", context, callback);
+}
+
+void DBus::AsyncQuery::getVolatileAccountDetails(const QString& accountId, QObject* context, const DetailsCallback& callback)
+{
+   query<MapStringString>(DBus::ConfigurationManager::instance().getVolatileAccountDetails(accountId), "getVolatileAccountDetails", context, callback);
+}
+
+void DBus::AsyncQuery::getCertificateDetails(const QString& path, QObject* context, const DetailsCallback& callback)
+{
+   query<MapStringString>(DBus::ConfigurationManager::instance().getCertificateDetails(path), "getCertificateDetails", context, callback);
+}
+
+void DBus::AsyncQuery::getCallDetails(const QString& callId, QObject* context, const DetailsCallback& callback)
+{
+   query<MapStringString>(DBus::CallManager::instance().getCallDetails(callId), "getCallDetails", context, callback);
+}
+
+void DBus::AsyncQuery::getConferenceDetails(const QString& confId, QObject* context, const DetailsCallback& callback)
+{
+   query<MapStringString>(DBus::CallManager::instance().getConferenceDetails(confId), "getConferenceDetails", context, callback);
+}
+
+void DBus::AsyncQuery::getCapabilities(const QString& deviceId, QObject* context, const CapabilitiesCallback& callback)
+{
+   query<MapStringMapStringVectorString>(DBus::VideoManager::instance().getCapabilities(deviceId), "getCapabilities", context, callback);
+}
+
+static void getIsRecording(const QString& callId, QObject* context, const std::function<void(const bool&, bool)>& callback)
+{
+   query<bool>(DBus::CallManager::instance().getIsRecording(callId), "getIsRecording", context, callback);
+}
+
+static void getParticipantList(const QString& confId, QObject* context, const std::function<void(const QStringList&, bool)>& callback)
+{
+   query<QStringList>(DBus::CallManager::instance().getParticipantList(confId), "getParticipantList", context, callback);
+}
+
+#endif
+
+/**
+ * Send one query per id and invoke the callback once they all replied.
+ *
+ * The individual replies are delivered in the context thread, one at a
+ * time, so the state is never shared between threads.
+ */
+template<typename T>
+static void batch(const QStringList& ids, QObject* context, const DBus::AsyncQuery::BatchCallback<T>& callback,
+                  void (*send)(const QString&, QObject*, const std::function<void(const T&, bool)>&))
+{
+   struct State {
+      QHash<QString,T> replies;
+      int              pending;
+   };
+
+   QSharedPointer<State> state { new State { QHash<QString,T>(), ids.size() } };
+
+   // Nothing to wait for, still deliver from the event loop like the others
+   if (ids.isEmpty()) {
+      DBus::AsyncReply* r = new DBus::AsyncReply(context);
+      r->m_Deliver = [callback, state]() { callback(state->replies); };
+      QMetaObject::invokeMethod(r, "deliver", Qt::QueuedConnection);
+      return;
+   }
+
+   state->replies.reserve(ids.size());
+
+   foreach(const QString& id, ids) {
+      send(id, context, [callback, state, id](const T& value, bool ok) {
+         if (ok)
+            state->replies[id] = value;
+
+         if (!--state->pending)
+            callback(state->replies);
+      });
+   }
+}
+
+void DBus::AsyncQuery::accountDetails(const QStringList& accountIds, QObject* context, const BatchCallback<MapStringString>& callback)
+{
+   batch<MapStringString>(accountIds, context, callback, &DBus::AsyncQuery::getAccountDetails);
+}
+
+void DBus::AsyncQuery::volatileAccountDetails(const QStringList& accountIds, QObject* context, const BatchCallback<MapStringString>& callback)
+{
+   batch<MapStringString>(accountIds, context, callback, &DBus::AsyncQuery::getVolatileAccountDetails);
+}
+
+void DBus::AsyncQuery::callDetails(const QStringList& callIds, QObject* context, const BatchCallback<MapStringString>& callback)
+{
+   batch<MapStringString>(callIds, context, callback, &DBus::AsyncQuery::getCallDetails);
+}
+
+void DBus::AsyncQuery::isRecording(const QStringList& callIds, QObject* context, const BatchCallback<bool>& callback)
+{
+   batch<bool>(callIds, context, callback, &getIsRecording);
+}
+
+void DBus::AsyncQuery::participantLists(const QStringList& confIds, QObject* context, const BatchCallback<QStringList>& callback)
+{
+   batch<QStringList>(confIds, context, callback, &getParticipantList);
+}
+
+#include <asyncquery.moc>
@@ -0,0 +1,86 @@
+/****************************************************************************
+ *   Copyright (C) 2015 by Savoir-Faire Linux                               *
+ *   Author : Emmanuel Lepage Vallee <emmanuel.lepage@savoirfairelinux.com> *
+ *                                                                          *
+ *   This library is free software; you can redistribute it and/or          *
+ *   modify it under the terms of the GNU Lesser General Public             *
+ *   License as published by the Free Software Foundation; either           *
+ *   version 2.1 of the License, or (at your option) any later version.     *
+ *                                                                          *
+ *   This library is distributed in the hope that it will be useful,        *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU      *
+ *   Lesser General Public License for more details.                        *
+ *                                                                          *
+ *   You should have received a copy of the GNU General Public License      *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>.  *
+ ***************************************************************************/
+#ifndef DBUS_ASYNC_QUERY_H
+#define DBUS_ASYNC_QUERY_H
+
+#include <typedefs.h>
+
+//Qt
+#include <QtCore/QHash>
+#include <QtCore/QStringList>
+
+//STD
+#include <functional>
+
+class QObject;
+
+namespace DBus {
+
+/**
+ * Non blocking variants of the most used daemon queries.
+ *
+ * Each query is sent right away, without waiting for the previous ones, so
+ * a batch of queries is pipelined. The callback is invoked with the reply
+ * in the thread of the context object. It is never invoked if the context
+ * is null or was destroyed in the meantime.
+ *
+ * A failed query still invoke the callback, with ok set to false and an
+ * empty value. The native daemon library has no error reporting, its
+ * queries always succeed.
+ *
+ * With DBus, the replies are asynchronous method calls. With the native
+ * daemon library, the queries are run in order on a dedicated thread.
+ *
+ * The batches invoke their callback once all the replies arrived, the
+ * failed queries are left out of the hash.
+ */
+class LIB_EXPORT AsyncQuery
+{
+public:
+   typedef std::function<void(const MapStringString&                , bool ok)> DetailsCallback     ;
+   typedef std::function<void(const MapStringMapStringVectorString& , bool ok)> CapabilitiesCallback;
+
+   template<typename T>
+   using BatchCallback = std::function<void(const QHash<QString,T>&)>;
+
+   //ConfigurationManager
+   static void getAccountDetails        (const QString& accountId, QObject* context, const DetailsCallback& callback);
+   static void getVolatileAccountDetails(const QString& accountId, QObject* context, const DetailsCallback& callback);
+   static void getCertificateDetails    (const QString& path     , QObject* context, const DetailsCallback& callback);
+
+   //CallManager
+   static void getCallDetails           (const QString& callId   , QObject* context, const DetailsCallback& callback);
+   static void getConferenceDetails     (const QString& confId   , QObject* context, const DetailsCallback& callback);
+
+   //VideoManager
+   static void getCapabilities          (const QString& deviceId , QObject* context, const CapabilitiesCallback& callback);
+
+   //Pipelined batches
+   static void accountDetails        (const QStringList& accountIds, QObject* context, const BatchCallback<MapStringString>& callback);
+   static void volatileAccountDetails(const QStringList& accountIds, QObject* context, const BatchCallback<MapStringString>& callback);
+   static void callDetails           (const QStringList& callIds   , QObject* context, const BatchCallback<MapStringString>& callback);
+   static void isRecording           (const QStringList& callIds   , QObject* context, const BatchCallback<bool           >& callback);
+   static void participantLists      (const QStringList& confIds   , QObject* context, const BatchCallback<QStringList    >& callback);
+
+private:
+   AsyncQuery() = delete;
+};
+
+}
+
+#endif
@@ -20,7 +20,9 @@
 #ifndef CALL_MANAGER_INTERFACE_SINGLETON_H
 #define CALL_MANAGER_INTERFACE_SINGLETON_H
 
-#ifdef ENABLE_LIBWRAP
+#ifdef ENABLE_FAKE_DAEMON
+ #include "../fakedaemon/callmanager_fake.h"
+#elif defined(ENABLE_LIBWRAP)
  #include "../qtwrapper/callmanager_wrap.h"
 #else
  #include "callmanager_dbus_interface.h"
@@ -19,7 +19,9 @@
 #ifndef CONFIGURATION_MANAGER_INTERFACE_SINGLETON_H
 #define CONFIGURATION_MANAGER_INTERFACE_SINGLETON_H
 
-#ifdef ENABLE_LIBWRAP
+#ifdef ENABLE_FAKE_DAEMON
+ #include "../fakedaemon/configurationmanager_fake.h"
+#elif defined(ENABLE_LIBWRAP)
  #include "../qtwrapper/configurationmanager_wrap.h"
 #else
  #include "configurationmanager_dbus_interface.h"
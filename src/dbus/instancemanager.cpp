@@ -18,15 +18,33 @@
  ***************************************************************************/
 
 #include "instancemanager.h"
+#include "ipctrace.h"
+#include "signalrecorder.h"
+#include "signalreplayer.h"
 #include <unistd.h>
 
 InstanceInterface* DBus::InstanceManager::interface = nullptr;
 
+/**
+ * Start the debugging tools enabled in the environment.
+ *
+ * This is done once, when the daemon is first reached, and not for each
+ * call to instance(). The application object must exist by then.
+ */
+static void startTools()
+{
+   DBus::IpcTrace::dumpOnExit();
+   DBus::SignalRecorder::recordOnStart();
+   DBus::SignalReplayer::replayOnStart();
+}
+
 InstanceInterface& DBus::InstanceManager::instance()
 {
 #ifdef ENABLE_LIBWRAP
-    if (!interface)
+    if (!interface) {
         interface = new InstanceInterface();
+        startTools();
+    }
 #else
    if (!dbus_metaTypeInit) registerCommTypes();
    if (!interface)
@@ -39,6 +57,7 @@ InstanceInterface& DBus::InstanceManager::instance()
       QDBusPendingReply<QString> reply = interface->Register(getpid(), "");
       registred = true;
       reply.waitForFinished();
+      startTools();
    }
 #endif
    return *interface;
@@ -19,7 +19,9 @@
 #ifndef INSTANCEMANAGER_H
 #define INSTANCEMANAGER_H
 
-#ifdef ENABLE_LIBWRAP
+#ifdef ENABLE_FAKE_DAEMON
+ #include "../fakedaemon/instancemanager_fake.h"
+#elif defined(ENABLE_LIBWRAP)
  #include "../qtwrapper/instancemanager_wrap.h"
 #else
 #include "instance_dbus_interface.h"
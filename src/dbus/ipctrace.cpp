@@ -0,0 +1,481 @@
+/****************************************************************************
+ *   Copyright (C) 2015 by Savoir-Faire Linux                               *
+ *   Author : Emmanuel Lepage Vallee <emmanuel.lepage@savoirfairelinux.com> *
+ *                                                                          *
+ *   This library is free software; you can redistribute it and/or          *
+ *   modify it under the terms of the GNU Lesser General Public             *
+ *   License as published by the Free Software Foundation; either           *
+ *   version 2.1 of the License, or (at your option) any later version.     *
+ *                                                                          *
+ *   This library is distributed in the hope that it will be useful,        *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU      *
+ *   Lesser General Public License for more details.                        *
+ *                                                                          *
+ *   You should have received a copy of the GNU General Public License      *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>.  *
+ ***************************************************************************/
+#include "ipctrace.h"
+
+//Qt
+#include <QtCore/QCoreApplication>
+#include <QtCore/QDebug>
+#include <QtCore/QHash>
+#include <QtCore/QSaveFile>
+
+//STD
+#include <atomic>
+#include <chrono>
+#include <cstring>
+
+/* Implementation note: ring buffer
+ * The writers claim a slot by incrementing a global counter, the oldest
+ * events are overwritten once the ring is full. Each slot is guarded by a
+ * sequence number (a seqlock): it is odd while the slot is being written
+ * and even once the event is complete. The reader copy a slot and only
+ * keep it if the sequence didn't change in the meantime, so the writers
+ * never wait for it.
+ *
+ * Two writers RING_SIZE events apart land on the same slot. If the first
+ * one is still writing when the second one comes, they would interleave
+ * their fields and the reader could not tell. The slot is claimed with a
+ * compare and swap instead: a writer finding it odd, or already used by a
+ * more recent event, drop its event from the ring. The event is still
+ * aggregated in the counters.
+ *
+ * The per name counters are an open addressing table keyed by the name
+ * pointer, the entries are claimed with a compare and swap and never
+ * released (until reset()). A name may have many pointers (one per
+ * translation unit using it), they are merged when the statistics are read.
+ */
+
+namespace {
+
+constexpr static const int RING_SIZE  = 4096; /*!< Must be a power of 2 */
+constexpr static const int TABLE_SIZE = 512 ; /*!< Must be a power of 2 */
+constexpr static const int KINDS      = static_cast<int>(DBus::IpcTrace::Kind::COUNT__);
+
+///A recorded event
+struct Event {
+   std::atomic<quint64>     seq    ; /*!< 2n+1 while written, 2n+2 once the event n is complete */
+   std::atomic<const char*> name   ;
+   std::atomic<int>         kind   ;
+   std::atomic<int>         thread ;
+   std::atomic<qint64>      begin  ;
+   std::atomic<qint64>      end    ;
+   std::atomic<qint64>      queued ;
+   std::atomic<quint64>     payload;
+};
+
+///The counters of a name
+struct Counter {
+   std::atomic<const char*> name      ;
+   std::atomic<quint64>     count     ;
+   std::atomic<quint64>     totalTime ;
+   std::atomic<quint64>     maxTime   ;
+   std::atomic<quint64>     totalQueue;
+   std::atomic<quint64>     maxQueue  ;
+   std::atomic<quint64>     payload   ;
+   std::atomic<quint64>     histogram[DBus::IpcTrace::BUCKETS];
+};
+
+// Everything is zero initialized, there is no constructor to run
+Event                 g_lRing    [RING_SIZE]        ;
+Counter               g_lCounters[KINDS][TABLE_SIZE];
+std::atomic<quint64>  g_Next                        ; /*!< Number of events ever recorded   */
+std::atomic<int>      g_ThreadCount                 ;
+std::atomic<bool>     g_Enabled {true}              ;
+
+thread_local int      t_ThreadId = 0; /*!< 0 is the queue track of the Chrome trace */
+thread_local quint64  t_Payload  = 0;
+
+int threadId()
+{
+   if (!t_ThreadId)
+      t_ThreadId = ++g_ThreadCount;
+
+   return t_ThreadId;
+}
+
+void storeMax(std::atomic<quint64>& max, quint64 value)
+{
+   quint64 current = max.load(std::memory_order_relaxed);
+
+   while (value > current && !max.compare_exchange_weak(current, value, std::memory_order_relaxed));
+}
+
+///Find or claim the counters of a name, nullptr if the table is full
+Counter* counter(int kind, const char* name)
+{
+   const quintptr hash = (reinterpret_cast<quintptr>(name) >> 3) * 2654435761u;
+
+   for (int i = 0; i < TABLE_SIZE; i++) {
+      Counter& c = g_lCounters[kind][(hash + i) & (TABLE_SIZE - 1)];
+
+      const char* current = c.name.load(std::memory_order_acquire);
+
+      if (current == name)
+         return &c;
+
+      if (!current) {
+         if (c.name.compare_exchange_strong(current, name, std::memory_order_acq_rel) || current == name)
+            return &c;
+      }
+   }
+
+   return nullptr;
+}
+
+///Index of the histogram bucket
+int bucket(quint64 ns)
+{
+   quint64 us = ns / 1000;
+   int     b  = 0;
+
+   while (us && b < DBus::IpcTrace::BUCKETS - 1) {
+      us >>= 1;
+      b++;
+   }
+
+   return b;
+}
+
+QByteArray toUs(qint64 ns)
+{
+   return QByteArray::number(static_cast<double>(ns) / 1000.0, 'f', 3);
+}
+
+}
+
+/*****************************************************************************
+ *                                                                           *
+ *                                  Scope                                    *
+ *                                                                           *
+ ****************************************************************************/
+
+DBus::IpcTrace::Scope::Scope(Kind kind, const char* name, qint64 queued) :
+m_Kind(kind), m_pName(nullptr), m_Begin(0), m_Queued(queued), m_Payload(0)
+{
+   if (g_Enabled.load(std::memory_order_relaxed)) {
+      m_pName   = name;
+      m_Payload = t_Payload;
+      m_Begin   = now();
+   }
+}
+
+DBus::IpcTrace::Scope::~Scope()
+{
+   if (m_pName)
+      record(m_Kind, m_pName, m_Begin, now(), m_Queued, t_Payload - m_Payload);
+}
+
+/*****************************************************************************
+ *                                                                           *
+ *                                 Mutators                                  *
+ *                                                                           *
+ ****************************************************************************/
+
+/**
+ * Record an event.
+ *
+ * @param name   a string which live as long as the library (a literal)
+ * @param begin  the start of the call or delivery, see now()
+ * @param end    the end of the call or delivery
+ * @param queued when the signal was emitted by the daemon, 0 if unknown
+ */
+void DBus::IpcTrace::record(Kind kind, const char* name, qint64 begin, qint64 end, qint64 queued, quint64 payload)
+{
+   if (!g_Enabled.load(std::memory_order_relaxed))
+      return;
+
+   const int     k        = static_cast<int>(kind);
+   const quint64 duration = end > begin ? end - begin : 0;
+   const quint64 delay    = (queued && begin > queued) ? begin - queued : 0;
+
+   // Publish the event
+   const quint64 n = g_Next.fetch_add(1, std::memory_order_relaxed);
+   Event& e = g_lRing[n & (RING_SIZE - 1)];
+
+   // Claim the slot, it is left alone while another writer own it
+   quint64 prev = e.seq.load(std::memory_order_relaxed);
+
+   if ((!(prev & 1)) && prev < 2*n + 1 && e.seq.compare_exchange_strong(prev, 2*n + 1, std::memory_order_relaxed)) {
+      std::atomic_thread_fence(std::memory_order_release);
+
+      e.name   .store(name      , std::memory_order_relaxed);
+      e.kind   .store(k         , std::memory_order_relaxed);
+      e.thread .store(threadId(), std::memory_order_relaxed);
+      e.begin  .store(begin     , std::memory_order_relaxed);
+      e.end    .store(end       , std::memory_order_relaxed);
+      e.queued .store(queued    , std::memory_order_relaxed);
+      e.payload.store(payload   , std::memory_order_relaxed);
+
+      e.seq.store(2*n + 2, std::memory_order_release);
+   }
+
+   // Aggregate it
+   Counter* c = counter(k, name);
+
+   if (!c)
+      return;
+
+   c->count     .fetch_add(1       , std::memory_order_relaxed);
+   c->totalTime .fetch_add(duration, std::memory_order_relaxed);
+   c->totalQueue.fetch_add(delay   , std::memory_order_relaxed);
+   c->payload   .fetch_add(payload , std::memory_order_relaxed);
+   c->histogram[bucket(duration)].fetch_add(1, std::memory_order_relaxed);
+
+   storeMax(c->maxTime , duration);
+   storeMax(c->maxQueue, delay   );
+}
+
+///Account bytes converted by the current thread, they go to the innermost Scope
+void DBus::IpcTrace::addPayload(quint64 bytes)
+{
+   t_Payload += bytes;
+}
+
+///Clear the events and the statistics, events recorded meanwhile may be partially lost
+void DBus::IpcTrace::reset()
+{
+   for (int k = 0; k < KINDS; k++) {
+      for (Counter& c : g_lCounters[k]) {
+         c.count     .store(0, std::memory_order_relaxed);
+         c.totalTime .store(0, std::memory_order_relaxed);
+         c.maxTime   .store(0, std::memory_order_relaxed);
+         c.totalQueue.store(0, std::memory_order_relaxed);
+         c.maxQueue  .store(0, std::memory_order_relaxed);
+         c.payload   .store(0, std::memory_order_relaxed);
+
+         for (std::atomic<quint64>& h : c.histogram)
+            h.store(0, std::memory_order_relaxed);
+      }
+   }
+
+   for (Event& e : g_lRing)
+      e.seq.store(0, std::memory_order_relaxed);
+
+   g_Next.store(0, std::memory_order_release);
+}
+
+/*****************************************************************************
+ *                                                                           *
+ *                                 Getters                                   *
+ *                                                                           *
+ ****************************************************************************/
+
+bool DBus::IpcTrace::isEnabled()
+{
+   return g_Enabled.load(std::memory_order_relaxed);
+}
+
+///The events overwritten in the ring before being exported
+quint64 DBus::IpcTrace::overwrittenCount()
+{
+   const quint64 next = g_Next.load(std::memory_order_relaxed);
+
+   return next > RING_SIZE ? next - RING_SIZE : 0;
+}
+
+///The counters of all the methods and signals seen so far
+QList<DBus::IpcTrace::Statistics> DBus::IpcTrace::statistics()
+{
+   QList<Statistics> ret;
+
+   for (int k = 0; k < KINDS; k++) {
+      QHash<QByteArray, int> byName;
+
+      for (const Counter& c : g_lCounters[k]) {
+         const char* name = c.name.load(std::memory_order_acquire);
+
+         if (!name)
+            continue;
+
+         const quint64 count = c.count.load(std::memory_order_relaxed);
+
+         if (!count)
+            continue;
+
+         const QByteArray n(name);
+
+         if (!byName.contains(n)) {
+            Statistics s;
+            ::memset(&s.histogram, 0, sizeof(s.histogram));
+            s.name       = n;
+            s.kind       = static_cast<Kind>(k);
+            s.count      = 0;
+            s.totalTime  = 0;
+            s.maxTime    = 0;
+            s.totalQueue = 0;
+            s.maxQueue   = 0;
+            s.payload    = 0;
+            byName[n]    = ret.size();
+            ret << s;
+         }
+
+         Statistics& s = ret[byName[n]];
+
+         s.count      += count;
+         s.totalTime  += c.totalTime .load(std::memory_order_relaxed);
+         s.totalQueue += c.totalQueue.load(std::memory_order_relaxed);
+         s.payload    += c.payload   .load(std::memory_order_relaxed);
+         s.maxTime     = qMax(s.maxTime , c.maxTime .load(std::memory_order_relaxed));
+         s.maxQueue    = qMax(s.maxQueue, c.maxQueue.load(std::memory_order_relaxed));
+
+         for (int b = 0; b < BUCKETS; b++)
+            s.histogram[b] += c.histogram[b].load(std::memory_order_relaxed);
+      }
+   }
+
+   return ret;
+}
+
+/*****************************************************************************
+ *                                                                           *
+ *                                 Setters                                   *
+ *                                                                           *
+ ****************************************************************************/
+
+void DBus::IpcTrace::setEnabled(bool enabled)
+{
+   g_Enabled.store(enabled, std::memory_order_relaxed);
+}
+
+/*****************************************************************************
+ *                                                                           *
+ *                                  Export                                   *
+ *                                                                           *
+ ****************************************************************************/
+
+///Export the events still in the ring and the statistics as a Chrome trace
+QByteArray DBus::IpcTrace::chromeTrace()
+{
+   static const char* kinds[] = { "method", "delivery" };
+
+   const QByteArray pid  = QByteArray::number(QCoreApplication::applicationPid());
+   const quint64    next = g_Next.load(std::memory_order_acquire);
+   const quint64    from = next > RING_SIZE ? next - RING_SIZE : 0;
+
+   QByteArray ret;
+   ret.reserve(static_cast<int>(next - from) * 160 + 4096);
+
+   ret += "{\"traceEvents\":[\n";
+   ret += "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":"+pid+",\"tid\":0,\"args\":{\"name\":\"Signal queue\"}}";
+
+   for (quint64 n = from; n < next; n++) {
+      const Event& e = g_lRing[n & (RING_SIZE - 1)];
+
+      const quint64 seq     = e.seq    .load(std::memory_order_acquire);
+      const char*   name    = e.name   .load(std::memory_order_relaxed);
+      const int     kind    = e.kind   .load(std::memory_order_relaxed);
+      const int     thread  = e.thread .load(std::memory_order_relaxed);
+      const qint64  begin   = e.begin  .load(std::memory_order_relaxed);
+      const qint64  end     = e.end    .load(std::memory_order_relaxed);
+      const qint64  queued  = e.queued .load(std::memory_order_relaxed);
+      const quint64 payload = e.payload.load(std::memory_order_relaxed);
+
+      std::atomic_thread_fence(std::memory_order_acquire);
+
+      // Still being written, or already overwritten
+      if (seq != 2*n + 2 || e.seq.load(std::memory_order_relaxed) != seq || !name)
+         continue;
+
+      ret += ",\n{\"name\":\"";
+      ret += name;
+      ret += "\",\"cat\":\"";
+      ret += kinds[kind];
+      ret += "\",\"ph\":\"X\",\"ts\":"+toUs(begin)+",\"dur\":"+toUs(end - begin);
+      ret += ",\"pid\":"+pid+",\"tid\":"+QByteArray::number(thread);
+      ret += ",\"args\":{\"payload\":"+QByteArray::number(payload);
+
+      if (queued)
+         ret += ",\"queue_us\":"+toUs(begin - queued);
+
+      ret += "}}";
+
+      // The time spent in the queue, as an async slice
+      if (queued) {
+         const QByteArray id = QByteArray::number(n);
+
+         ret += ",\n{\"name\":\"";
+         ret += name;
+         ret += "\",\"cat\":\"queue\",\"ph\":\"b\",\"id\":"+id+",\"ts\":"+toUs(queued)+",\"pid\":"+pid+",\"tid\":0}";
+         ret += ",\n{\"name\":\"";
+         ret += name;
+         ret += "\",\"cat\":\"queue\",\"ph\":\"e\",\"id\":"+id+",\"ts\":"+toUs(begin)+",\"pid\":"+pid+",\"tid\":0}";
+      }
+   }
+
+   ret += "\n],\n\"displayTimeUnit\":\"ms\",\n\"overwritten\":"+QByteArray::number(overwrittenCount());
+   ret += ",\n\"ipcStatistics\":[";
+
+   bool first = true;
+
+   foreach(const Statistics& s, statistics()) {
+      ret += first ? "\n" : ",\n";
+      first = false;
+
+      ret += "{\"name\":\""+s.name+"\",\"kind\":\"";
+      ret += kinds[static_cast<int>(s.kind)];
+      ret += "\",\"count\":"+QByteArray::number(s.count);
+      ret += ",\"total_us\":"+toUs(s.totalTime)+",\"max_us\":"+toUs(s.maxTime);
+      ret += ",\"queue_total_us\":"+toUs(s.totalQueue)+",\"queue_max_us\":"+toUs(s.maxQueue);
+      ret += ",\"payload\":"+QByteArray::number(s.payload)+",\"histogram\":[";
+
+      for (int b = 0; b < BUCKETS; b++) {
+         if (b)
+            ret += ',';
+         ret += QByteArray::number(s.histogram[b]);
+      }
+
+      ret += "]}";
+   }
+
+   ret += "\n]}\n";
+
+   return ret;
+}
+
+///Write the Chrome trace to a file
+bool DBus::IpcTrace::dump(const QString& path)
+{
+   QSaveFile file(path);
+
+   if (!file.open(QIODevice::WriteOnly)) {
+      qWarning() << "Cannot write the IPC trace to" << path << file.errorString();
+      return false;
+   }
+
+   file.write(chromeTrace());
+
+   return file.commit();
+}
+
+///Dump the trace when the application quit, if LRC_IPC_TRACE is set
+void DBus::IpcTrace::dumpOnExit()
+{
+   static bool init = false;
+
+   if (init || !QCoreApplication::instance())
+      return;
+
+   init = true;
+
+   const QString path = QString::fromLocal8Bit(qgetenv("LRC_IPC_TRACE"));
+
+   if (path.isEmpty())
+      return;
+
+   QObject::connect(QCoreApplication::instance(), &QCoreApplication::aboutToQuit, [path]() {
+      if (dump(path))
+         qDebug() << "IPC trace written to" << path;
+   });
+}
+
+///Monotonic time, in ns
+qint64 DBus::IpcTrace::now()
+{
+   return std::chrono::duration_cast<std::chrono::nanoseconds>(
+      std::chrono::steady_clock::now().time_since_epoch()
+   ).count();
+}
@@ -0,0 +1,117 @@
+/****************************************************************************
+ *   Copyright (C) 2015 by Savoir-Faire Linux                               *
+ *   Author : Emmanuel Lepage Vallee <emmanuel.lepage@savoirfairelinux.com> *
+ *                                                                          *
+ *   This library is free software; you can redistribute it and/or          *
+ *   modify it under the terms of the GNU Lesser General Public             *
+ *   License as published by the Free Software Foundation; either           *
+ *   version 2.1 of the License, or (at your option) any later version.     *
+ *                                                                          *
+ *   This library is distributed in the hope that it will be useful,        *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU      *
+ *   Lesser General Public License for more details.                        *
+ *                                                                          *
+ *   You should have received a copy of the GNU General Public License      *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>.  *
+ ***************************************************************************/
+#ifndef DBUS_IPC_TRACE_H
+#define DBUS_IPC_TRACE_H
+
+#include <typedefs.h>
+
+//Qt
+#include <QtCore/QByteArray>
+#include <QtCore/QList>
+
+class QString;
+
+namespace DBus {
+
+/**
+ * Instrumentation of the daemon boundary.
+ *
+ * Each method call and each signal delivery is recorded as an event in a
+ * fixed size ring buffer, and aggregated per name into counters and a
+ * latency histogram. Recording an event never lock nor allocate, it is a
+ * few relaxed atomic operations, so the tracing stay enabled by default.
+ *
+ * For the signals, the queueing delay is the time between the daemon
+ * emission and the delivery in the Qt thread. The payload is the number of
+ * bytes converted between the daemon and the Qt types.
+ *
+ * The ring can be exported in the Chrome trace format, to be loaded in
+ * chrome://tracing or Perfetto. If the LRC_IPC_TRACE environment variable
+ * is set, the trace is written to that path when the application quit.
+ */
+class LIB_EXPORT IpcTrace
+{
+public:
+   ///The type of event
+   enum class Kind {
+      METHOD  = 0, /*!< A method call, from the client to the daemon     */
+      DELIVERY= 1, /*!< A signal delivery, from the daemon to the client */
+      COUNT__
+   };
+
+   ///Histogram buckets, bucket n count the durations under 2^n µs, the last everything above
+   constexpr static const int BUCKETS = 20;
+
+   ///Aggregated statistics of a method or signal
+   struct Statistics {
+      QByteArray name              ;
+      Kind       kind              ;
+      quint64    count             ;
+      quint64    totalTime         ; /*!< Sum of the durations, in ns       */
+      quint64    maxTime           ; /*!< Longest duration, in ns           */
+      quint64    totalQueue        ; /*!< Sum of the queueing delays, in ns */
+      quint64    maxQueue          ; /*!< Longest queueing delay, in ns     */
+      quint64    payload           ; /*!< Converted bytes                   */
+      quint64    histogram[BUCKETS];
+   };
+
+   ///Record the current scope as an event
+   class Scope {
+   public:
+      Scope(Kind kind, const char* name, qint64 queued = 0);
+      ~Scope();
+
+   private:
+      Kind        m_Kind   ;
+      const char* m_pName  ; /*!< nullptr if the tracing is disabled     */
+      qint64      m_Begin  ;
+      qint64      m_Queued ; /*!< Emission time, 0 if it wasn't queued  */
+      quint64     m_Payload; /*!< Thread payload counter at the start    */
+   };
+
+   //Getters
+   static bool              isEnabled       ();
+   static QList<Statistics> statistics      ();
+   static quint64           overwrittenCount();
+
+   //Setters
+   static void setEnabled(bool enabled);
+
+   //Mutators
+   static void record    (Kind kind, const char* name, qint64 begin, qint64 end, qint64 queued, quint64 payload);
+   static void addPayload(quint64 bytes);
+   static void reset     ();
+
+   //Export
+   static QByteArray chromeTrace();
+   static bool       dump       (const QString& path);
+   static void       dumpOnExit ();
+
+   //Helpers
+   static qint64 now();
+
+private:
+   IpcTrace() = delete;
+};
+
+}
+
+///Trace the enclosing daemon method
+#define TRACE_DRING_CALL DBus::IpcTrace::Scope _ipcTrace(DBus::IpcTrace::Kind::METHOD, __func__)
+
+#endif
@@ -18,7 +18,9 @@
 #ifndef PRESENCEMANAGER_H
 #define PRESENCEMANAGER_H
 
-#ifdef ENABLE_LIBWRAP
+#ifdef ENABLE_FAKE_DAEMON
+ #include "../fakedaemon/presencemanager_fake.h"
+#elif defined(ENABLE_LIBWRAP)
  #include "../qtwrapper/presencemanager_wrap.h"
 #else
  #include "presencemanager_dbus_interface.h"
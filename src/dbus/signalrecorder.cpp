@@ -0,0 +1,335 @@
+/****************************************************************************
+ *   Copyright (C) 2015 by Savoir-Faire Linux                               *
+ *   Author : Emmanuel Lepage Vallee <emmanuel.lepage@savoirfairelinux.com> *
+ *                                                                          *
+ *   This library is free software; you can redistribute it and/or          *
+ *   modify it under the terms of the GNU Lesser General Public             *
+ *   License as published by the Free Software Foundation; either           *
+ *   version 2.1 of the License, or (at your option) any later version.     *
+ *                                                                          *
+ *   This library is distributed in the hope that it will be useful,        *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU      *
+ *   Lesser General Public License for more details.                        *
+ *                                                                          *
+ *   You should have received a copy of the GNU General Public License      *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>.  *
+ ***************************************************************************/
+#include "signalrecorder.h"
+
+//Qt
+#include <QtCore/QCoreApplication>
+#include <QtCore/QDataStream>
+#include <QtCore/QDateTime>
+#include <QtCore/QDebug>
+#include <QtCore/QFile>
+#include <QtCore/QMetaMethod>
+#include <QtCore/QMutex>
+#include <QtCore/QVector>
+
+//STD
+#include <limits>
+
+//Ring
+#include "callmanager.h"
+#include "configurationmanager.h"
+#include "presencemanager.h"
+#include "videomanager.h"
+#include "metatypes.h"
+#include "ipctrace.h"
+
+/* Implementation note: dynamic slots
+ * The signals have many different signatures and the file has to store
+ * their arguments without knowing them at compile time. Like QSignalSpy,
+ * the sink has no moc and override qt_metacall(), each connection target a
+ * method index past the end of its meta object. The arguments are then
+ * received as an array of pointers and saved according to the signal
+ * parameter types.
+ */
+
+namespace {
+
+///A connected signal
+struct Slot {
+   QByteArray   interface;
+   QMetaMethod  method   ;
+   QVector<int> types    ;
+   bool         defined  ; /*!< The DEFINE record was written */
+};
+
+class RecorderSink final : public QObject
+{
+public:
+   explicit RecorderSink(const QString& path);
+   virtual ~RecorderSink();
+
+   //Mutators
+   bool open            ();
+   void connectInterface(const QByteArray& name, QObject* object);
+
+   int qt_metacall(QMetaObject::Call call, int id, void** args) override;
+
+   //Attributes
+   QFile          m_File  ;
+   QDataStream    m_Stream;
+   qint64         m_Start ;
+   quint64        m_Count ;
+   QVector<Slot>  m_lSlots;
+   QMutex         m_Mutex ;
+
+private:
+   //Helpers
+   void record(quint16 id, void** args);
+};
+
+RecorderSink* g_pSink = nullptr;
+
+///If the type can be saved, this is checked once as QMetaType::save() could fail halfway through a record
+bool isStreamable(int type)
+{
+   if (type == QMetaType::UnknownType || type == QMetaType::Void)
+      return false;
+
+   void* value = QMetaType::create(type);
+
+   if (!value)
+      return false;
+
+   QByteArray  buffer;
+   QDataStream stream(&buffer, QIODevice::WriteOnly);
+   const bool  ret = QMetaType::save(stream, type, value);
+
+   QMetaType::destroy(type, value);
+
+   return ret;
+}
+
+}
+
+RecorderSink::RecorderSink(const QString& path) : QObject(),
+m_File(path), m_Start(DBus::IpcTrace::now()), m_Count(0)
+{
+}
+
+RecorderSink::~RecorderSink()
+{
+   if (m_File.isOpen()) {
+      m_File.flush();
+      m_File.close();
+   }
+}
+
+bool RecorderSink::open()
+{
+   if (!m_File.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+      qWarning() << "Cannot record the daemon signals to" << m_File.fileName() << m_File.errorString();
+      return false;
+   }
+
+   m_Stream.setDevice(&m_File);
+   m_Stream.setVersion(QDataStream::Qt_5_0);
+
+   m_Stream << DBus::SignalRecorder::MAGIC << DBus::SignalRecorder::VERSION
+      << static_cast<qint64>(QDateTime::currentMSecsSinceEpoch());
+
+   return m_Stream.status() == QDataStream::Ok;
+}
+
+///Connect all the signals declared by the interface itself
+void RecorderSink::connectInterface(const QByteArray& name, QObject* object)
+{
+   const QMetaObject* mo = object->metaObject();
+
+   for (int i = mo->methodOffset(); i < mo->methodCount(); i++) {
+      const QMetaMethod method = mo->method(i);
+
+      if (method.methodType() != QMetaMethod::Signal)
+         continue;
+
+      Slot s { name, method, {}, false };
+
+      bool supported = true;
+
+      for (int p = 0; p < method.parameterCount(); p++) {
+         const int type = method.parameterType(p);
+         supported &= isStreamable(type);
+         s.types << type;
+      }
+
+      if (!supported) {
+         qWarning() << "Signal" << method.methodSignature() << "cannot be recorded, unsupported argument type";
+         continue;
+      }
+
+      if (m_lSlots.size() > std::numeric_limits<quint16>::max())
+         return;
+
+      const int index = metaObject()->methodCount() + m_lSlots.size();
+
+      m_lSlots << s;
+
+      QMetaObject::connect(object, i, this, index, Qt::DirectConnection);
+   }
+}
+
+int RecorderSink::qt_metacall(QMetaObject::Call call, int id, void** args)
+{
+   id = QObject::qt_metacall(call, id, args);
+
+   if (id < 0 || call != QMetaObject::InvokeMetaMethod)
+      return id;
+
+   if (id < m_lSlots.size())
+      record(static_cast<quint16>(id), args);
+
+   return -1;
+}
+
+///args[0] is the return value, the arguments follow
+void RecorderSink::record(quint16 id, void** args)
+{
+   const qint64 time = DBus::IpcTrace::now() - m_Start;
+
+   // The daemon interfaces live in the main thread, but nothing prevent an emission from elsewhere
+   QMutexLocker locker(&m_Mutex);
+
+   Slot& s = m_lSlots[id];
+
+   if (!s.defined) {
+      // The canonical names, the backends don't spell the typedefs the same way
+      QList<QByteArray> types;
+      foreach(const int type, s.types)
+         types << QMetaType::typeName(type);
+
+      m_Stream << static_cast<quint8>(DBus::SignalRecorder::Record::DEFINE) << id
+         << s.interface << s.method.name() << types;
+      s.defined = true;
+   }
+
+   m_Stream << static_cast<quint8>(DBus::SignalRecorder::Record::EMISSION) << id << time;
+
+   for (int i = 0; i < s.types.size(); i++)
+      QMetaType::save(m_Stream, s.types[i], args[i+1]);
+
+   m_Count++;
+}
+
+/*****************************************************************************
+ *                                                                           *
+ *                                 Getters                                   *
+ *                                                                           *
+ ****************************************************************************/
+
+bool DBus::SignalRecorder::isRecording()
+{
+   return g_pSink;
+}
+
+///The number of signals recorded since start()
+quint64 DBus::SignalRecorder::count()
+{
+   if (!g_pSink)
+      return 0;
+
+   QMutexLocker locker(&g_pSink->m_Mutex);
+
+   return g_pSink->m_Count;
+}
+
+/*****************************************************************************
+ *                                                                           *
+ *                                 Mutators                                  *
+ *                                                                           *
+ ****************************************************************************/
+
+///Start recording to path, a recording already in progress is stopped first
+bool DBus::SignalRecorder::start(const QString& path)
+{
+   stop();
+
+   registerTypes();
+
+   RecorderSink* sink = new RecorderSink(path);
+
+   if (!sink->open()) {
+      delete sink;
+      return false;
+   }
+
+   typedef QPair<QByteArray,QObject*> Interface;
+   foreach(const Interface& i, interfaces())
+      sink->connectInterface(i.first, i.second);
+
+   g_pSink = sink;
+
+   return true;
+}
+
+///Stop the recording and flush the file
+void DBus::SignalRecorder::stop()
+{
+   if (!g_pSink)
+      return;
+
+   RecorderSink* sink = g_pSink;
+   g_pSink = nullptr;
+
+   qDebug() << "Recorded" << sink->m_Count << "daemon signals to" << sink->m_File.fileName();
+
+   delete sink;
+}
+
+///Record until the application quit, if LRC_SIGNAL_RECORD is set
+void DBus::SignalRecorder::recordOnStart()
+{
+   static bool init = false;
+
+   if (init || !QCoreApplication::instance())
+      return;
+
+   init = true;
+
+   const QString path = QString::fromLocal8Bit(qgetenv("LRC_SIGNAL_RECORD"));
+
+   if (path.isEmpty() || !start(path))
+      return;
+
+   QObject::connect(QCoreApplication::instance(), &QCoreApplication::aboutToQuit, &DBus::SignalRecorder::stop);
+}
+
+/*****************************************************************************
+ *                                                                           *
+ *                                 Helpers                                   *
+ *                                                                           *
+ ****************************************************************************/
+
+///The recorded interfaces, by the name used in the files
+QList< QPair<QByteArray,QObject*> > DBus::SignalRecorder::interfaces()
+{
+   return {
+      { "CallManager"         , &DBus::CallManager         ::instance() },
+      { "ConfigurationManager", &DBus::ConfigurationManager::instance() },
+      { "PresenceManager"     , &DBus::PresenceManager     ::instance() },
+      { "VideoManager"        , &DBus::VideoManager        ::instance() },
+   };
+}
+
+///Make the typedefs used in the signatures known to QMetaType, with their stream operators
+void DBus::SignalRecorder::registerTypes()
+{
+   static bool init = false;
+
+   if (init)
+      return;
+
+   init = true;
+
+   qRegisterMetaTypeStreamOperators<MapStringString      >("MapStringString"      );
+   qRegisterMetaTypeStreamOperators<MapStringInt         >("MapStringInt"         );
+   qRegisterMetaTypeStreamOperators<VectorMapStringString>("VectorMapStringString");
+   qRegisterMetaTypeStreamOperators<VectorInt            >("VectorInt"            );
+   qRegisterMetaTypeStreamOperators<VectorUInt           >("VectorUInt"           );
+   qRegisterMetaTypeStreamOperators<VectorString         >("VectorString"         );
+   qRegisterMetaTypeStreamOperators<MapStringVectorString>("MapStringVectorString");
+   qRegisterMetaTypeStreamOperators<MapStringMapStringStringList>("MapStringMapStringStringList");
+}
@@ -0,0 +1,86 @@
+/****************************************************************************
+ *   Copyright (C) 2015 by Savoir-Faire Linux                               *
+ *   Author : Emmanuel Lepage Vallee <emmanuel.lepage@savoirfairelinux.com> *
+ *                                                                          *
+ *   This library is free software; you can redistribute it and/or          *
+ *   modify it under the terms of the GNU Lesser General Public             *
+ *   License as published by the Free Software Foundation; either           *
+ *   version 2.1 of the License, or (at your option) any later version.     *
+ *                                                                          *
+ *   This library is distributed in the hope that it will be useful,        *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU      *
+ *   Lesser General Public License for more details.                        *
+ *                                                                          *
+ *   You should have received a copy of the GNU General Public License      *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>.  *
+ ***************************************************************************/
+#ifndef DBUS_SIGNAL_RECORDER_H
+#define DBUS_SIGNAL_RECORDER_H
+
+#include <typedefs.h>
+
+//Qt
+#include <QtCore/QByteArray>
+#include <QtCore/QList>
+#include <QtCore/QPair>
+
+class QObject;
+class QString;
+
+namespace DBus {
+
+/**
+ * Record the signals coming from the daemon, to be replayed later by
+ * SignalReplayer.
+ *
+ * The recorder listen to the signals of the DBus::*Manager interfaces, so
+ * it see the same thing as the models whatever the backend is (DBus,
+ * libwrap or the fake daemon). It should be started before the models are
+ * created, its slots then run before theirs and the timestamps are not
+ * skewed by the time spent updating them.
+ *
+ * The file is a QDataStream:
+ *  - a header: MAGIC, VERSION and the recording date (ms since epoch)
+ *  - DEFINE records, the first time a signal is seen: an id, the
+ *    interface name, the signal name and its parameter type names
+ *  - EMISSION records: the id, the time since the start in ns and the
+ *    arguments, saved with QMetaType::save() in the signature order
+ *
+ * If the LRC_SIGNAL_RECORD environment variable is set, the signals are
+ * recorded to that path until the application quit.
+ */
+class LIB_EXPORT SignalRecorder
+{
+public:
+   ///The record types
+   enum class Record : quint8 {
+      DEFINE   = 0, /*!< Introduce a signal id */
+      EMISSION = 1, /*!< A signal emission     */
+      COUNT__
+   };
+
+   //Constants
+   constexpr static const quint32 MAGIC   = 0x4C524352; /*!< "LRCR" */
+   constexpr static const quint16 VERSION = 1         ;
+
+   //Getters
+   static bool    isRecording();
+   static quint64 count      ();
+
+   //Mutators
+   static bool start        (const QString& path);
+   static void stop         ();
+   static void recordOnStart();
+
+   //Helpers
+   static QList< QPair<QByteArray,QObject*> > interfaces   ();
+   static void                                registerTypes();
+
+private:
+   SignalRecorder() = delete;
+};
+
+}
+
+#endif
@@ -0,0 +1,437 @@
+/****************************************************************************
+ *   Copyright (C) 2015 by Savoir-Faire Linux                               *
+ *   Author : Emmanuel Lepage Vallee <emmanuel.lepage@savoirfairelinux.com> *
+ *                                                                          *
+ *   This library is free software; you can redistribute it and/or          *
+ *   modify it under the terms of the GNU Lesser General Public             *
+ *   License as published by the Free Software Foundation; either           *
+ *   version 2.1 of the License, or (at your option) any later version.     *
+ *                                                                          *
+ *   This library is distributed in the hope that it will be useful,        *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU      *
+ *   Lesser General Public License for more details.                        *
+ *                                                                          *
+ *   You should have received a copy of the GNU General Public License      *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>.  *
+ ***************************************************************************/
+#include "signalreplayer.h"
+
+//Qt
+#include <QtCore/QCoreApplication>
+#include <QtCore/QDebug>
+#include <QtCore/QTimer>
+
+//System
+#include <sys/resource.h>
+
+//STD
+#include <algorithm>
+
+//Ring
+#include "signalrecorder.h"
+#include "ipctrace.h"
+
+namespace {
+
+///The peak resident set size of the process, in kB
+qint64 peakMemory()
+{
+   struct rusage usage;
+
+   if (getrusage(RUSAGE_SELF, &usage))
+      return -1;
+
+#ifdef Q_OS_MAC
+   return usage.ru_maxrss / 1024; // In bytes on OS X
+#else
+   return usage.ru_maxrss;
+#endif
+}
+
+QByteArray toMs(qint64 ns)
+{
+   return QByteArray::number(static_cast<double>(ns) / 1000000.0, 'f', 3);
+}
+
+}
+
+DBus::SignalReplayer::SignalReplayer(QObject* parent) : QObject(parent),
+m_HasPending(false), m_Speed(Speed::REALTIME), m_pTimer(new QTimer(this)), m_Start(0), m_Offset(0),
+m_Report()
+{
+   m_Stream.setDevice(&m_File);
+   m_Stream.setVersion(QDataStream::Qt_5_0);
+
+   m_pTimer->setSingleShot(true);
+   m_pTimer->setTimerType(Qt::PreciseTimer);
+   connect(m_pTimer, &QTimer::timeout, this, &SignalReplayer::emitNext);
+}
+
+DBus::SignalReplayer::~SignalReplayer()
+{
+   clearPending();
+}
+
+/*****************************************************************************
+ *                                                                           *
+ *                                 Getters                                   *
+ *                                                                           *
+ ****************************************************************************/
+
+bool DBus::SignalReplayer::isRunning() const
+{
+   return m_pTimer->isActive();
+}
+
+///The report so far, final once finished() was emitted
+DBus::SignalReplayer::Report DBus::SignalReplayer::report() const
+{
+   Report ret = m_Report;
+
+   if (isRunning())
+      ret.peakMemory = peakMemory();
+
+   for (const Target& t : m_hTargets) {
+      if (t.count)
+         ret.statistics << Statistics { t.name, t.count, t.totalTime, t.maxTime };
+   }
+
+   std::sort(ret.statistics.begin(), ret.statistics.end(), [](const Statistics& a, const Statistics& b) {
+      return a.totalTime > b.totalTime;
+   });
+
+   return ret;
+}
+
+///The report, as text
+QByteArray DBus::SignalReplayer::summary() const
+{
+   const Report r = report();
+
+   QByteArray ret;
+
+   ret += "Replayed "+QByteArray::number(r.count)+" signals in "+toMs(r.duration)+" ms";
+   ret += r.speed == Speed::FASTEST ? " (fastest)" : " (realtime)";
+
+   if (r.skipped)
+      ret += ", "+QByteArray::number(r.skipped)+" skipped";
+
+   if (!r.complete)
+      ret += ", the recording is truncated";
+
+   ret += "\nModel updates: "+toMs(r.updateTime)+" ms total, "+toMs(r.maxUpdate)+" ms max\n";
+
+   if (r.speed == Speed::REALTIME)
+      ret += "Lateness: "+toMs(r.maxLateness)+" ms max\n";
+
+   ret += "Peak memory: "+QByteArray::number(r.peakMemory)+" kB ("
+      +QByteArray::number(r.startMemory)+" kB before the replay)\n";
+
+   foreach(const Statistics& s, r.statistics) {
+      ret += "   "+s.name.leftJustified(32)+QByteArray::number(s.count).rightJustified(8)
+         +toMs(s.totalTime).rightJustified(14)+" ms"+toMs(s.maxTime).rightJustified(12)+" ms max\n";
+   }
+
+   return ret;
+}
+
+/*****************************************************************************
+ *                                                                           *
+ *                                 Mutators                                  *
+ *                                                                           *
+ ****************************************************************************/
+
+///Open a recording, the previous replay is stopped
+bool DBus::SignalReplayer::open(const QString& path)
+{
+   stop();
+
+   m_File.close();
+   m_File.setFileName(path);
+   m_Stream.resetStatus();
+   m_hTargets.clear();
+   m_Report = Report();
+
+   if (!m_File.open(QIODevice::ReadOnly)) {
+      qWarning() << "Cannot open the signal recording" << path << m_File.errorString();
+      return false;
+   }
+
+   quint32 magic   = 0;
+   quint16 version = 0;
+   qint64  date    = 0;
+
+   m_Stream >> magic >> version >> date;
+
+   if (magic != SignalRecorder::MAGIC || version != SignalRecorder::VERSION) {
+      qWarning() << path << "is not a signal recording, or from an unsupported version";
+      m_File.close();
+      return false;
+   }
+
+   SignalRecorder::registerTypes();
+
+   return readNext();
+}
+
+///Start emitting the signals, finished() is emitted at the end
+void DBus::SignalReplayer::start(Speed speed)
+{
+   if (!m_HasPending || isRunning())
+      return;
+
+   m_Speed              = speed;
+   m_Start              = IpcTrace::now();
+   m_Offset             = m_Pending.time;
+   m_Report.speed       = speed;
+   m_Report.startMemory = peakMemory();
+
+   schedule();
+}
+
+void DBus::SignalReplayer::stop()
+{
+   if (isRunning())
+      finish();
+}
+
+/**
+ * Replay LRC_SIGNAL_REPLAY once the event loop is running, if it is set.
+ *
+ * This does nothing unless the library is built with the fake daemon, the
+ * replayed signals would otherwise be mixed with the real ones.
+ */
+void DBus::SignalReplayer::replayOnStart()
+{
+#ifdef ENABLE_FAKE_DAEMON
+   static bool init = false;
+
+   if (init || !QCoreApplication::instance())
+      return;
+
+   init = true;
+
+   const QString path = QString::fromLocal8Bit(qgetenv("LRC_SIGNAL_REPLAY"));
+
+   if (path.isEmpty())
+      return;
+
+   const Speed speed = qgetenv("LRC_SIGNAL_REPLAY_SPEED") == "fastest" ? Speed::FASTEST : Speed::REALTIME;
+
+   SignalReplayer* replayer = new SignalReplayer(QCoreApplication::instance());
+
+   if (!replayer->open(path)) {
+      delete replayer;
+      return;
+   }
+
+   connect(replayer, &SignalReplayer::finished, [replayer]() {
+      qDebug("%s", replayer->summary().constData());
+      replayer->deleteLater();
+   });
+
+   // Let the models connect first
+   QTimer::singleShot(0, replayer, [replayer, speed]() {
+      replayer->start(speed);
+   });
+#endif //ENABLE_FAKE_DAEMON
+}
+
+/*****************************************************************************
+ *                                                                           *
+ *                                 Helpers                                   *
+ *                                                                           *
+ ****************************************************************************/
+
+///Read up to the next emission and load its arguments
+bool DBus::SignalReplayer::readNext()
+{
+   clearPending();
+
+   while (!m_Stream.atEnd()) {
+      quint8  type = 0;
+      quint16 id   = 0;
+
+      m_Stream >> type >> id;
+
+      if (type == static_cast<quint8>(SignalRecorder::Record::DEFINE)) {
+         QByteArray        interface, name;
+         QList<QByteArray> types;
+
+         m_Stream >> interface >> name >> types;
+
+         if (m_Stream.status() != QDataStream::Ok || !define(id, interface, name, types))
+            break;
+
+         continue;
+      }
+
+      if (type != static_cast<quint8>(SignalRecorder::Record::EMISSION) || !m_hTargets.contains(id)) {
+         qWarning() << "Invalid record in the signal recording" << m_File.fileName();
+         break;
+      }
+
+      const Target& t = m_hTargets[id];
+
+      m_Pending.id = id;
+      m_Stream >> m_Pending.time;
+
+      foreach(const int type, t.types) {
+         void* value = QMetaType::create(type);
+         QMetaType::load(m_Stream, type, value);
+         m_Pending.arguments << value;
+      }
+
+      // A recording cut by a crash end with a partial record
+      if (m_Stream.status() != QDataStream::Ok)
+         break;
+
+      m_HasPending = true;
+
+      return true;
+   }
+
+   m_Report.complete = m_Stream.atEnd() && m_Stream.status() == QDataStream::Ok;
+
+   clearPending();
+
+   return false;
+}
+
+///Destroy the arguments of the pending signal
+void DBus::SignalReplayer::clearPending()
+{
+   if (!m_Pending.arguments.isEmpty()) {
+      const QVector<int>& types = m_hTargets[m_Pending.id].types;
+
+      for (int i = 0; i < m_Pending.arguments.size(); i++)
+         QMetaType::destroy(types[i], m_Pending.arguments[i]);
+
+      m_Pending.arguments.clear();
+   }
+
+   m_HasPending = false;
+}
+
+/**
+ * Find the signal of a DEFINE record in the current backend.
+ *
+ * @return false if the arguments cannot be read, a signal the interface
+ * doesn't have is only skipped.
+ */
+bool DBus::SignalReplayer::define(quint16 id, const QByteArray& interface, const QByteArray& name, const QList<QByteArray>& types)
+{
+   Target t { nullptr, -1, {}, name, 0, 0, 0 };
+
+   foreach(const QByteArray& type, types) {
+      const int metaType = QMetaType::type(type.constData());
+
+      if (metaType == QMetaType::UnknownType) {
+         qWarning() << "Cannot replay the signal" << name << "unknown type" << type;
+         return false;
+      }
+
+      t.types << metaType;
+   }
+
+   typedef QPair<QByteArray,QObject*> Interface;
+   foreach(const Interface& i, SignalRecorder::interfaces()) {
+      if (i.first != interface)
+         continue;
+
+      const QMetaObject* mo = i.second->metaObject();
+
+      for (int m = mo->methodOffset(); m < mo->methodCount() && !t.object; m++) {
+         const QMetaMethod method = mo->method(m);
+
+         if (method.methodType() != QMetaMethod::Signal || method.name() != name
+          || method.parameterCount() != t.types.size())
+            continue;
+
+         bool match = true;
+
+         for (int p = 0; p < t.types.size(); p++)
+            match &= method.parameterType(p) == t.types[p];
+
+         if (match) {
+            t.object = i.second;
+            t.index  = m;
+         }
+      }
+   }
+
+   if (!t.object)
+      qWarning() << "The signal" << interface+"::"+name << "doesn't exist in this backend, it will be skipped";
+
+   m_hTargets[id] = t;
+
+   return true;
+}
+
+///Wait until the pending signal is due
+void DBus::SignalReplayer::schedule()
+{
+   if (m_Speed == Speed::FASTEST) {
+      m_pTimer->start(0);
+      return;
+   }
+
+   const qint64 wait = m_Start + (m_Pending.time - m_Offset) - IpcTrace::now();
+
+   m_pTimer->start(wait > 0 ? static_cast<int>(wait / 1000000) : 0);
+}
+
+void DBus::SignalReplayer::finish()
+{
+   m_pTimer->stop();
+   clearPending();
+   m_File.close();
+
+   m_Report.peakMemory = peakMemory();
+
+   emit finished();
+}
+
+///Emit the pending signal, then read and schedule the next one
+void DBus::SignalReplayer::emitNext()
+{
+   if (!m_HasPending) {
+      finish();
+      return;
+   }
+
+   Target& t = m_hTargets[m_Pending.id];
+
+   const qint64 begin = IpcTrace::now();
+
+   if (m_Speed == Speed::REALTIME)
+      m_Report.maxLateness = qMax(m_Report.maxLateness, begin - m_Start - (m_Pending.time - m_Offset));
+
+   if (t.object) {
+      // The return value, then the arguments
+      QVector<void*> args(1, nullptr);
+      args += m_Pending.arguments;
+
+      QMetaObject::metacall(t.object, QMetaObject::InvokeMetaMethod, t.index, args.data());
+
+      const qint64 elapsed = IpcTrace::now() - begin;
+
+      t.count++;
+      t.totalTime += elapsed;
+      t.maxTime    = qMax(t.maxTime, elapsed);
+
+      m_Report.count++;
+      m_Report.updateTime += elapsed;
+      m_Report.maxUpdate   = qMax(m_Report.maxUpdate, elapsed);
+   }
+   else
+      m_Report.skipped++;
+
+   m_Report.duration = IpcTrace::now() - m_Start;
+
+   if (readNext())
+      schedule();
+   else
+      finish();
+}
@@ -0,0 +1,162 @@
+/****************************************************************************
+ *   Copyright (C) 2015 by Savoir-Faire Linux                               *
+ *   Author : Emmanuel Lepage Vallee <emmanuel.lepage@savoirfairelinux.com> *
+ *                                                                          *
+ *   This library is free software; you can redistribute it and/or          *
+ *   modify it under the terms of the GNU Lesser General Public             *
+ *   License as published by the Free Software Foundation; either           *
+ *   version 2.1 of the License, or (at your option) any later version.     *
+ *                                                                          *
+ *   This library is distributed in the hope that it will be useful,        *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU      *
+ *   Lesser General Public License for more details.                        *
+ *                                                                          *
+ *   You should have received a copy of the GNU General Public License      *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>.  *
+ ***************************************************************************/
+#ifndef DBUS_SIGNAL_REPLAYER_H
+#define DBUS_SIGNAL_REPLAYER_H
+
+#include <typedefs.h>
+
+//Qt
+#include <QtCore/QObject>
+#include <QtCore/QByteArray>
+#include <QtCore/QFile>
+#include <QtCore/QDataStream>
+#include <QtCore/QHash>
+#include <QtCore/QList>
+#include <QtCore/QVector>
+
+class QTimer;
+
+namespace DBus {
+
+/**
+ * Feed a SignalRecorder file back into the DBus::*Manager interfaces.
+ *
+ * The signals are emitted from the interfaces themselves, so the models
+ * can't tell them from the daemon ones. To measure the models alone, the
+ * replay is best done with the fake daemon (ENABLE_FAKE_DAEMON), as a real
+ * daemon would keep sending its own signals meanwhile.
+ *
+ * One signal is emitted per event loop iteration, so the work the models
+ * defer to the event loop is done in between, as with the daemon. In
+ * REALTIME, each signal is emitted at the time it was recorded, relative
+ * to the start of the replay. In FASTEST, they follow each other without
+ * waiting.
+ *
+ * The report contains the time spent in the emissions (the model updates
+ * done in the slots), per signal, the total duration and the peak memory
+ * usage of the process.
+ *
+ * With the fake daemon, if the LRC_SIGNAL_REPLAY environment variable is
+ * set, that file is replayed once the event loop start and the report is
+ * printed when it is done. LRC_SIGNAL_REPLAY_SPEED=fastest doesn't wait
+ * between signals. Other builds never read the environment, the replay
+ * has to be started explicitly.
+ */
+class LIB_EXPORT SignalReplayer : public QObject
+{
+   #pragma GCC diagnostic push
+   #pragma GCC diagnostic ignored "-Wzero-as-null-pointer-constant"
+   Q_OBJECT
+   #pragma GCC diagnostic pop
+public:
+   ///How the signals are paced
+   enum class Speed {
+      REALTIME, /*!< At the recorded timing (1x)  */
+      FASTEST , /*!< As fast as possible          */
+      COUNT__
+   };
+
+   ///The emissions of a signal
+   struct Statistics {
+      QByteArray name      ;
+      quint64    count     ;
+      qint64     totalTime ; /*!< Time spent in the slots, in ns */
+      qint64     maxTime   ; /*!< Slowest emission, in ns        */
+   };
+
+   ///The result of a replay
+   struct Report {
+      quint64           count        ; /*!< Emitted signals                        */
+      quint64           skipped      ; /*!< Signals the interfaces doesn't have    */
+      qint64            duration     ; /*!< From the start to the last signal, ns  */
+      qint64            updateTime   ; /*!< Time spent in the slots, in ns         */
+      qint64            maxUpdate    ; /*!< Slowest emission, in ns                */
+      qint64            maxLateness  ; /*!< REALTIME only, worst delay, in ns      */
+      qint64            startMemory  ; /*!< Peak resident set size before, in kB   */
+      qint64            peakMemory   ; /*!< Peak resident set size after, in kB    */
+      bool              complete     ; /*!< The file was read to the end           */
+      Speed             speed        ;
+      QList<Statistics> statistics   ;
+   };
+
+   //Constructor
+   explicit SignalReplayer(QObject* parent = nullptr);
+   virtual ~SignalReplayer();
+
+   //Getters
+   bool       isRunning() const;
+   Report     report   () const;
+   QByteArray summary  () const;
+
+   //Mutators
+   bool open (const QString& path);
+   void start(Speed speed = Speed::REALTIME);
+   void stop ();
+
+   //Helpers
+   static void replayOnStart();
+
+private:
+   ///A signal declared by a DEFINE record
+   struct Target {
+      QObject*     object   ; /*!< nullptr if the interface has no such signal */
+      int          index    ; /*!< Of the signal in the object meta object    */
+      QVector<int> types    ;
+      QByteArray   name     ;
+      quint64      count    ;
+      qint64       totalTime;
+      qint64       maxTime  ;
+   };
+
+   ///The next signal to emit, its arguments already loaded
+   struct Pending {
+      quint16         id       ;
+      qint64          time     ; /*!< Since the start of the recording, in ns */
+      QVector<void*>  arguments;
+   };
+
+   //Attributes
+   QFile                    m_File      ;
+   QDataStream              m_Stream    ;
+   QHash<quint16, Target>   m_hTargets  ;
+   Pending                  m_Pending   ;
+   bool                     m_HasPending;
+   Speed                    m_Speed     ;
+   QTimer*                  m_pTimer    ;
+   qint64                   m_Start     ; /*!< See DBus::IpcTrace::now() */
+   qint64                   m_Offset    ; /*!< Recorded time of the first signal */
+   Report                   m_Report    ;
+
+   //Helpers
+   bool readNext     ();
+   void clearPending ();
+   bool define       (quint16 id, const QByteArray& interface, const QByteArray& name, const QList<QByteArray>& types);
+   void schedule     ();
+   void finish       ();
+
+private Q_SLOTS:
+   void emitNext();
+
+Q_SIGNALS:
+   ///The whole file was replayed, or stop() was called
+   void finished();
+};
+
+}
+
+#endif
@@ -18,7 +18,9 @@
 #ifndef VIDEOMANAGER_H
 #define VIDEOMANAGER_H
 
-#ifdef ENABLE_LIBWRAP
+#ifdef ENABLE_FAKE_DAEMON
+ #include "../fakedaemon/videomanager_fake.h"
+#elif defined(ENABLE_LIBWRAP)
  #include "videomanager_wrap.h"
 #else
  #include "video_dbus_interface.h"
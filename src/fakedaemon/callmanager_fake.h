@@ -0,0 +1,321 @@
+/******************************************************************************
+ *   Copyright (C) 2015 by Savoir-Faire Linux                                 *
+ *   Author : Emmanuel Lepage Vallee <emmanuel.lepage@savoirfairelinux.com>   *
+ *                                                                            *
+ *   This library is free software; you can redistribute it and/or            *
+ *   modify it under the terms of the GNU Lesser General Public               *
+ *   License as published by the Free Software Foundation; either             *
+ *   version 2.1 of the License, or (at your option) any later version.       *
+ *                                                                            *
+ *   This library is distributed in the hope that it will be useful,          *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of           *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU        *
+ *   Lesser General Public License for more details.                          *
+ *                                                                            *
+ *   You should have received a copy of the Lesser GNU General Public License *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>.    *
+ *****************************************************************************/
+#ifndef CALLMANAGER_FAKE_INTERFACE_H
+#define CALLMANAGER_FAKE_INTERFACE_H
+
+#include <QtCore/QObject>
+#include <QtCore/QString>
+#include <QtCore/QStringList>
+
+#include "typedefs.h"
+#include "fakedaemon.h"
+
+//The methods return right away, as with the libwrap interfaces
+#ifndef Q_NOREPLY
+ #define Q_NOREPLY
+#endif
+
+/*
+ * Fake implementation of the interface cx.ring.Ring.CallManager
+ */
+class CallManagerInterface: public QObject
+{
+    Q_OBJECT
+
+public:
+    CallManagerInterface() {}
+    ~CallManagerInterface() {}
+
+public Q_SLOTS: // METHODS
+    bool accept(const QString &callID)
+    {
+        FAKE_DRING_CALL;
+        return FakeDaemon::instance()->accept(callID);
+    }
+
+    void acceptEnrollment(const QString &callID, bool accepted)
+    {
+        FAKE_DRING_CALL;
+        Q_UNUSED(callID)
+        Q_UNUSED(accepted)
+    }
+
+    bool addMainParticipant(const QString &confID)
+    {
+        FAKE_DRING_CALL;
+        return FakeDaemon::instance()->conferenceList().contains(confID);
+    }
+
+    bool addParticipant(const QString &callID, const QString &confID)
+    {
+        FAKE_DRING_CALL;
+        return FakeDaemon::instance()->addParticipant(callID, confID);
+    }
+
+    bool attendedTransfer(const QString &transferID, const QString &targetID)
+    {
+        FAKE_DRING_CALL;
+        return FakeDaemon::instance()->attendedTransfer(transferID, targetID);
+    }
+
+    void createConfFromParticipantList(const QStringList &participants)
+    {
+        FAKE_DRING_CALL;
+        FakeDaemon::instance()->createConference(participants);
+    }
+
+    bool detachParticipant(const QString &callID)
+    {
+        FAKE_DRING_CALL;
+        return FakeDaemon::instance()->detachParticipant(callID);
+    }
+
+    MapStringString getCallDetails(const QString &callID)
+    {
+        FAKE_DRING_CALL;
+        return FakeDaemon::instance()->callDetails(callID);
+    }
+
+    QStringList getCallList()
+    {
+        FAKE_DRING_CALL;
+        return FakeDaemon::instance()->callList();
+    }
+
+    MapStringString getConferenceDetails(const QString &callID)
+    {
+        FAKE_DRING_CALL;
+        return FakeDaemon::instance()->conferenceDetails(callID);
+    }
+
+    QString getConferenceId(const QString &callID)
+    {
+        FAKE_DRING_CALL;
+        return FakeDaemon::instance()->conferenceId(callID);
+    }
+
+    QStringList getConferenceList()
+    {
+        FAKE_DRING_CALL;
+        return FakeDaemon::instance()->conferenceList();
+    }
+
+    Q_DECL_DEPRECATED QString getCurrentAudioCodecName(const QString &callID)
+    {
+        FAKE_DRING_CALL;
+        Q_UNUSED(callID)
+        return QStringLiteral("PCMU");
+    }
+
+    QStringList getDisplayNames(const QString &confID)
+    {
+        FAKE_DRING_CALL;
+        QStringList ret;
+        for (const QString& callID : FakeDaemon::instance()->participantList(confID))
+            ret << FakeDaemon::instance()->callDetails(callID).value(QStringLiteral("DISPLAY_NAME"));
+        return ret;
+    }
+
+    bool getIsRecording(const QString &callID)
+    {
+        FAKE_DRING_CALL;
+        return FakeDaemon::instance()->isRecording(callID);
+    }
+
+    QStringList getParticipantList(const QString &confID)
+    {
+        FAKE_DRING_CALL;
+        return FakeDaemon::instance()->participantList(confID);
+    }
+
+    bool hangUp(const QString &callID)
+    {
+        FAKE_DRING_CALL;
+        return FakeDaemon::instance()->hangUp(callID);
+    }
+
+    bool hangUpConference(const QString &confID)
+    {
+        FAKE_DRING_CALL;
+        return FakeDaemon::instance()->hangUpConference(confID);
+    }
+
+    bool hold(const QString &callID)
+    {
+        FAKE_DRING_CALL;
+        return FakeDaemon::instance()->hold(callID);
+    }
+
+    bool holdConference(const QString &confID)
+    {
+        FAKE_DRING_CALL;
+        return FakeDaemon::instance()->holdConference(confID, true);
+    }
+
+    bool isConferenceParticipant(const QString &callID)
+    {
+        FAKE_DRING_CALL;
+        return !FakeDaemon::instance()->conferenceId(callID).isEmpty();
+    }
+
+    bool joinConference(const QString &sel_confID, const QString &drag_confID)
+    {
+        FAKE_DRING_CALL;
+        return FakeDaemon::instance()->joinConference(sel_confID, drag_confID);
+    }
+
+    bool joinParticipant(const QString &sel_callID, const QString &drag_callID)
+    {
+        FAKE_DRING_CALL;
+        return FakeDaemon::instance()->joinParticipant(sel_callID, drag_callID);
+    }
+
+    QString placeCall(const QString &accountID, const QString &to)
+    {
+        FAKE_DRING_CALL;
+        return FakeDaemon::instance()->placeCall(accountID, to);
+    }
+
+    void playDTMF(const QString &key)
+    {
+        FAKE_DRING_CALL;
+        Q_UNUSED(key)
+    }
+
+    void recordPlaybackSeek(double value)
+    {
+        FAKE_DRING_CALL;
+        Q_UNUSED(value)
+    }
+
+    bool refuse(const QString &callID)
+    {
+        FAKE_DRING_CALL;
+        return FakeDaemon::instance()->refuse(callID);
+    }
+
+    void requestGoClear(const QString &callID)
+    {
+        FAKE_DRING_CALL;
+        Q_UNUSED(callID)
+    }
+
+    void resetSASVerified(const QString &callID)
+    {
+        FAKE_DRING_CALL;
+        Q_UNUSED(callID)
+    }
+
+    void sendTextMessage(const QString &callID, const QString &message)
+    {
+        FAKE_DRING_CALL;
+        Q_UNUSED(callID)
+        Q_UNUSED(message)
+    }
+
+    void setConfirmGoClear(const QString &callID)
+    {
+        FAKE_DRING_CALL;
+        Q_UNUSED(callID)
+    }
+
+    void setSASVerified(const QString &callID)
+    {
+        FAKE_DRING_CALL;
+        Q_UNUSED(callID)
+    }
+
+    bool startRecordedFilePlayback(const QString &filepath)
+    {
+        FAKE_DRING_CALL;
+        Q_UNUSED(filepath)
+        return false;
+    }
+
+    void startTone(int start, int type)
+    {
+        FAKE_DRING_CALL;
+        Q_UNUSED(start)
+        Q_UNUSED(type)
+    }
+
+    void stopRecordedFilePlayback(const QString &filepath)
+    {
+        FAKE_DRING_CALL;
+        Q_UNUSED(filepath)
+    }
+
+    bool toggleRecording(const QString &callID)
+    {
+        FAKE_DRING_CALL;
+        return FakeDaemon::instance()->toggleRecording(callID);
+    }
+
+    bool transfer(const QString &callID, const QString &to)
+    {
+        FAKE_DRING_CALL;
+        return FakeDaemon::instance()->transfer(callID, to);
+    }
+
+    bool unhold(const QString &callID)
+    {
+        FAKE_DRING_CALL;
+        return FakeDaemon::instance()->unhold(callID);
+    }
+
+    bool unholdConference(const QString &confID)
+    {
+        FAKE_DRING_CALL;
+        return FakeDaemon::instance()->holdConference(confID, false);
+    }
+
+Q_SIGNALS: // SIGNALS
+    void callStateChanged(const QString &callID, const QString &state, int code);
+    void transferFailed();
+    void transferSucceeded();
+    void recordPlaybackStopped(const QString &filepath);
+    void voiceMailNotify(const QString &accountID, int count);
+    void incomingMessage(const QString &callID, const QString &from, const QString &message);
+    void incomingCall(const QString &accountID, const QString &callID, const QString &from);
+    void recordPlaybackFilepath(const QString &callID, const QString &filepath);
+    void conferenceCreated(const QString &confID);
+    void conferenceChanged(const QString &confID, const QString &state);
+    void updatePlaybackScale(const QString &filepath, int position, int size);
+    void conferenceRemoved(const QString &confID);
+    void newCallCreated(const QString &accountID, const QString &callID, const QString &to);
+    void recordingStateChanged(const QString &callID, bool recordingState);
+    void secureSdesOn(const QString &callID);
+    void secureSdesOff(const QString &callID);
+    void secureZrtpOn(const QString &callID, const QString &cipher);
+    void secureZrtpOff(const QString &callID);
+    void showSAS(const QString &callID, const QString &sas, bool verified);
+    void zrtpNotSuppOther(const QString &callID);
+    void zrtpNegotiationFailed(const QString &callID, const QString &reason, const QString &severity);
+    void onRtcpReportReceived(const QString &callID, MapStringInt report);
+    void confirmGoClear(const QString &callID);
+
+};
+
+namespace org {
+  namespace ring {
+    namespace Ring {
+      typedef ::CallManagerInterface CallManager;
+    }
+  }
+}
+#endif
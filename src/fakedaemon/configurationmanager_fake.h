@@ -0,0 +1,488 @@
+/******************************************************************************
+ *   Copyright (C) 2015 by Savoir-Faire Linux                                 *
+ *   Author : Emmanuel Lepage Vallee <emmanuel.lepage@savoirfairelinux.com>   *
+ *                                                                            *
+ *   This library is free software; you can redistribute it and/or            *
+ *   modify it under the terms of the GNU Lesser General Public               *
+ *   License as published by the Free Software Foundation; either             *
+ *   version 2.1 of the License, or (at your option) any later version.       *
+ *                                                                            *
+ *   This library is distributed in the hope that it will be useful,          *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of           *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU        *
+ *   Lesser General Public License for more details.                          *
+ *                                                                            *
+ *   You should have received a copy of the Lesser GNU General Public License *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>.    *
+ *****************************************************************************/
+#ifndef CONFIGURATIONMANAGER_FAKE_INTERFACE_H
+#define CONFIGURATIONMANAGER_FAKE_INTERFACE_H
+
+#include <QtCore/QObject>
+#include <QtCore/QByteArray>
+#include <QtCore/QString>
+#include <QtCore/QStringList>
+#include <QtCore/QVector>
+
+#include <account_const.h>
+
+#include "typedefs.h"
+#include "fakedaemon.h"
+
+/*
+ * Fake implementation of the interface cx.ring.Ring.ConfigurationManager
+ *
+ * The audio, hook and shortcut preferences are only stored, everything
+ * related to the accounts is handled by FakeDaemon.
+ */
+class ConfigurationManagerInterface: public QObject
+{
+    Q_OBJECT
+
+public:
+    ConfigurationManagerInterface() {}
+    ~ConfigurationManagerInterface() {}
+
+public Q_SLOTS: // METHODS
+    QString addAccount(MapStringString details)
+    {
+        FAKE_DRING_CALL;
+        return FakeDaemon::instance()->addAccount(details);
+    }
+
+    MapStringString getAccountDetails(const QString &accountID)
+    {
+        FAKE_DRING_CALL;
+        return FakeDaemon::instance()->accountDetails(accountID);
+    }
+
+    QStringList getAccountList()
+    {
+        FAKE_DRING_CALL;
+        return FakeDaemon::instance()->accountList();
+    }
+
+    MapStringString getAccountTemplate(const QString& accountType)
+    {
+        FAKE_DRING_CALL;
+        return FakeDaemon::instance()->accountTemplate(accountType);
+    }
+
+    VectorUInt getActiveCodecList(const QString &accountID)
+    {
+        FAKE_DRING_CALL;
+        Q_UNUSED(accountID)
+        return { 0, 1, 2, 3, 4, 5 };
+    }
+
+    QString getAddrFromInterfaceName(const QString &interface)
+    {
+        FAKE_DRING_CALL;
+        Q_UNUSED(interface)
+        return QStringLiteral("127.0.0.1");
+    }
+
+    QStringList getAllIpInterface()
+    {
+        FAKE_DRING_CALL;
+        return { QStringLiteral("127.0.0.1") };
+    }
+
+    QStringList getAllIpInterfaceByName()
+    {
+        FAKE_DRING_CALL;
+        return { QStringLiteral("default"), QStringLiteral("lo") };
+    }
+
+    MapStringString getCodecDetails(const QString accountID, int payload)
+    {
+        FAKE_DRING_CALL;
+        Q_UNUSED(accountID)
+        static const char* names[] = { "PCMU", "PCMA", "G722", "opus", "H264", "VP8" };
+        MapStringString temp;
+        if (payload < 0 || payload >= 6)
+            return temp;
+        temp[DRing::Account::ConfProperties::CodecInfo::NAME       ] = names[payload];
+        temp[DRing::Account::ConfProperties::CodecInfo::TYPE       ] = payload < 4 ? "AUDIO" : "VIDEO";
+        temp[DRing::Account::ConfProperties::CodecInfo::SAMPLE_RATE] = payload < 4 ? "8000" : "90000";
+        temp[DRing::Account::ConfProperties::CodecInfo::BITRATE    ] = payload < 4 ? "64" : "800";
+        return temp;
+    }
+
+    VectorUInt getCodecList()
+    {
+        FAKE_DRING_CALL;
+        return { 0, 1, 2, 3, 4, 5 };
+    }
+
+    int getAudioInputDeviceIndex(const QString &devname)
+    {
+        FAKE_DRING_CALL;
+        return devname == QLatin1String("Fake microphone") ? 0 : -1;
+    }
+
+    QStringList getAudioInputDeviceList()
+    {
+        FAKE_DRING_CALL;
+        return { QStringLiteral("Fake microphone") };
+    }
+
+    QString getAudioManager()
+    {
+        FAKE_DRING_CALL;
+        return FakeDaemon::instance()->setting("audioManager", "fake").toString();
+    }
+
+    int getAudioOutputDeviceIndex(const QString &devname)
+    {
+        FAKE_DRING_CALL;
+        return devname == QLatin1String("Fake speaker") ? 0 : -1;
+    }
+
+    QStringList getAudioOutputDeviceList()
+    {
+        FAKE_DRING_CALL;
+        return { QStringLiteral("Fake speaker") };
+    }
+
+    QStringList getAudioPluginList()
+    {
+        FAKE_DRING_CALL;
+        return { QStringLiteral("default") };
+    }
+
+    VectorMapStringString getCredentials(const QString &accountID)
+    {
+        FAKE_DRING_CALL;
+        return FakeDaemon::instance()->credentials(accountID);
+    }
+
+    QStringList getCurrentAudioDevicesIndex()
+    {
+        FAKE_DRING_CALL;
+        return {
+            FakeDaemon::instance()->setting("audioOutput"  , 0).toString(),
+            FakeDaemon::instance()->setting("audioInput"   , 0).toString(),
+            FakeDaemon::instance()->setting("audioRingtone", 0).toString(),
+        };
+    }
+
+    QString getCurrentAudioOutputPlugin()
+    {
+        FAKE_DRING_CALL;
+        return FakeDaemon::instance()->setting("audioPlugin", "default").toString();
+    }
+
+    int getHistoryLimit()
+    {
+        FAKE_DRING_CALL;
+        return FakeDaemon::instance()->setting("historyLimit", 30).toInt();
+    }
+
+    MapStringString getHookSettings()
+    {
+        FAKE_DRING_CALL;
+        return FakeDaemon::instance()->setting("hookSettings").value<MapStringString>();
+    }
+
+    MapStringString getIp2IpDetails()
+    {
+        FAKE_DRING_CALL;
+        return FakeDaemon::instance()->accountDetails(DRing::Account::ProtocolNames::IP2IP);
+    }
+
+    bool getIsAlwaysRecording()
+    {
+        FAKE_DRING_CALL;
+        return FakeDaemon::instance()->setting("alwaysRecording", false).toBool();
+    }
+
+    bool getNoiseSuppressState()
+    {
+        FAKE_DRING_CALL;
+        return FakeDaemon::instance()->setting("noiseSuppress", false).toBool();
+    }
+
+    QString getRecordPath()
+    {
+        FAKE_DRING_CALL;
+        return FakeDaemon::instance()->setting("recordPath").toString();
+    }
+
+    QStringList getSupportedAudioManagers()
+    {
+        FAKE_DRING_CALL;
+        return { QStringLiteral("fake") };
+    }
+
+    MapStringString getShortcuts()
+    {
+        FAKE_DRING_CALL;
+        return FakeDaemon::instance()->setting("shortcuts").value<MapStringString>();
+    }
+
+    QStringList getSupportedTlsMethod()
+    {
+        FAKE_DRING_CALL;
+        return { QStringLiteral("Default"), QStringLiteral("TLSv1.2") };
+    }
+
+    MapStringString getTlsSettings()
+    {
+        FAKE_DRING_CALL;
+        return FakeDaemon::instance()->setting("tlsSettings").value<MapStringString>();
+    }
+
+    MapStringString validateCertificate(const QString& unused, const QString certificate, const QString& privateKey)
+    {
+        FAKE_DRING_CALL;
+        Q_UNUSED(unused)
+        Q_UNUSED(certificate)
+        Q_UNUSED(privateKey)
+        return MapStringString();
+    }
+
+    MapStringString validateCertificateRaw(const QString& unused, const QByteArray& content)
+    {
+        FAKE_DRING_CALL;
+        Q_UNUSED(unused)
+        Q_UNUSED(content)
+        return MapStringString();
+    }
+
+    MapStringString getCertificateDetails(const QString &certificate)
+    {
+        FAKE_DRING_CALL;
+        Q_UNUSED(certificate)
+        return MapStringString();
+    }
+
+    MapStringString getCertificateDetailsRaw(const QByteArray &content)
+    {
+        FAKE_DRING_CALL;
+        Q_UNUSED(content)
+        return MapStringString();
+    }
+
+    QStringList getSupportedCiphers(const QString &accountID)
+    {
+        FAKE_DRING_CALL;
+        Q_UNUSED(accountID)
+        return QStringList();
+    }
+
+    MapStringString getTlsDefaultSettings()
+    {
+        FAKE_DRING_CALL;
+        return MapStringString();
+    }
+
+    double getVolume(const QString &device)
+    {
+        FAKE_DRING_CALL;
+        return FakeDaemon::instance()->setting("volume:"+device, 1.0).toDouble();
+    }
+
+    bool isAgcEnabled()
+    {
+        FAKE_DRING_CALL;
+        return FakeDaemon::instance()->setting("agc", false).toBool();
+    }
+
+    bool isCaptureMuted()
+    {
+        FAKE_DRING_CALL;
+        return FakeDaemon::instance()->setting("captureMuted", false).toBool();
+    }
+
+    bool isDtmfMuted()
+    {
+        FAKE_DRING_CALL;
+        return FakeDaemon::instance()->setting("dtmfMuted", false).toBool();
+    }
+
+    int isIax2Enabled()
+    {
+        FAKE_DRING_CALL;
+        return true;
+    }
+
+    bool isPlaybackMuted()
+    {
+        FAKE_DRING_CALL;
+        return FakeDaemon::instance()->setting("playbackMuted", false).toBool();
+    }
+
+    void muteCapture(bool mute)
+    {
+        FAKE_DRING_CALL;
+        FakeDaemon::instance()->setSetting("captureMuted", mute);
+    }
+
+    void muteDtmf(bool mute)
+    {
+        FAKE_DRING_CALL;
+        FakeDaemon::instance()->setSetting("dtmfMuted", mute);
+    }
+
+    void mutePlayback(bool mute)
+    {
+        FAKE_DRING_CALL;
+        FakeDaemon::instance()->setSetting("playbackMuted", mute);
+    }
+
+    void registerAllAccounts()
+    {
+        FAKE_DRING_CALL;
+        FakeDaemon::instance()->registerAllAccounts();
+    }
+
+    void removeAccount(const QString &accountID)
+    {
+        FAKE_DRING_CALL;
+        FakeDaemon::instance()->removeAccount(accountID);
+    }
+
+    void sendRegister(const QString &accountID, bool enable)
+    {
+        FAKE_DRING_CALL;
+        FakeDaemon::instance()->sendRegister(accountID, enable);
+    }
+
+    void setAccountDetails(const QString &accountID, MapStringString details)
+    {
+        FAKE_DRING_CALL;
+        FakeDaemon::instance()->setAccountDetails(accountID, details);
+    }
+
+    void setAccountsOrder(const QString &order)
+    {
+        FAKE_DRING_CALL;
+        FakeDaemon::instance()->setAccountsOrder(order);
+    }
+
+    void setActiveCodecList(const QString &accountID, VectorUInt &list)
+    {
+        FAKE_DRING_CALL;
+        Q_UNUSED(accountID)
+        Q_UNUSED(list)
+    }
+
+    void setAgcState(bool enabled)
+    {
+        FAKE_DRING_CALL;
+        FakeDaemon::instance()->setSetting("agc", enabled);
+    }
+
+    void setAudioInputDevice(int index)
+    {
+        FAKE_DRING_CALL;
+        FakeDaemon::instance()->setSetting("audioInput", index);
+    }
+
+    bool setAudioManager(const QString &api)
+    {
+        FAKE_DRING_CALL;
+        FakeDaemon::instance()->setSetting("audioManager", api);
+        return true;
+    }
+
+    void setAudioOutputDevice(int index)
+    {
+        FAKE_DRING_CALL;
+        FakeDaemon::instance()->setSetting("audioOutput", index);
+    }
+
+    void setAudioPlugin(const QString &audioPlugin)
+    {
+        FAKE_DRING_CALL;
+        FakeDaemon::instance()->setSetting("audioPlugin", audioPlugin);
+    }
+
+    void setAudioRingtoneDevice(int index)
+    {
+        FAKE_DRING_CALL;
+        FakeDaemon::instance()->setSetting("audioRingtone", index);
+    }
+
+    void setCredentials(const QString &accountID, VectorMapStringString credentialInformation)
+    {
+        FAKE_DRING_CALL;
+        FakeDaemon::instance()->setCredentials(accountID, credentialInformation);
+    }
+
+    void setHistoryLimit(int days)
+    {
+        FAKE_DRING_CALL;
+        FakeDaemon::instance()->setSetting("historyLimit", days);
+    }
+
+    void setHookSettings(MapStringString settings)
+    {
+        FAKE_DRING_CALL;
+        FakeDaemon::instance()->setSetting("hookSettings", QVariant::fromValue(settings));
+    }
+
+    void setIsAlwaysRecording(bool enabled)
+    {
+        FAKE_DRING_CALL;
+        FakeDaemon::instance()->setSetting("alwaysRecording", enabled);
+    }
+
+    void setNoiseSuppressState(bool state)
+    {
+        FAKE_DRING_CALL;
+        FakeDaemon::instance()->setSetting("noiseSuppress", state);
+    }
+
+    void setRecordPath(const QString &rec)
+    {
+        FAKE_DRING_CALL;
+        FakeDaemon::instance()->setSetting("recordPath", rec);
+    }
+
+    void setShortcuts(MapStringString shortcutsMap)
+    {
+        FAKE_DRING_CALL;
+        FakeDaemon::instance()->setSetting("shortcuts", QVariant::fromValue(shortcutsMap));
+    }
+
+    void setTlsSettings(MapStringString details)
+    {
+        FAKE_DRING_CALL;
+        FakeDaemon::instance()->setSetting("tlsSettings", QVariant::fromValue(details));
+    }
+
+    void setVolume(const QString &device, double value)
+    {
+        FAKE_DRING_CALL;
+        FakeDaemon::instance()->setSetting("volume:"+device, value);
+        Q_EMIT volumeChanged(device, value);
+    }
+
+    MapStringString getVolatileAccountDetails(const QString &accountID)
+    {
+        FAKE_DRING_CALL;
+        return FakeDaemon::instance()->volatileAccountDetails(accountID);
+    }
+
+Q_SIGNALS: // SIGNALS
+    void volumeChanged(const QString &device, double value);
+    void accountsChanged();
+    void historyChanged();
+    void stunStatusFailure(const QString &reason);
+    void registrationStateChanged(const QString& accountID, const QString& registration_state, unsigned detail_code, const QString& detail_str);
+    void stunStatusSuccess(const QString &message);
+    void errorAlert(int code);
+    void volatileAccountDetailsChanged(const QString &accountID, MapStringString details);
+
+};
+
+namespace org {
+  namespace ring {
+    namespace Ring {
+      typedef ::ConfigurationManagerInterface ConfigurationManager;
+    }
+  }
+}
+#endif
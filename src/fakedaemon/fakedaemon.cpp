@@ -0,0 +1,1220 @@
+/****************************************************************************
+ *   Copyright (C) 2015 by Savoir-Faire Linux                               *
+ *   Author : Emmanuel Lepage Vallee <emmanuel.lepage@savoirfairelinux.com> *
+ *                                                                          *
+ *   This library is free software; you can redistribute it and/or          *
+ *   modify it under the terms of the GNU Lesser General Public             *
+ *   License as published by the Free Software Foundation; either           *
+ *   version 2.1 of the License, or (at your option) any later version.     *
+ *                                                                          *
+ *   This library is distributed in the hope that it will be useful,        *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU      *
+ *   Lesser General Public License for more details.                        *
+ *                                                                          *
+ *   You should have received a copy of the GNU General Public License      *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>.  *
+ ***************************************************************************/
+#include "fakedaemon.h"
+
+//Qt
+#include <QtCore/QCoreApplication>
+#include <QtCore/QDateTime>
+#include <QtCore/QThread>
+#include <QtCore/QTimer>
+
+//STD
+#include <cstring>
+
+//Ring
+#include <account_const.h>
+#include "dbus/callmanager.h"
+#include "dbus/configurationmanager.h"
+#include "dbus/presencemanager.h"
+#include "dbus/videomanager.h"
+#include "private/call_p.h"
+
+FakeDaemon* FakeDaemon::m_spInstance = nullptr;
+
+/* Implementation note: signal delivery
+ * The events are queued with the time they were emitted and a closure
+ * which update the state and emit the signal, then delivered in order
+ * from the event loop, each inside a DBus::IpcTrace::Scope. Like with the
+ * daemon, a slot calling back into FakeDaemon see the state as of the
+ * signal being delivered, not as of the end of the burst.
+ *
+ * The methods may be called from the DBus::AsyncQuery worker, everything
+ * is guarded by a recursive mutex. It is released before emitting, so a
+ * slow slot never hold the other threads.
+ */
+
+namespace {
+
+constexpr static const char PREVIEW_ID [] = "local"      ; /*!< See VideoRendererManager */
+constexpr static const char CAMERA_NAME[] = "Fake camera";
+constexpr static const char FAKE_HOST  [] = "fake.invalid";
+
+///A SIP uri for the nth synthetic peer
+QString peerUri(uint n)
+{
+   return QString("%1@%2").arg(1000 + n).arg(FAKE_HOST);
+}
+
+}
+
+/*****************************************************************************
+ *                                                                           *
+ *                               Constructor                                 *
+ *                                                                           *
+ ****************************************************************************/
+
+FakeDaemon::FakeDaemon() : QObject(nullptr), m_Scheduled(false), m_Latency(0), m_Counter(0),
+m_pFrameTimer(new QTimer(this)), m_FrameCount(0), m_Mutex(QMutex::Recursive)
+{
+   // The first call may come from the AsyncQuery worker
+   if (QCoreApplication::instance() && thread() != QCoreApplication::instance()->thread())
+      moveToThread(QCoreApplication::instance()->thread());
+
+   // The daemon always has an IP2IP account
+   MapStringString ip2ip = accountTemplate(DRing::Account::ProtocolNames::SIP);
+   ip2ip[DRing::Account::ConfProperties::ALIAS] = DRing::Account::ProtocolNames::IP2IP;
+   createAccount(ip2ip, DRing::Account::ProtocolNames::IP2IP);
+   m_hVolatile[DRing::Account::ProtocolNames::IP2IP][DRing::Account::VolatileProperties::Registration::STATUS]
+      = DRing::Account::States::READY;
+
+   // A single camera
+   m_hDevices[CAMERA_NAME] = {
+      { "name"   , CAMERA_NAME },
+      { "channel", "Camera"    },
+      { "size"   , "640x480"   },
+      { "rate"   , "30"        },
+   };
+   m_DefaultDevice = CAMERA_NAME;
+
+   m_pFrameTimer->setInterval(33);
+   connect(m_pFrameTimer, &QTimer::timeout, this, &FakeDaemon::pushFrame);
+}
+
+FakeDaemon::~FakeDaemon()
+{
+}
+
+FakeDaemon* FakeDaemon::instance()
+{
+   if (!m_spInstance)
+      m_spInstance = new FakeDaemon();
+
+   return m_spInstance;
+}
+
+/*****************************************************************************
+ *                                                                           *
+ *                                 Getters                                   *
+ *                                                                           *
+ ****************************************************************************/
+
+int FakeDaemon::latency() const
+{
+   return m_Latency;
+}
+
+///The signals not delivered yet
+int FakeDaemon::pendingEvents() const
+{
+   QMutexLocker lk(&m_Mutex);
+   return m_lEvents.size();
+}
+
+QVariant FakeDaemon::setting(const QString& key, const QVariant& defaultValue) const
+{
+   QMutexLocker lk(&m_Mutex);
+   return m_hSettings.value(key, defaultValue);
+}
+
+/*****************************************************************************
+ *                                                                           *
+ *                                 Setters                                   *
+ *                                                                           *
+ ****************************************************************************/
+
+///Make every method call block for that long, to mimic the IPC round-trip
+void FakeDaemon::setLatency(int usec)
+{
+   m_Latency = usec;
+}
+
+void FakeDaemon::setSetting(const QString& key, const QVariant& value)
+{
+   QMutexLocker lk(&m_Mutex);
+   m_hSettings[key] = value;
+}
+
+/*****************************************************************************
+ *                                                                           *
+ *                             Load generators                               *
+ *                                                                           *
+ ****************************************************************************/
+
+///Add accounts, notified with a single accountsChanged, then register them
+void FakeDaemon::populateAccounts(int count, const QString& protocol)
+{
+   const QString type = protocol.isEmpty() ? QString(DRing::Account::ProtocolNames::SIP) : protocol;
+
+   QMutexLocker lk(&m_Mutex);
+
+   QStringList ids;
+   ids.reserve(count);
+
+   for (int i = 0; i < count; i++) {
+      MapStringString details = accountTemplate(type);
+      const QString   n       = QString::number(m_hAccounts.size());
+
+      details[DRing::Account::ConfProperties::ALIAS   ] = "Fake account "+n;
+      details[DRing::Account::ConfProperties::USERNAME] = "user"+n;
+      details[DRing::Account::ConfProperties::HOSTNAME] = FAKE_HOST;
+      details[DRing::Account::ConfProperties::Presence::ENABLED] = "true";
+
+      ids << createAccount(details);
+   }
+
+   post("accountsChanged", []() {
+      Q_EMIT DBus::ConfigurationManager::instance().accountsChanged();
+   });
+
+   foreach(const QString& id, ids)
+      sendRegister(id, true);
+}
+
+///Subscribe to buddies, spread across the accounts, a third of them offline
+void FakeDaemon::populateBuddies(int count)
+{
+   for (int i = 0; i < count; i++) {
+      const QString accountId = accountFor(i);
+      const QString uri       = peerUri(i);
+      const bool    status    = i % 3;
+
+      post("newBuddyNotification", [this, accountId, uri, status]() {
+         {
+            QMutexLocker lk(&m_Mutex);
+
+            if (!m_hAccounts.contains(accountId))
+               return;
+
+            m_hSubscriptions[accountId][uri] = status;
+         }
+
+         Q_EMIT DBus::PresenceManager::instance().newBuddyNotification(
+            accountId, uri, status, status ? "Available" : QString()
+         );
+      });
+   }
+}
+
+/**
+ * Run calls to completion, each end up in the history.
+ *
+ * Half of them are incoming, a quarter are missed. The peers repeat, so
+ * the phone directory get both new and known numbers.
+ */
+void FakeDaemon::populateHistory(int count)
+{
+   const int peers = qMax(1, count / 3);
+
+   for (int i = 0; i < count; i++) {
+      const QString callId = createCall(accountFor(i), peerUri(i % peers), i % 2);
+
+      if (i % 4)
+         setCallState(callId, CallPrivate::StateChange::CURRENT);
+
+      setCallState(callId, CallPrivate::StateChange::HUNG_UP);
+   }
+}
+
+///Ring the client, the calls stay incoming until answered or hung up
+void FakeDaemon::incomingCallBurst(int count, int interval)
+{
+   repeat(count, interval, [this](int i) {
+      createCall(accountFor(i), peerUri(i), true);
+   });
+}
+
+///Lose and recover the registration of the accounts, in turn
+void FakeDaemon::registrationFlaps(int count, int interval)
+{
+   repeat(count, interval, [this](int i) {
+      const QString accountId = accountFor(i);
+
+      setRegistration(accountId, DRing::Account::States::ERROR_NETWORK, 503, "Service Unavailable");
+      setRegistration(accountId, DRing::Account::States::TRYING       , 0  , QString()            );
+      setRegistration(accountId, DRing::Account::States::REGISTERED   , 200, "OK"                 );
+   });
+}
+
+void FakeDaemon::hangUpAll()
+{
+   foreach(const QString& callId, callList())
+      hangUp(callId);
+}
+
+/*****************************************************************************
+ *                                                                           *
+ *                                 Accounts                                  *
+ *                                                                           *
+ ****************************************************************************/
+
+QStringList FakeDaemon::accountList() const
+{
+   QMutexLocker lk(&m_Mutex);
+   return m_lAccountOrder;
+}
+
+MapStringString FakeDaemon::accountDetails(const QString& accountId) const
+{
+   QMutexLocker lk(&m_Mutex);
+   return m_hAccounts.value(accountId);
+}
+
+MapStringString FakeDaemon::volatileAccountDetails(const QString& accountId) const
+{
+   QMutexLocker lk(&m_Mutex);
+   return m_hVolatile.value(accountId);
+}
+
+MapStringString FakeDaemon::accountTemplate(const QString& type) const
+{
+   return {
+      { DRing::Account::ConfProperties::TYPE                     , type       },
+      { DRing::Account::ConfProperties::ALIAS                    , ""         },
+      { DRing::Account::ConfProperties::ENABLED                  , "true"     },
+      { DRing::Account::ConfProperties::HOSTNAME                 , ""         },
+      { DRing::Account::ConfProperties::USERNAME                 , ""         },
+      { DRing::Account::ConfProperties::PASSWORD                 , ""         },
+      { DRing::Account::ConfProperties::MAILBOX                  , ""         },
+      { DRing::Account::ConfProperties::AUTOANSWER               , "false"    },
+      { DRing::Account::ConfProperties::DTMF_TYPE                , "overrtp"  },
+      { DRing::Account::ConfProperties::LOCAL_INTERFACE          , "default"  },
+      { DRing::Account::ConfProperties::LOCAL_PORT               , "5060"     },
+      { DRing::Account::ConfProperties::PUBLISHED_SAMEAS_LOCAL   , "true"     },
+      { DRing::Account::ConfProperties::UPNP_ENABLED             , "false"    },
+      { DRing::Account::ConfProperties::Registration::EXPIRE     , "3600"     },
+      { DRing::Account::ConfProperties::Presence::ENABLED        , "false"    },
+      { DRing::Account::ConfProperties::Presence::SUPPORT_PUBLISH, "true"     },
+      { DRing::Account::ConfProperties::Presence::SUPPORT_SUBSCRIBE, "true"   },
+      { DRing::Account::ConfProperties::Video::ENABLED           , "true"     },
+      { DRing::Account::ConfProperties::Ringtone::ENABLED        , "false"    },
+      { DRing::Account::ConfProperties::STUN::ENABLED            , "false"    },
+      { DRing::Account::ConfProperties::SRTP::ENABLED            , "false"    },
+      { DRing::Account::ConfProperties::TLS::ENABLED             , "false"    },
+   };
+}
+
+VectorMapStringString FakeDaemon::credentials(const QString& accountId) const
+{
+   QMutexLocker lk(&m_Mutex);
+   return m_hCredentials.value(accountId);
+}
+
+QString FakeDaemon::addAccount(const MapStringString& details)
+{
+   QMutexLocker lk(&m_Mutex);
+
+   const QString id = createAccount(details);
+
+   post("accountsChanged", []() {
+      Q_EMIT DBus::ConfigurationManager::instance().accountsChanged();
+   });
+
+   sendRegister(id, true);
+
+   return id;
+}
+
+void FakeDaemon::setAccountDetails(const QString& accountId, const MapStringString& details)
+{
+   QMutexLocker lk(&m_Mutex);
+
+   if (!m_hAccounts.contains(accountId))
+      return;
+
+   MapStringString& current = m_hAccounts[accountId];
+
+   for (auto i = details.constBegin(); i != details.constEnd(); ++i)
+      current[i.key()] = i.value();
+
+   post("accountsChanged", []() {
+      Q_EMIT DBus::ConfigurationManager::instance().accountsChanged();
+   });
+
+   sendRegister(accountId, true);
+}
+
+void FakeDaemon::setCredentials(const QString& accountId, const VectorMapStringString& credentials)
+{
+   QMutexLocker lk(&m_Mutex);
+
+   if (m_hAccounts.contains(accountId))
+      m_hCredentials[accountId] = credentials;
+}
+
+void FakeDaemon::removeAccount(const QString& accountId)
+{
+   QMutexLocker lk(&m_Mutex);
+
+   if (accountId == DRing::Account::ProtocolNames::IP2IP || !m_hAccounts.contains(accountId))
+      return;
+
+   m_hAccounts     .remove   (accountId);
+   m_hVolatile     .remove   (accountId);
+   m_hCredentials  .remove   (accountId);
+   m_hSubscriptions.remove   (accountId);
+   m_lAccountOrder .removeAll(accountId);
+
+   post("accountsChanged", []() {
+      Q_EMIT DBus::ConfigurationManager::instance().accountsChanged();
+   });
+}
+
+///The ids, separated by '/', the unlisted accounts keep their relative order
+void FakeDaemon::setAccountsOrder(const QString& order)
+{
+   QMutexLocker lk(&m_Mutex);
+
+   QStringList ordered;
+
+   foreach(const QString& id, order.split('/', QString::SkipEmptyParts)) {
+      if (m_hAccounts.contains(id) && !ordered.contains(id))
+         ordered << id;
+   }
+
+   foreach(const QString& id, m_lAccountOrder) {
+      if (!ordered.contains(id))
+         ordered << id;
+   }
+
+   m_lAccountOrder = ordered;
+
+   post("accountsChanged", []() {
+      Q_EMIT DBus::ConfigurationManager::instance().accountsChanged();
+   });
+}
+
+void FakeDaemon::sendRegister(const QString& accountId, bool enable)
+{
+   QMutexLocker lk(&m_Mutex);
+
+   if (accountId == DRing::Account::ProtocolNames::IP2IP || !m_hAccounts.contains(accountId))
+      return;
+
+   const bool enabled = m_hAccounts[accountId][DRing::Account::ConfProperties::ENABLED] == "true";
+
+   if (enable && enabled) {
+      setRegistration(accountId, DRing::Account::States::TRYING    , 0  , QString());
+      setRegistration(accountId, DRing::Account::States::REGISTERED, 200, "OK"     );
+   }
+   else
+      setRegistration(accountId, DRing::Account::States::UNREGISTERED, 0, QString());
+}
+
+void FakeDaemon::registerAllAccounts()
+{
+   foreach(const QString& id, accountList())
+      sendRegister(id, true);
+}
+
+/*****************************************************************************
+ *                                                                           *
+ *                                  Calls                                    *
+ *                                                                           *
+ ****************************************************************************/
+
+QStringList FakeDaemon::callList() const
+{
+   QMutexLocker lk(&m_Mutex);
+   return m_hCalls.keys();
+}
+
+MapStringString FakeDaemon::callDetails(const QString& callId) const
+{
+   QMutexLocker lk(&m_Mutex);
+   return m_hCalls.value(callId);
+}
+
+bool FakeDaemon::isRecording(const QString& callId) const
+{
+   QMutexLocker lk(&m_Mutex);
+   return m_lRecording.contains(callId);
+}
+
+///The peer answer right away
+QString FakeDaemon::placeCall(const QString& accountId, const QString& to)
+{
+   QMutexLocker lk(&m_Mutex);
+
+   const QString account = accountId.isEmpty() ? accountFor(0) : accountId;
+
+   if (!m_hAccounts.contains(account))
+      return QString();
+
+   const QString callId = createCall(account, to, false);
+
+   setCallState(callId, CallPrivate::StateChange::RINGING);
+   setCallState(callId, CallPrivate::StateChange::CURRENT);
+
+   return callId;
+}
+
+bool FakeDaemon::accept(const QString& callId)
+{
+   QMutexLocker lk(&m_Mutex);
+
+   if (m_hCalls.value(callId)[CallPrivate::DetailsMapFields::STATE] != CallPrivate::DaemonStateInit::INCOMING)
+      return false;
+
+   setCallState(callId, CallPrivate::StateChange::CURRENT);
+
+   return true;
+}
+
+bool FakeDaemon::refuse(const QString& callId)
+{
+   return hangUp(callId);
+}
+
+bool FakeDaemon::hangUp(const QString& callId)
+{
+   QMutexLocker lk(&m_Mutex);
+
+   if (!m_hCalls.contains(callId))
+      return false;
+
+   setCallState(callId, CallPrivate::StateChange::HUNG_UP);
+
+   return true;
+}
+
+bool FakeDaemon::hold(const QString& callId)
+{
+   QMutexLocker lk(&m_Mutex);
+
+   if (!m_hCalls.contains(callId))
+      return false;
+
+   setCallState(callId, CallPrivate::StateChange::HOLD);
+
+   return true;
+}
+
+bool FakeDaemon::unhold(const QString& callId)
+{
+   QMutexLocker lk(&m_Mutex);
+
+   if (!m_hCalls.contains(callId))
+      return false;
+
+   setCallState(callId, CallPrivate::StateChange::UNHOLD_CURRENT);
+
+   return true;
+}
+
+bool FakeDaemon::transfer(const QString& callId, const QString& to)
+{
+   Q_UNUSED(to)
+
+   QMutexLocker lk(&m_Mutex);
+
+   if (!m_hCalls.contains(callId))
+      return false;
+
+   post("transferSucceeded", []() {
+      Q_EMIT DBus::CallManager::instance().transferSucceeded();
+   });
+
+   setCallState(callId, CallPrivate::StateChange::HUNG_UP);
+
+   return true;
+}
+
+bool FakeDaemon::attendedTransfer(const QString& transferId, const QString& targetId)
+{
+   QMutexLocker lk(&m_Mutex);
+
+   if (!(m_hCalls.contains(transferId) && m_hCalls.contains(targetId)))
+      return false;
+
+   post("transferSucceeded", []() {
+      Q_EMIT DBus::CallManager::instance().transferSucceeded();
+   });
+
+   setCallState(transferId, CallPrivate::StateChange::HUNG_UP);
+   setCallState(targetId  , CallPrivate::StateChange::HUNG_UP);
+
+   return true;
+}
+
+///Return the new recording state
+bool FakeDaemon::toggleRecording(const QString& callId)
+{
+   QMutexLocker lk(&m_Mutex);
+
+   if (!(m_hCalls.contains(callId) || m_hConferences.contains(callId)))
+      return false;
+
+   const bool recording = !m_lRecording.contains(callId);
+
+   if (recording)
+      m_lRecording.insert(callId);
+   else
+      m_lRecording.remove(callId);
+
+   post("recordingStateChanged", [callId, recording]() {
+      Q_EMIT DBus::CallManager::instance().recordingStateChanged(callId, recording);
+   });
+
+   return recording;
+}
+
+/*****************************************************************************
+ *                                                                           *
+ *                               Conferences                                 *
+ *                                                                           *
+ ****************************************************************************/
+
+QStringList FakeDaemon::conferenceList() const
+{
+   QMutexLocker lk(&m_Mutex);
+   return m_hConferences.keys();
+}
+
+QStringList FakeDaemon::participantList(const QString& confId) const
+{
+   QMutexLocker lk(&m_Mutex);
+   return m_hConferences.value(confId);
+}
+
+MapStringString FakeDaemon::conferenceDetails(const QString& confId) const
+{
+   QMutexLocker lk(&m_Mutex);
+
+   if (!m_hConferences.contains(confId))
+      return MapStringString();
+
+   MapStringString ret;
+   ret[CallPrivate::ConfDetailsMapFields::CONFID    ] = confId;
+   ret[CallPrivate::ConfDetailsMapFields::CONF_STATE] = m_lHeldConfs.contains(confId) ?
+      CallPrivate::ConferenceStateChange::HOLD : CallPrivate::ConferenceStateChange::ACTIVE;
+
+   return ret;
+}
+
+QString FakeDaemon::conferenceId(const QString& callId) const
+{
+   QMutexLocker lk(&m_Mutex);
+   return m_hCalls.value(callId)[CallPrivate::DetailsMapFields::CONF_ID];
+}
+
+bool FakeDaemon::joinParticipant(const QString& callId1, const QString& callId2)
+{
+   QMutexLocker lk(&m_Mutex);
+
+   if (!(m_hCalls.contains(callId1) && m_hCalls.contains(callId2)) || callId1 == callId2)
+      return false;
+
+   const QString confId = conferenceId(callId1);
+
+   if (!confId.isEmpty())
+      return addParticipant(callId2, confId);
+
+   createConference({callId1, callId2});
+
+   return true;
+}
+
+bool FakeDaemon::addParticipant(const QString& callId, const QString& confId)
+{
+   QMutexLocker lk(&m_Mutex);
+
+   if (!(m_hCalls.contains(callId) && m_hConferences.contains(confId)))
+      return false;
+
+   if (conferenceId(callId) == confId)
+      return true;
+
+   detachParticipant(callId);
+
+   m_hConferences[confId] << callId;
+   m_hCalls[callId][CallPrivate::DetailsMapFields::CONF_ID] = confId;
+
+   post("conferenceChanged", [confId]() {
+      Q_EMIT DBus::CallManager::instance().conferenceChanged(confId, CallPrivate::ConferenceStateChange::ACTIVE);
+   });
+
+   return true;
+}
+
+///A conference left with a single participant is removed
+bool FakeDaemon::detachParticipant(const QString& callId)
+{
+   QMutexLocker lk(&m_Mutex);
+
+   const QString confId = conferenceId(callId);
+
+   if (confId.isEmpty() || !m_hConferences.contains(confId))
+      return false;
+
+   m_hConferences[confId].removeAll(callId);
+   m_hCalls[callId][CallPrivate::DetailsMapFields::CONF_ID] = QString();
+
+   if (m_hConferences[confId].size() < 2)
+      removeConference(confId);
+   else {
+      post("conferenceChanged", [confId]() {
+         Q_EMIT DBus::CallManager::instance().conferenceChanged(confId, CallPrivate::ConferenceStateChange::ACTIVE);
+      });
+   }
+
+   return true;
+}
+
+///Move the participants of the second conference into the first one
+bool FakeDaemon::joinConference(const QString& confId1, const QString& confId2)
+{
+   QMutexLocker lk(&m_Mutex);
+
+   if (!(m_hConferences.contains(confId1) && m_hConferences.contains(confId2)) || confId1 == confId2)
+      return false;
+
+   foreach(const QString& callId, m_hConferences[confId2]) {
+      m_hConferences[confId1] << callId;
+      m_hCalls[callId][CallPrivate::DetailsMapFields::CONF_ID] = confId1;
+   }
+
+   m_hConferences[confId2].clear();
+   removeConference(confId2);
+
+   post("conferenceChanged", [confId1]() {
+      Q_EMIT DBus::CallManager::instance().conferenceChanged(confId1, CallPrivate::ConferenceStateChange::ACTIVE);
+   });
+
+   return true;
+}
+
+bool FakeDaemon::hangUpConference(const QString& confId)
+{
+   QMutexLocker lk(&m_Mutex);
+
+   if (!m_hConferences.contains(confId))
+      return false;
+
+   const QStringList participants = m_hConferences[confId];
+
+   removeConference(confId);
+
+   foreach(const QString& callId, participants)
+      setCallState(callId, CallPrivate::StateChange::HUNG_UP);
+
+   return true;
+}
+
+bool FakeDaemon::holdConference(const QString& confId, bool hold)
+{
+   QMutexLocker lk(&m_Mutex);
+
+   if (!m_hConferences.contains(confId))
+      return false;
+
+   if (hold)
+      m_lHeldConfs.insert(confId);
+   else
+      m_lHeldConfs.remove(confId);
+
+   foreach(const QString& callId, m_hConferences[confId])
+      setCallState(callId, hold ? CallPrivate::StateChange::HOLD : CallPrivate::StateChange::UNHOLD_CURRENT);
+
+   post("conferenceChanged", [confId, hold]() {
+      Q_EMIT DBus::CallManager::instance().conferenceChanged(confId, QString(hold ?
+         CallPrivate::ConferenceStateChange::HOLD : CallPrivate::ConferenceStateChange::ACTIVE
+      ));
+   });
+
+   return true;
+}
+
+void FakeDaemon::createConference(const QStringList& participants)
+{
+   QMutexLocker lk(&m_Mutex);
+
+   QStringList calls;
+
+   foreach(const QString& callId, participants) {
+      if (m_hCalls.contains(callId) && !calls.contains(callId)) {
+         detachParticipant(callId);
+         calls << callId;
+      }
+   }
+
+   if (calls.size() < 2)
+      return;
+
+   const QString confId = nextId("conf");
+
+   m_hConferences[confId] = calls;
+
+   foreach(const QString& callId, calls)
+      m_hCalls[callId][CallPrivate::DetailsMapFields::CONF_ID] = confId;
+
+   post("conferenceCreated", [confId]() {
+      Q_EMIT DBus::CallManager::instance().conferenceCreated(confId);
+   });
+}
+
+/*****************************************************************************
+ *                                                                           *
+ *                                 Presence                                  *
+ *                                                                           *
+ ****************************************************************************/
+
+VectorMapStringString FakeDaemon::subscriptions(const QString& accountId) const
+{
+   QMutexLocker lk(&m_Mutex);
+
+   VectorMapStringString ret;
+   const QHash<QString,bool> buddies = m_hSubscriptions.value(accountId);
+
+   for (auto i = buddies.constBegin(); i != buddies.constEnd(); ++i) {
+      ret << MapStringString {
+         { "Buddy"     , i.key()                          },
+         { "Status"    , i.value() ? "Online" : "Offline" },
+         { "LineStatus", i.value() ? "Available" : ""     },
+      };
+   }
+
+   return ret;
+}
+
+///The buddies answer as soon as they are subscribed to
+void FakeDaemon::subscribeBuddy(const QString& accountId, const QString& uri, bool flag)
+{
+   QMutexLocker lk(&m_Mutex);
+
+   if (!m_hAccounts.contains(accountId))
+      return;
+
+   if (!flag) {
+      m_hSubscriptions[accountId].remove(uri);
+      return;
+   }
+
+   const bool status = m_hSubscriptions[accountId].value(uri, true);
+
+   m_hSubscriptions[accountId][uri] = status;
+
+   post("subscriptionStateChanged", [accountId, uri]() {
+      Q_EMIT DBus::PresenceManager::instance().subscriptionStateChanged(accountId, uri, true);
+   });
+
+   post("newBuddyNotification", [accountId, uri, status]() {
+      Q_EMIT DBus::PresenceManager::instance().newBuddyNotification(
+         accountId, uri, status, status ? "Available" : QString()
+      );
+   });
+}
+
+void FakeDaemon::setSubscriptions(const QString& accountId, const QStringList& uris)
+{
+   QMutexLocker lk(&m_Mutex);
+
+   foreach(const QString& uri, uris)
+      subscribeBuddy(accountId, uri, true);
+}
+
+/*****************************************************************************
+ *                                                                           *
+ *                                  Video                                    *
+ *                                                                           *
+ ****************************************************************************/
+
+QStringList FakeDaemon::deviceList() const
+{
+   QMutexLocker lk(&m_Mutex);
+   return m_hDevices.keys();
+}
+
+MapStringMapStringVectorString FakeDaemon::capabilities(const QString& device) const
+{
+   QMutexLocker lk(&m_Mutex);
+
+   if (!m_hDevices.contains(device))
+      return MapStringMapStringVectorString();
+
+   return {
+      { "Camera", {
+         { "640x480", { "30", "15" } },
+         { "320x240", { "30", "15" } },
+      }},
+   };
+}
+
+MapStringString FakeDaemon::deviceSettings(const QString& device) const
+{
+   QMutexLocker lk(&m_Mutex);
+   return m_hDevices.value(device);
+}
+
+void FakeDaemon::applySettings(const QString& device, const MapStringString& settings)
+{
+   QMutexLocker lk(&m_Mutex);
+
+   if (!m_hDevices.contains(device))
+      return;
+
+   MapStringString& current = m_hDevices[device];
+
+   for (auto i = settings.constBegin(); i != settings.constEnd(); ++i)
+      current[i.key()] = i.value();
+}
+
+QString FakeDaemon::defaultDevice() const
+{
+   QMutexLocker lk(&m_Mutex);
+   return m_DefaultDevice;
+}
+
+void FakeDaemon::setDefaultDevice(const QString& device)
+{
+   QMutexLocker lk(&m_Mutex);
+
+   if (m_hDevices.contains(device))
+      m_DefaultDevice = device;
+}
+
+bool FakeDaemon::hasCameraStarted() const
+{
+   QMutexLocker lk(&m_Mutex);
+   return !m_FrameSize.isEmpty();
+}
+
+///Produce frames at the size of the default device
+void FakeDaemon::startCamera()
+{
+   QMutexLocker lk(&m_Mutex);
+
+   if (!m_FrameSize.isEmpty())
+      return;
+
+   const QStringList size = m_hDevices.value(m_DefaultDevice)["size"].split('x');
+
+   m_FrameSize = size.size() == 2 ? QSize(size[0].toInt(), size[1].toInt()) : QSize();
+
+   if (m_FrameSize.isEmpty())
+      m_FrameSize = QSize(640, 480);
+
+   const QSize res = m_FrameSize;
+
+   post("startedDecoding", [this, res]() {
+      // Only produce once the client can register its sink
+      m_pFrameTimer->start();
+
+      Q_EMIT DBus::VideoManager::instance().startedDecoding(PREVIEW_ID, QString(), res.width(), res.height(), false);
+   });
+}
+
+void FakeDaemon::stopCamera()
+{
+   QMutexLocker lk(&m_Mutex);
+
+   if (m_FrameSize.isEmpty())
+      return;
+
+   m_FrameSize = QSize();
+
+   post("stoppedDecoding", [this]() {
+      m_pFrameTimer->stop();
+
+      {
+         QMutexLocker lk2(&m_Mutex);
+         m_hSinks.remove(PREVIEW_ID);
+      }
+
+      Q_EMIT DBus::VideoManager::instance().stoppedDecoding(PREVIEW_ID, QString(), false);
+   });
+}
+
+void FakeDaemon::registerSinkTarget(const QString& sinkId, const std::function<void(uint8_t*)>& cb)
+{
+   QMutexLocker lk(&m_Mutex);
+   m_hSinks[sinkId] = cb;
+}
+
+/*****************************************************************************
+ *                                                                           *
+ *                                 Helpers                                   *
+ *                                                                           *
+ ****************************************************************************/
+
+///Mimic the IPC round-trip, called by every interface method
+void FakeDaemon::simulateLatency() const
+{
+   const int usec = m_Latency;
+
+   if (usec > 0)
+      QThread::usleep(usec);
+}
+
+QString FakeDaemon::nextId(const char* prefix)
+{
+   QMutexLocker lk(&m_Mutex);
+   return prefix + QString::number(++m_Counter);
+}
+
+///Add an account without notifying the client, the id is generated if empty
+QString FakeDaemon::createAccount(const MapStringString& details, const QString& id)
+{
+   QMutexLocker lk(&m_Mutex);
+
+   const QString accountId = id.isEmpty() ? nextId("fake") : id;
+   const QString type      = details.value(DRing::Account::ConfProperties::TYPE, DRing::Account::ProtocolNames::SIP);
+
+   MapStringString account = accountTemplate(type);
+
+   for (auto i = details.constBegin(); i != details.constEnd(); ++i)
+      account[i.key()] = i.value();
+
+   m_hAccounts[accountId] = account;
+   m_hVolatile[accountId] = {
+      { DRing::Account::VolatileProperties::Registration::STATUS, DRing::Account::States::UNREGISTERED },
+   };
+
+   m_lAccountOrder << accountId;
+
+   return accountId;
+}
+
+/**
+ * Create a call from or to a peer.
+ *
+ * An outgoing call exist right away, as if it was placed by the client. An
+ * incoming one only exist once incomingCall is delivered.
+ */
+QString FakeDaemon::createCall(const QString& accountId, const QString& peer, bool incoming)
+{
+   QMutexLocker lk(&m_Mutex);
+
+   const QString callId = nextId("");
+
+   MapStringString details;
+   details[CallPrivate::DetailsMapFields::PEER_NAME      ] = peer.left(peer.indexOf('@'));
+   details[CallPrivate::DetailsMapFields::PEER_NUMBER    ] = peer;
+   details[CallPrivate::DetailsMapFields::ACCOUNT_ID     ] = accountId;
+   details[CallPrivate::DetailsMapFields::CONF_ID        ] = QString();
+   details[CallPrivate::DetailsMapFields::TIMESTAMP_START] = QString::number(QDateTime::currentDateTime().toTime_t());
+   details[CallPrivate::DetailsMapFields::STATE          ] = incoming ?
+      CallPrivate::DaemonStateInit::INCOMING : CallPrivate::DaemonStateInit::RINGING;
+   details[CallPrivate::DetailsMapFields::TYPE           ] = incoming ?
+      CallPrivate::CallDirection::INCOMING : CallPrivate::CallDirection::OUTGOING;
+
+   if (incoming) {
+      post("incomingCall", [this, accountId, callId, peer, details]() {
+         {
+            QMutexLocker lk2(&m_Mutex);
+            m_hCalls[callId] = details;
+         }
+
+         Q_EMIT DBus::CallManager::instance().incomingCall(accountId, callId, peer);
+      });
+   }
+   else {
+      m_hCalls[callId] = details;
+
+      post("newCallCreated", [accountId, callId, peer]() {
+         Q_EMIT DBus::CallManager::instance().newCallCreated(accountId, callId, peer);
+      });
+   }
+
+   return callId;
+}
+
+///Queue a signal, to be delivered in order from the event loop
+void FakeDaemon::post(const char* name, const std::function<void()>& apply)
+{
+   QMutexLocker lk(&m_Mutex);
+
+   m_lEvents << Event { name, DBus::IpcTrace::now(), apply };
+
+   if (!m_Scheduled) {
+      m_Scheduled = true;
+      QMetaObject::invokeMethod(this, "deliver", Qt::QueuedConnection);
+   }
+}
+
+///The state is updated when the signal is delivered, a call hung up twice is only reported once
+void FakeDaemon::setCallState(const QString& callId, const char* state, int code)
+{
+   post("callStateChanged", [this, callId, state, code]() {
+      const QString s(state);
+
+      {
+         QMutexLocker lk(&m_Mutex);
+
+         if (!m_hCalls.contains(callId))
+            return;
+
+         if (s == CallPrivate::StateChange::HUNG_UP || s == CallPrivate::StateChange::FAILURE)
+            endCall(callId);
+         else if (s == CallPrivate::StateChange::UNHOLD_CURRENT)
+            m_hCalls[callId][CallPrivate::DetailsMapFields::STATE] = CallPrivate::DaemonStateInit::CURRENT;
+         else
+            m_hCalls[callId][CallPrivate::DetailsMapFields::STATE] = s;
+      }
+
+      Q_EMIT DBus::CallManager::instance().callStateChanged(callId, s, code);
+   });
+}
+
+///Forget a call, its conference is removed if it had only one other participant
+void FakeDaemon::endCall(const QString& callId)
+{
+   QMutexLocker lk(&m_Mutex);
+
+   const QString confId = conferenceId(callId);
+
+   if (!confId.isEmpty())
+      detachParticipant(callId);
+
+   m_hCalls    .remove(callId);
+   m_lRecording.remove(callId);
+}
+
+void FakeDaemon::setRegistration(const QString& accountId, const char* state, int code, const QString& desc)
+{
+   post("registrationStateChanged", [this, accountId, state, code, desc]() {
+      {
+         QMutexLocker lk(&m_Mutex);
+
+         if (!m_hVolatile.contains(accountId))
+            return;
+
+         MapStringString& details = m_hVolatile[accountId];
+
+         details[DRing::Account::VolatileProperties::Registration::STATUS] = state;
+         details[DRing::Account::VolatileProperties::Transport::STATE_CODE] = QString::number(code);
+         details[DRing::Account::VolatileProperties::Transport::STATE_DESC] = desc;
+      }
+
+      Q_EMIT DBus::ConfigurationManager::instance().registrationStateChanged(accountId, state, code, desc);
+   });
+
+   post("volatileAccountDetailsChanged", [this, accountId]() {
+      const MapStringString details = volatileAccountDetails(accountId);
+
+      if (!details.isEmpty())
+         Q_EMIT DBus::ConfigurationManager::instance().volatileAccountDetailsChanged(accountId, details);
+   });
+}
+
+///The remaining participants are detached from it
+void FakeDaemon::removeConference(const QString& confId)
+{
+   QMutexLocker lk(&m_Mutex);
+
+   foreach(const QString& callId, m_hConferences.value(confId)) {
+      if (m_hCalls.contains(callId))
+         m_hCalls[callId][CallPrivate::DetailsMapFields::CONF_ID] = QString();
+   }
+
+   m_hConferences.remove(confId);
+   m_lHeldConfs  .remove(confId);
+   m_lRecording  .remove(confId);
+
+   post("conferenceRemoved", [confId]() {
+      Q_EMIT DBus::CallManager::instance().conferenceRemoved(confId);
+   });
+}
+
+///Spread the load across the accounts, the IP2IP account is only used if there is no other
+QString FakeDaemon::accountFor(uint index) const
+{
+   QMutexLocker lk(&m_Mutex);
+
+   QStringList accounts = m_lAccountOrder;
+   accounts.removeAll(DRing::Account::ProtocolNames::IP2IP);
+
+   if (accounts.isEmpty())
+      return DRing::Account::ProtocolNames::IP2IP;
+
+   return accounts[index % accounts.size()];
+}
+
+///Call f count times, all at once or one every interval ms
+void FakeDaemon::repeat(int count, int interval, const std::function<void(int)>& f)
+{
+   if (interval <= 0) {
+      for (int i = 0; i < count; i++)
+         f(i);
+      return;
+   }
+
+   if (count <= 0)
+      return;
+
+   QTimer* t = new QTimer(this);
+   t->setInterval(interval);
+
+   connect(t, &QTimer::timeout, t, [t, f, count, i = 0]() mutable {
+      f(i++);
+
+      if (i >= count) {
+         t->stop();
+         t->deleteLater();
+      }
+   });
+
+   t->start();
+}
+
+/*****************************************************************************
+ *                                                                           *
+ *                                  Slots                                    *
+ *                                                                           *
+ ****************************************************************************/
+
+///Deliver the queued signals, those posted meanwhile wait for the next round
+void FakeDaemon::deliver()
+{
+   QList<Event> events;
+
+   {
+      QMutexLocker lk(&m_Mutex);
+      events.swap(m_lEvents);
+      m_Scheduled = false;
+   }
+
+   foreach(const Event& e, events) {
+      DBus::IpcTrace::Scope s(DBus::IpcTrace::Kind::DELIVERY, e.name, e.posted);
+      e.apply();
+   }
+}
+
+///Push a synthetic frame to the preview sink, the color change every frame
+void FakeDaemon::pushFrame()
+{
+   std::function<void(uint8_t*)> sink;
+   QSize                         res ;
+
+   {
+      QMutexLocker lk(&m_Mutex);
+      sink = m_hSinks.value(PREVIEW_ID);
+      res  = m_FrameSize;
+   }
+
+   if (!sink || res.isEmpty())
+      return;
+
+   const int size = res.width() * res.height() * 4;
+
+   if (m_Frame.size() != size)
+      m_Frame.resize(size);
+
+   ::memset(m_Frame.data(), static_cast<int>(m_FrameCount++ & 0xff), size);
+
+   sink(reinterpret_cast<uint8_t*>(m_Frame.data()));
+}
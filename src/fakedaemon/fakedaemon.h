@@ -0,0 +1,215 @@
+/****************************************************************************
+ *   Copyright (C) 2015 by Savoir-Faire Linux                               *
+ *   Author : Emmanuel Lepage Vallee <emmanuel.lepage@savoirfairelinux.com> *
+ *                                                                          *
+ *   This library is free software; you can redistribute it and/or          *
+ *   modify it under the terms of the GNU Lesser General Public             *
+ *   License as published by the Free Software Foundation; either           *
+ *   version 2.1 of the License, or (at your option) any later version.     *
+ *                                                                          *
+ *   This library is distributed in the hope that it will be useful,        *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU      *
+ *   Lesser General Public License for more details.                        *
+ *                                                                          *
+ *   You should have received a copy of the GNU General Public License      *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>.  *
+ ***************************************************************************/
+#ifndef FAKEDAEMON_H
+#define FAKEDAEMON_H
+
+#include <typedefs.h>
+
+//Qt
+#include <QtCore/QObject>
+#include <QtCore/QHash>
+#include <QtCore/QMutex>
+#include <QtCore/QSet>
+#include <QtCore/QSize>
+#include <QtCore/QStringList>
+#include <QtCore/QVariant>
+
+//STD
+#include <atomic>
+#include <cstdint>
+#include <functional>
+
+//Ring
+#include "../dbus/ipctrace.h"
+
+class QTimer;
+
+/**
+ * An in-process daemon, for benchmarking and stress testing the models.
+ *
+ * When the library is built with ENABLE_FAKE_DAEMON, the DBus::*Manager
+ * singletons are backed by this object instead of a real daemon. It keep
+ * the accounts, calls, conferences and presence subscriptions in memory
+ * and answer the method calls like the daemon would, without any network
+ * or audio. Like the daemon, it can be called from any thread.
+ *
+ * The signals are queued and delivered in order from the event loop, as
+ * with the real daemon. The changes requested through a method are applied
+ * right away, but the ones coming from the "network" (incoming calls,
+ * registrations, presence) are only applied when their signal is
+ * delivered, so a call can't be queried before the client heard of it.
+ *
+ * The load generators create synthetic accounts, presence buddies and
+ * calls, in bulk or in bursts, through the same signals as a daemon would
+ * send.
+ */
+class LIB_EXPORT FakeDaemon : public QObject
+{
+   #pragma GCC diagnostic push
+   #pragma GCC diagnostic ignored "-Wzero-as-null-pointer-constant"
+   Q_OBJECT
+   #pragma GCC diagnostic pop
+public:
+   //Singleton
+   static FakeDaemon* instance();
+
+   //Getters
+   int latency      () const;
+   int pendingEvents() const;
+
+   //Setters
+   void setLatency(int usec);
+
+   //Load generators
+   void populateAccounts (int count, const QString& protocol = QString());
+   void populateBuddies  (int count);
+   void populateHistory  (int count);
+   void incomingCallBurst(int count, int interval = 0);
+   void registrationFlaps(int count, int interval = 0);
+   void hangUpAll        ();
+
+   /*
+    * The daemon side of the interfaces, the methods have the same semantic
+    * as the ones from xml/ (*-introspec.xml).
+    */
+
+   //Accounts
+   QStringList           accountList              () const;
+   MapStringString       accountDetails           (const QString& accountId) const;
+   MapStringString       volatileAccountDetails   (const QString& accountId) const;
+   MapStringString       accountTemplate          (const QString& type     ) const;
+   VectorMapStringString credentials              (const QString& accountId) const;
+   QString               addAccount               (const MapStringString& details);
+   void                  setAccountDetails        (const QString& accountId, const MapStringString& details);
+   void                  setCredentials           (const QString& accountId, const VectorMapStringString& credentials);
+   void                  removeAccount            (const QString& accountId);
+   void                  setAccountsOrder         (const QString& order    );
+   void                  sendRegister             (const QString& accountId, bool enable);
+   void                  registerAllAccounts      ();
+
+   //Calls
+   QStringList     callList           () const;
+   MapStringString callDetails        (const QString& callId) const;
+   bool            isRecording        (const QString& callId) const;
+   QString         placeCall          (const QString& accountId, const QString& to);
+   bool            accept             (const QString& callId);
+   bool            refuse             (const QString& callId);
+   bool            hangUp             (const QString& callId);
+   bool            hold               (const QString& callId);
+   bool            unhold             (const QString& callId);
+   bool            transfer           (const QString& callId, const QString& to);
+   bool            attendedTransfer   (const QString& transferId, const QString& targetId);
+   bool            toggleRecording    (const QString& callId);
+
+   //Conferences
+   QStringList     conferenceList     () const;
+   QStringList     participantList    (const QString& confId) const;
+   MapStringString conferenceDetails  (const QString& confId) const;
+   QString         conferenceId       (const QString& callId) const;
+   bool            joinParticipant    (const QString& callId1, const QString& callId2);
+   bool            addParticipant     (const QString& callId , const QString& confId );
+   bool            detachParticipant  (const QString& callId );
+   bool            joinConference     (const QString& confId1, const QString& confId2);
+   bool            hangUpConference   (const QString& confId );
+   bool            holdConference     (const QString& confId, bool hold);
+   void            createConference   (const QStringList& participants);
+
+   //Presence
+   VectorMapStringString subscriptions   (const QString& accountId) const;
+   void                  subscribeBuddy  (const QString& accountId, const QString& uri, bool flag);
+   void                  setSubscriptions(const QString& accountId, const QStringList& uris);
+
+   //Video
+   QStringList                    deviceList      () const;
+   MapStringMapStringVectorString capabilities    (const QString& device) const;
+   MapStringString                deviceSettings  (const QString& device) const;
+   void                           applySettings   (const QString& device, const MapStringString& settings);
+   QString                        defaultDevice   () const;
+   void                           setDefaultDevice(const QString& device);
+   bool                           hasCameraStarted() const;
+   void                           startCamera     ();
+   void                           stopCamera      ();
+   void                           registerSinkTarget(const QString& sinkId, const std::function<void(uint8_t*)>& cb);
+
+   //Settings
+   QVariant setting   (const QString& key, const QVariant& defaultValue = QVariant()) const;
+   void     setSetting(const QString& key, const QVariant& value);
+
+   //Helpers
+   void simulateLatency() const;
+
+private:
+   //Constructor
+   explicit FakeDaemon();
+   virtual ~FakeDaemon();
+
+   ///A signal waiting to be delivered
+   struct Event {
+      const char*           name  ;
+      qint64                posted; /*!< See DBus::IpcTrace::now() */
+      std::function<void()> apply ; /*!< Update the state and emit  */
+   };
+
+   //Attributes
+   QHash<QString, MapStringString>        m_hAccounts     ;
+   QHash<QString, MapStringString>        m_hVolatile     ;
+   QHash<QString, VectorMapStringString>  m_hCredentials  ;
+   QStringList                            m_lAccountOrder ;
+   QHash<QString, MapStringString>        m_hCalls        ;
+   QSet<QString>                          m_lRecording    ;
+   QHash<QString, QStringList>            m_hConferences  ;
+   QSet<QString>                          m_lHeldConfs    ;
+   QHash<QString, QHash<QString,bool> >   m_hSubscriptions; /*!< Buddies status, by account */
+   QHash<QString, MapStringString>        m_hDevices      ; /*!< Applied settings           */
+   QHash<QString, QVariant>               m_hSettings     ;
+   QHash<QString, std::function<void(uint8_t*)> > m_hSinks;
+   QString                                m_DefaultDevice ;
+   QList<Event>                           m_lEvents       ;
+   bool                                   m_Scheduled     ; /*!< A deliver() is already queued   */
+   std::atomic_int                        m_Latency       ; /*!< Simulated method latency, in µs */
+   uint                                   m_Counter       ; /*!< Id generator                    */
+   QTimer*                                m_pFrameTimer   ;
+   QByteArray                             m_Frame         ;
+   QSize                                  m_FrameSize     ;
+   uint                                   m_FrameCount    ;
+   mutable QMutex                         m_Mutex         ; /*!< Recursive, guard everything above */
+
+   //Static attributes
+   static FakeDaemon* m_spInstance;
+
+   //Helpers
+   QString nextId           (const char* prefix);
+   QString createAccount    (const MapStringString& details, const QString& id = QString());
+   QString createCall       (const QString& accountId, const QString& peer, bool incoming);
+   void    post             (const char* name, const std::function<void()>& apply);
+   void    setCallState     (const QString& callId, const char* state, int code = 0);
+   void    endCall          (const QString& callId);
+   void    setRegistration  (const QString& accountId, const char* state, int code, const QString& desc);
+   void    removeConference (const QString& confId);
+   QString accountFor       (uint index) const;
+   void    repeat           (int count, int interval, const std::function<void(int)>& f);
+
+private Q_SLOTS:
+   void deliver  ();
+   void pushFrame();
+};
+
+///Trace a fake daemon method and apply the simulated latency
+#define FAKE_DRING_CALL TRACE_DRING_CALL; FakeDaemon::instance()->simulateLatency()
+
+#endif
@@ -0,0 +1,78 @@
+/******************************************************************************
+ *   Copyright (C) 2015 by Savoir-Faire Linux                                 *
+ *   Author : Emmanuel Lepage Vallee <emmanuel.lepage@savoirfairelinux.com>   *
+ *                                                                            *
+ *   This library is free software; you can redistribute it and/or            *
+ *   modify it under the terms of the GNU Lesser General Public               *
+ *   License as published by the Free Software Foundation; either             *
+ *   version 2.1 of the License, or (at your option) any later version.       *
+ *                                                                            *
+ *   This library is distributed in the hope that it will be useful,          *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of           *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU        *
+ *   Lesser General Public License for more details.                          *
+ *                                                                            *
+ *   You should have received a copy of the Lesser GNU General Public License *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>.    *
+ *****************************************************************************/
+#ifndef INSTANCE_FAKE_INTERFACE_H
+#define INSTANCE_FAKE_INTERFACE_H
+
+#include <QtCore/QObject>
+#include <QtCore/QString>
+
+#include "../typedefs.h"
+#include "fakedaemon.h"
+
+//The methods return right away, as with the libwrap interfaces
+#ifndef Q_NOREPLY
+ #define Q_NOREPLY
+#endif
+
+/*
+ * Fake implementation of the interface cx.ring.Ring.Instance
+ *
+ * There is nothing to poll, FakeDaemon deliver its signals from the
+ * event loop.
+ */
+class InstanceInterface: public QObject
+{
+   Q_OBJECT
+public:
+   InstanceInterface()
+   {
+      // Make sure the daemon live in the main thread
+      FakeDaemon::instance();
+   }
+
+   ~InstanceInterface() {}
+
+public Q_SLOTS: // METHODS
+   void Register(int pid, const QString &name)
+   {
+      Q_UNUSED(pid )
+      Q_UNUSED(name)
+   }
+
+   void Unregister(int pid)
+   {
+      Q_UNUSED(pid)
+   }
+
+   bool isConnected()
+   {
+      return true;
+   }
+
+Q_SIGNALS: // SIGNALS
+   void started();
+};
+
+namespace cx {
+  namespace Ring {
+    namespace Ring {
+      typedef ::InstanceInterface Instance;
+    }
+  }
+}
+#endif
@@ -0,0 +1,87 @@
+/******************************************************************************
+ *   Copyright (C) 2015 by Savoir-Faire Linux                                 *
+ *   Author : Emmanuel Lepage Vallee <emmanuel.lepage@savoirfairelinux.com>   *
+ *                                                                            *
+ *   This library is free software; you can redistribute it and/or            *
+ *   modify it under the terms of the GNU Lesser General Public               *
+ *   License as published by the Free Software Foundation; either             *
+ *   version 2.1 of the License, or (at your option) any later version.       *
+ *                                                                            *
+ *   This library is distributed in the hope that it will be useful,          *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of           *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU        *
+ *   Lesser General Public License for more details.                          *
+ *                                                                            *
+ *   You should have received a copy of the Lesser GNU General Public License *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>.    *
+ *****************************************************************************/
+#ifndef PRESENCEMANAGER_FAKE_INTERFACE_H
+#define PRESENCEMANAGER_FAKE_INTERFACE_H
+
+#include <QtCore/QObject>
+#include <QtCore/QString>
+#include <QtCore/QStringList>
+
+#include "typedefs.h"
+#include "fakedaemon.h"
+
+/*
+ * Fake implementation of the interface cx.ring.Ring.PresenceManager
+ */
+class PresenceManagerInterface: public QObject
+{
+    Q_OBJECT
+
+public:
+    PresenceManagerInterface() {}
+    ~PresenceManagerInterface() {}
+
+public Q_SLOTS: // METHODS
+    void answerServerRequest(const QString &uri, bool flag)
+    {
+        FAKE_DRING_CALL;
+        Q_UNUSED(uri)
+        Q_UNUSED(flag)
+    }
+
+    VectorMapStringString getSubscriptions(const QString &accountID)
+    {
+        FAKE_DRING_CALL;
+        return FakeDaemon::instance()->subscriptions(accountID);
+    }
+
+    void publish(const QString &accountID, bool status, const QString &note)
+    {
+        FAKE_DRING_CALL;
+        Q_UNUSED(accountID)
+        Q_UNUSED(status)
+        Q_UNUSED(note)
+    }
+
+    void setSubscriptions(const QString &accountID, const QStringList &uriList)
+    {
+        FAKE_DRING_CALL;
+        FakeDaemon::instance()->setSubscriptions(accountID, uriList);
+    }
+
+    void subscribeBuddy(const QString &accountID, const QString &uri, bool flag)
+    {
+        FAKE_DRING_CALL;
+        FakeDaemon::instance()->subscribeBuddy(accountID, uri, flag);
+    }
+
+Q_SIGNALS: // SIGNALS
+    void newServerSubscriptionRequest(const QString &buddyUri);
+    void serverError(const QString &accountID, const QString &error, const QString &msg);
+    void newBuddyNotification(const QString &accountID, const QString &buddyUri, bool status, const QString &lineStatus);
+    void subscriptionStateChanged(const QString &accountID, const QString &buddyUri, bool state);
+};
+
+namespace org {
+  namespace ring {
+    namespace Ring {
+      typedef ::PresenceManagerInterface PresenceManager;
+    }
+  }
+}
+#endif
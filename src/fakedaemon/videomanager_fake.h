@@ -0,0 +1,129 @@
+/******************************************************************************
+ *   Copyright (C) 2015 by Savoir-Faire Linux                                 *
+ *   Author : Emmanuel Lepage Vallee <emmanuel.lepage@savoirfairelinux.com>   *
+ *                                                                            *
+ *   This library is free software; you can redistribute it and/or            *
+ *   modify it under the terms of the GNU Lesser General Public               *
+ *   License as published by the Free Software Foundation; either             *
+ *   version 2.1 of the License, or (at your option) any later version.       *
+ *                                                                            *
+ *   This library is distributed in the hope that it will be useful,          *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of           *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU        *
+ *   Lesser General Public License for more details.                          *
+ *                                                                            *
+ *   You should have received a copy of the Lesser GNU General Public License *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>.    *
+ *****************************************************************************/
+#ifndef VIDEO_FAKE_INTERFACE_H
+#define VIDEO_FAKE_INTERFACE_H
+
+// libstdc++
+#include <functional>
+
+// Qt
+#include <QtCore/QObject>
+#include <QtCore/QString>
+#include <QtCore/QStringList>
+
+#include "typedefs.h"
+#include "fakedaemon.h"
+
+/*
+ * Fake implementation of the interface cx.ring.Ring.VideoManager
+ *
+ * A single synthetic camera is exposed, its frames are pushed to the
+ * registered sinks from the main thread.
+ */
+class VideoManagerInterface: public QObject
+{
+    Q_OBJECT
+
+public:
+    VideoManagerInterface() {}
+    ~VideoManagerInterface() {}
+
+public Q_SLOTS: // METHODS
+    void applySettings(const QString &name, MapStringString settings)
+    {
+        FAKE_DRING_CALL;
+        FakeDaemon::instance()->applySettings(name, settings);
+    }
+
+    MapStringMapStringVectorString getCapabilities(const QString &name)
+    {
+        FAKE_DRING_CALL;
+        return FakeDaemon::instance()->capabilities(name);
+    }
+
+    QString getDefaultDevice()
+    {
+        FAKE_DRING_CALL;
+        return FakeDaemon::instance()->defaultDevice();
+    }
+
+    QStringList getDeviceList()
+    {
+        FAKE_DRING_CALL;
+        return FakeDaemon::instance()->deviceList();
+    }
+
+    MapStringString getSettings(const QString &device)
+    {
+        FAKE_DRING_CALL;
+        return FakeDaemon::instance()->deviceSettings(device);
+    }
+
+    bool hasCameraStarted()
+    {
+        FAKE_DRING_CALL;
+        return FakeDaemon::instance()->hasCameraStarted();
+    }
+
+    void setDefaultDevice(const QString &name)
+    {
+        FAKE_DRING_CALL;
+        FakeDaemon::instance()->setDefaultDevice(name);
+    }
+
+    void startCamera()
+    {
+        FAKE_DRING_CALL;
+        FakeDaemon::instance()->startCamera();
+    }
+
+    void stopCamera()
+    {
+        FAKE_DRING_CALL;
+        FakeDaemon::instance()->stopCamera();
+    }
+
+    bool switchInput(const QString &resource)
+    {
+        FAKE_DRING_CALL;
+        Q_UNUSED(resource)
+        return true;
+    }
+
+    void registerSinkTarget(const QString &sinkID, std::function<void(uint8_t*)>&& cb)
+    {
+        FAKE_DRING_CALL;
+        FakeDaemon::instance()->registerSinkTarget(sinkID, cb);
+    }
+
+    void registerSinkTarget(const QString &sinkID, std::function<void(uint8_t*)>& cb)
+    {
+        FAKE_DRING_CALL;
+        FakeDaemon::instance()->registerSinkTarget(sinkID, cb);
+    }
+
+Q_SIGNALS: // SIGNALS
+    void deviceEvent();
+    void startedDecoding(const QString &id, const QString &shmPath, int width, int height, bool isMixer);
+    void stoppedDecoding(const QString &id, const QString &shmPath, bool isMixer);
+};
+
+namespace org { namespace ring { namespace Ring {
+      typedef ::VideoManagerInterface VideoManager;
+}}} // namesapce org::ring::Ring
+#endif
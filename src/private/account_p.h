@@ -70,6 +70,7 @@ public:
    QString                    m_LastSipRegistrationStatus;
    unsigned short             m_UseDefaultPort           ;
    bool                       m_RemoteEnabledState       ;
+   uint                       m_VolatileSeq              ; /*!< Bumped by each volatile details update or query */
 
    //Setters
    void setAccountProperties(const QHash<QString,QString>& m          );
@@ -82,11 +83,16 @@ public:
    bool merge(Account* account);
    //Constructors
    static Account* buildExistingAccountFromId(const QByteArray& _accountId);
+   static Account* buildExistingAccountFromId(const QByteArray& _accountId, const MapStringString& details,
+                                              const MapStringString& volatileDetails);
    static Account* buildNewAccountFromAlias  (Account::Protocol proto, const QString& alias);
 
    //Helpers
    inline void changeState(Account::EditState state);
    bool updateState();
+   bool updateState(const MapStringString& volatileDetails);
+   void applyDetails(const MapStringString& details);
+   void reload     (const MapStringString& details, const MapStringString& volatileDetails);
    void regenSecurityValidation();
 
    //State actions
@@ -38,6 +38,13 @@ class AccountModelPrivate : public QObject
    friend class AccountPrivate;
    friend class AvailableAccountModel;
 public:
+   ///The replies of the batched details queries, joined before being applied
+   struct Replies {
+      QHash<QString,MapStringString> details        ;
+      QHash<QString,MapStringString> volatileDetails;
+      int                            pending        ; /*!< Queries not answered yet */
+   };
+
    //Constructor
    explicit AccountModelPrivate(AccountModel* parent);
    void init();
@@ -45,6 +52,13 @@ public:
    //Helpers
    static Account::RegistrationState fromDaemonName(const QString& st);
    void enableProtocol(Account::Protocol proto);
+   void listUpdated();
+   void fetchVolatileDetails(Account* a);
+   void applyVolatileDetails(Account* a, const MapStringString& details);
+   void addAccounts(const QStringList& accountIds, const QStringList& ids, const QHash<QString,MapStringString>& details,
+                    const QHash<QString,MapStringString>& volatileDetails);
+   void reloadAccounts(const QHash<QString,uint>& seqs, const QHash<QString,MapStringString>& details,
+                       const QHash<QString,MapStringString>& volatileDetails);
 
    //Attributes
    AccountModel*                     q_ptr                ;
@@ -58,6 +72,7 @@ public:
    QItemSelectionModel*              m_pSelectionModel    ;
    QStringList                       m_lMimes             ;
    Matrix1D<Account::Protocol, bool> m_lSupportedProtocols;
+   bool                              m_IsLoaded           ; /*!< The first account list was received */
 
    //Future account cache
    static  QHash<QByteArray,AccountPlaceHolder*> m_hsPlaceHolder;
@@ -232,6 +232,7 @@ public:
    static Call* buildIncomingCall (const QString& callId                                );
    static Call* buildRingingCall  (const QString& callId                                );
    static Call* buildExistingCall (const QString& callId                                );
+   static Call* buildExistingCall (const QString& callId, const MapStringString& details, bool recording);
 
 private:
    Call* q_ptr;
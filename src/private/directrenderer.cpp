@@ -23,6 +23,7 @@
 #include <QtCore/QTime>
 #include <QtCore/QTimer>
 
+#include <atomic>
 #include <cstring>
 
 #ifndef CLOCK_REALTIME
@@ -35,18 +36,60 @@
 
 namespace Video {
 
+/* Frame ring
+ * Implementation note: triple buffering
+ * The daemon thread (producer) and the renderer thread (consumer) each own
+ * one slot. The third one is exchanged atomically: the producer publish its
+ * slot by swapping it with the shared one, flagged as fresh, and the
+ * consumer take the shared one back only if it is fresh. Neither side ever
+ * wait for the other, the consumer always get the newest complete frame
+ * and a fresh frame overwritten before being consumed is counted as dropped.
+ *
+ * A leased frame keep a reference to the buffer of its slot. The slot is
+ * recycled anyway, the producer then write into a new buffer.
+ */
+
 class DirectRendererPrivate : public QObject
 {
    Q_OBJECT
 public:
    DirectRendererPrivate(Video::DirectRenderer* parent);
+
+   ///A frame buffer and its descriptor
+   struct Slot {
+      QByteArray buffer   ;
+      QSize      res      ;
+      uint       frameGen ;
+      qint64     timestamp;
+   };
+
+   // Constants
+   constexpr static const int RING_SIZE = 3;
+   constexpr static const int FRESH     = 1 << 2; /*!< The shared slot was not consumed yet */
+   constexpr static const int INDEX     = 0x3   ;
+
+   // Attributes
+   Slot             m_lRing[RING_SIZE]; /*!< Recycled frame buffers                 */
+   int              m_WriteSlot       ; /*!< Owned by the producer                  */
+   int              m_ReadSlot        ; /*!< Owned by the consumer                  */
+   std::atomic_int  m_SharedSlot      ; /*!< Slot in transit, with the FRESH flag   */
+   std::atomic_bool m_LatchQueued     ;
+   uint             m_ProducedGen     ; /*!< Generation of the last produced frame  */
+   uint             m_ConsumedGen     ; /*!< Generation of the last consumed frame  */
+   std::atomic_uint m_ProducerDropped ; /*!< Fresh frames overwritten by a new one  */
+
 private:
-//    Video::DirectRenderer* q_ptr;
+   Video::DirectRenderer* q_ptr;
+
+private Q_SLOTS:
+   void latchFrame();
 };
 
 }
 
-Video::DirectRendererPrivate::DirectRendererPrivate(Video::DirectRenderer* parent) : QObject(parent)/*, q_ptr(parent)*/
+Video::DirectRendererPrivate::DirectRendererPrivate(Video::DirectRenderer* parent) : QObject(parent), q_ptr(parent)
+, m_WriteSlot(0), m_ReadSlot(1), m_SharedSlot(2), m_LatchQueued(false), m_ProducedGen(0), m_ConsumedGen(0)
+, m_ProducerDropped(0)
 {
 }
 
@@ -59,6 +102,7 @@ Video::DirectRenderer::DirectRenderer(const QByteArray& id, const QSize& res): R
 ///Destructor
 Video::DirectRenderer::~DirectRenderer()
 {
+   Video::Renderer::d_ptr->detachCompositors();
 }
 
 void Video::DirectRenderer::startRendering()
@@ -74,19 +118,110 @@ void Video::DirectRenderer::stopRendering ()
    emit stopped();
 }
 
-void Video::DirectRenderer::onNewFrame(const QByteArray& frame)
+/**
+ * Copy a frame from the daemon sink callback.
+ *
+ * The daemon buffer is only valid for the duration of the callback, so the
+ * frame is copied into the producer slot of the ring, which is then
+ * published. This never block, the mutex is not used.
+ *
+ * @param frame RGBA pixels, without padding
+ * @param res   the frame resolution
+ */
+void Video::DirectRenderer::onNewFrame(const uchar* frame, const QSize& res)
 {
-   if (!isRendering()) {
+   if ((!isRendering()) || (!frame) || res.isEmpty()) {
       return;
    }
 
-   Video::Renderer::d_ptr->m_pFrame = const_cast<char*>(frame.data());
-   emit frameUpdated();
+   const int size = res.width() * res.height() * 4;
+
+   DirectRendererPrivate::Slot& slot = d_ptr->m_lRing[d_ptr->m_WriteSlot];
+
+   if (slot.buffer.size() != size)
+      slot.buffer.resize(size);
+
+   ::memcpy(slot.buffer.data(), frame, size);
+
+   slot.res       = res;
+   slot.frameGen  = ++d_ptr->m_ProducedGen;
+   slot.timestamp = RendererPrivate::now();
+
+   const int previous = d_ptr->m_SharedSlot.exchange(
+      d_ptr->m_WriteSlot | DirectRendererPrivate::FRESH, std::memory_order_acq_rel
+   );
+
+   if (previous & DirectRendererPrivate::FRESH)
+      ++d_ptr->m_ProducerDropped;
+
+   d_ptr->m_WriteSlot = previous & DirectRendererPrivate::INDEX;
+
+   // Coalesce the notifications, the consumer always take the newest frame
+   if (!d_ptr->m_LatchQueued.exchange(true))
+      QMetaObject::invokeMethod(d_ptr.data(), "latchFrame", Qt::QueuedConnection);
+}
+
+///Take the newest published frame and expose it to the clients
+void Video::DirectRendererPrivate::latchFrame()
+{
+   m_LatchQueued = false;
+
+   if (!(m_SharedSlot.load(std::memory_order_acquire) & FRESH))
+      return;
+
+   {
+      QMutexLocker lk {q_ptr->mutex()};
+
+      Video::RendererPrivate* rd = q_ptr->Video::Renderer::d_ptr;
+
+      // Only the leases may still reference the slot handed back to the
+      // producer
+      rd->m_FrameBuffer.clear();
+
+      m_ReadSlot = m_SharedSlot.exchange(m_ReadSlot, std::memory_order_acq_rel) & INDEX;
+
+      Slot& slot = m_lRing[m_ReadSlot];
+
+      // The skipped generations are the fresh frames the producer overwrote
+      if (slot.frameGen > m_ConsumedGen + 1)
+         rd->m_DroppedFrames += slot.frameGen - m_ConsumedGen - 1;
+
+      m_ConsumedGen = slot.frameGen;
+
+      rd->m_pSize       = slot.res;
+      rd->m_FrameSize   = slot.buffer.size();
+      rd->m_Timestamp   = slot.timestamp;
+      rd->m_FrameGen    = slot.frameGen;
+      rd->m_FrameBuffer = slot.buffer;
+
+      // The slot is only read from now on, it must not detach
+      rd->m_pFrame = rd->convertFrame(
+         const_cast<char*>(rd->m_FrameBuffer.constData()), Video::Renderer::ColorSpace::RGBA
+      );
+
+      rd->updateScaledOutputs();
+      rd->updateSharedFrame  ();
+   }
+
+   q_ptr->Video::Renderer::d_ptr->notifyFrame();
+}
+
+/*****************************************************************************
+ *                                                                           *
+ *                                 Getters                                   *
+ *                                                                           *
+ ****************************************************************************/
+
+///Frames published by the daemon and overwritten before being rendered
+///They are the dropped frames of statistics(), counted on the producer side
+uint Video::DirectRenderer::producerDroppedFrames() const
+{
+   return d_ptr->m_ProducerDropped;
 }
 
 Video::Renderer::ColorSpace Video::DirectRenderer::colorSpace() const
 {
-   return Video::Renderer::ColorSpace::RGBA;
+   return Video::Renderer::d_ptr->colorSpace(Video::Renderer::ColorSpace::RGBA);
 }
 
 #include <directrenderer.moc>
@@ -49,9 +49,10 @@ public:
    virtual ~DirectRenderer();
 
    //Getter
-   virtual ColorSpace colorSpace() const override;
+   virtual ColorSpace colorSpace           () const override;
+   uint               producerDroppedFrames() const;
 
-   void onNewFrame(const QByteArray& frame);
+   void onNewFrame(const uchar* frame, const QSize& res);
 
 public Q_SLOTS:
    virtual void startRendering() override;
@@ -0,0 +1,94 @@
+/****************************************************************************
+ *   Copyright (C) 2012-2015 by Savoir-Faire Linux                          *
+ *   Author : Emmanuel Lepage Vallee <emmanuel.lepage@savoirfairelinux.com> *
+ *                                                                          *
+ *   This library is free software; you can redistribute it and/or          *
+ *   modify it under the terms of the GNU Lesser General Public             *
+ *   License as published by the Free Software Foundation; either           *
+ *   version 2.1 of the License, or (at your option) any later version.     *
+ *                                                                          *
+ *   This library is distributed in the hope that it will be useful,        *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU      *
+ *   Lesser General Public License for more details.                        *
+ *                                                                          *
+ *   You should have received a copy of the GNU General Public License      *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>.  *
+ ***************************************************************************/
+#ifndef SHMHEADER_H
+#define SHMHEADER_H
+
+#include <semaphore.h>
+#include <stdint.h>
+
+#include <atomic>
+
+///Magic of the SHMHeaderExt, "RSHM"
+constexpr static const uint32_t SHM_MAGIC            = 0x4d485352;
+
+///Highest version of the protocol implemented by this library
+constexpr static const uint32_t SHM_PROTOCOL_VERSION = 2;
+
+///Suffix of the frame notification FIFO, appended to the shm path
+constexpr static const char     SHM_NOTIFY_SUFFIX[]  = ".notify";
+
+/* Shared memory object
+ * Implementation note: double-buffering
+ * Shared memory is divided in two regions, each representing one frame.
+ * First byte of each frame is warranted to by aligned on 16 bytes.
+ * One region is marked readable: this region can be safely read.
+ * The other region is writeable: only the producer can use it.
+ */
+
+struct SHMHeader {
+   sem_t    mutex        ; /*!< Lock it before any operations on following fields.           */
+   sem_t    frameGenMutex; /*!< unlocked by producer when frameGen modified                  */
+   unsigned frameGen     ; /*!< monotonically incremented when a producer changes readOffset */
+   unsigned frameSize    ; /*!< size in bytes of 1 frame                                     */
+   unsigned mapSize      ; /*!< size to map if you need to see all data                      */
+   unsigned readOffset   ; /*!< offset of readable frame in data                             */
+   unsigned writeOffset  ; /*!< offset of writable frame in data                             */
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-pedantic"
+   char data[];           /*!< the whole shared memory                                       */
+#pragma GCC diagnostic pop
+};
+
+/* Frame notifications
+ * Implementation note: FIFO
+ * The frameGenMutex semaphore cannot be polled, so each stream need a
+ * thread blocked on it to learn about new frames. A daemon can also create a
+ * FIFO next to the shared memory (named after it, with the ".notify" suffix)
+ * and write a byte to it for every frame. It is watched with a
+ * QSocketNotifier, so the frames are read as soon as they are published.
+ * The content of the FIFO is meaningless, it is drained before each read.
+ */
+
+/* Versioned protocol
+ * Implementation note: seqlock
+ * Producers implementing version 2 of the protocol put a SHMHeaderExt at
+ * the beginning of SHMHeader::data, the frames follow it. The producer make
+ * seq odd before updating the SHMHeader fields and even again once done,
+ * while still holding the mutex for older readers.
+ * Version 2 readers never take the mutex: they copy the fields and start
+ * over if seq was odd or changed in the meantime. The frame itself is
+ * copied out, then checked the same way, as two buffer swaps hand the read
+ * buffer back to the producer.
+ * Version 2 producers may only grow the shared memory, as a reader may
+ * still be touching the old tail when the header change.
+ * Older producers have no extension, the magic is checked once, under the
+ * mutex, when the shared memory is opened.
+ */
+
+struct SHMHeaderExt {
+   uint32_t              magic        ; /*!< SHM_MAGIC                                       */
+   uint32_t              version      ; /*!< Highest protocol version supported by the producer */
+   std::atomic<uint32_t> seq          ; /*!< Odd while the producer update the header        */
+   uint32_t              clientVersion; /*!< Protocol version selected by the reader         */
+};
+
+static_assert(sizeof(SHMHeaderExt) % 16 == 0, "The frames must stay aligned on 16 bytes");
+static_assert(sizeof(std::atomic<uint32_t>) == sizeof(uint32_t), "The seq word is shared with the daemon");
+
+#endif
@@ -21,6 +21,7 @@
 #include <QtCore/QDebug>
 #include <QtCore/QMutex>
 #include <QtCore/QThread>
+#include <QtCore/QSocketNotifier>
 
 #include <sys/ipc.h>
 #include <sys/sem.h>
@@ -28,6 +29,7 @@
 #include <fcntl.h>
 #include <unistd.h>
 #include <sys/mman.h>
+#include <sys/stat.h>
 #include <semaphore.h>
 #include <errno.h>
 
@@ -35,40 +37,55 @@
 #define CLOCK_REALTIME 0
 #endif
 
-#include <QtCore/QTimer>
 #include <chrono>
+#include <atomic>
+#include <algorithm>
+#include <cstring>
 
 #include "private/videorenderermanager.h"
 #include "video/resolution.h"
 #include "private/videorenderer_p.h"
+#include "private/shmheader.h"
 
 // Uncomment following line to output in console the FPS value
 //#define DEBUG_FPS
 
-/* Shared memory object
- * Implementation note: double-buffering
- * Shared memory is divided in two regions, each representing one frame.
- * First byte of each frame is warranted to by aligned on 16 bytes.
- * One region is marked readable: this region can be safely read.
- * The other region is writeable: only the producer can use it.
+namespace Video {
+
+class ShmRendererPrivate;
+
+/**
+ * Block on the producer semaphore and wake the renderer up for each frame.
+ *
+ * The semaphore can't be watched by an event loop, so each stream without
+ * a notification FIFO get a waiter. It never poll, the renderer worker is
+ * only woken up when the daemon publish a frame. The waiter map the header
+ * on its own, so it is never affected when the renderer remap the frames.
  */
+class ShmWaiter : public QThread
+{
+public:
+   ShmWaiter(ShmRendererPrivate* renderer, int fd);
+   virtual ~ShmWaiter();
 
-struct SHMHeader {
-   sem_t    mutex        ; /*!< Lock it before any operations on following fields.           */
-   sem_t    frameGenMutex; /*!< unlocked by producer when frameGen modified                  */
-   unsigned frameGen     ; /*!< monotonically incremented when a producer changes readOffset */
-   unsigned frameSize    ; /*!< size in bytes of 1 frame                                     */
-   unsigned mapSize      ; /*!< size to map if you need to see all data                      */
-   unsigned readOffset   ; /*!< offset of readable frame in data                             */
-   unsigned writeOffset  ; /*!< offset of writable frame in data                             */
-
-#pragma GCC diagnostic push
-#pragma GCC diagnostic ignored "-pedantic"
-   char data[];           /*!< the whole shared memory                                       */
-#pragma GCC diagnostic pop
-};
+   //Getters
+   bool isValid() const;
 
-namespace Video {
+   //Mutators
+   void stop();
+
+protected:
+   virtual void run() override;
+
+private:
+   //Constants
+   constexpr static const int WAIT_TIMEOUT_SEC = 1; /*!< Only a safety net, stop() wake it up */
+
+   //Attributes
+   ShmRendererPrivate* m_pRenderer;
+   SHMHeader*          m_pHeader  ;
+   std::atomic_bool    m_Stop     ;
+};
 
 class ShmRendererPrivate : public QObject
 {
@@ -81,30 +98,74 @@ public:
    using TimePoint = std::chrono::time_point<std::chrono::system_clock>;
 
    // Attributes
-   QString    m_ShmPath       ;
-   int        m_fd            ;
-   SHMHeader* m_pShmArea      ;
-   unsigned   m_ShmAreaLen    ;
-   uint       m_FrameGen      ;
-   int        m_fpsC          ;
-   int        m_Fps           ;
-   TimePoint  m_lastFrameDebug;
+   QString               m_ShmPath       ;
+   int                   m_fd            ;
+   SHMHeader*            m_pShmArea      ;
+   size_t                m_ShmAreaLen    ; /*!< Mapped length, always page aligned            */
+   size_t                m_ReserveLen    ; /*!< Reserved address range, starting at the header */
+   uint                  m_FrameGen      ;
+   int                   m_fpsC          ;
+   int                   m_Fps           ;
+   TimePoint             m_lastFrameDebug;
+   QMutex                m_ShmMutex      ; /*!< Protect the mapping from the delivery loop     */
+   std::atomic_bool      m_Pending       ; /*!< A deliverFrames() is already queued             */
+   ShmWaiter*            m_pWaiter       ; /*!< Frame notifications, without a FIFO             */
+   ShmRenderer::Protocol m_Protocol      ;
+   size_t                m_DataOffset    ; /*!< Offset of the frames in SHMHeader::data        */
+   QByteArray            m_lFrames[2]    ; /*!< Frames copied from the producer, front/back */
+   int                   m_BackFrame     ;
+   QSocketNotifier*      m_pNotifier     ; /*!< Frame notifications, if the daemon provide them */
+   int                   m_NotifyFd      ; /*!< The FIFO, -1 if none was found at the last probe */
 
    // Constants
-   constexpr static const int FPS_RATE_SEC        = 1  ;
-   constexpr static const int FRAME_CHECK_RATE_HZ = 120;
+   constexpr static const int      FPS_RATE_SEC        = 1                ;
+   constexpr static const size_t   SHM_RESERVE_MIN     = 32 * 1024 * 1024 ; /*!< Enough for 1080p double buffering */
+   constexpr static const size_t   SHM_RESERVE_MAX     = sizeof(void*) > 4 ?
+      256 * 1024 * 1024 : 64 * 1024 * 1024; /*!< Keep 32 bit address spaces usable */
+   constexpr static const int      SEQLOCK_RETRIES     = 8                ;
+
+   ///Copy of the SHMHeader fields, read without the mutex
+   struct Snapshot {
+      uint32_t seq       ;
+      unsigned frameGen  ;
+      unsigned frameSize ;
+      unsigned mapSize   ;
+      unsigned readOffset;
+   };
 
    // Helpers
-   timespec createTimeout(           );
-   bool     shmLock      (           );
-   void     shmUnlock    (           );
-   bool     getNewFrame  ( bool wait );
-   bool     remapShm     (           );
+   bool          shmLock           (                          );
+   void          shmUnlock         (                          );
+   bool          hasNewFrame       (                          ) const;
+   bool          getNewFrame       (                          );
+   bool          getNewFrameLocked (                          );
+   QByteArray&   backFrame         ( unsigned int size        );
+   bool          getNewFrameSeqlock(                          );
+   bool          readHeader        ( Snapshot& snapshot       ) const;
+   bool          isConsistent      ( const Snapshot& snapshot ) const;
+   SHMHeaderExt* ext               (                          ) const;
+   bool          negotiate         (                          );
+   bool          remapShm          ( size_t mapSize           );
+   bool          mapShm            ( size_t len               );
+   void          unmapShm          (                          );
+   void          requestFrames     (                          );
+   void          startNotifications(                          );
+   void          stopNotifications (                          );
+   void          probeNotifier     (                          );
+   static size_t pageAlign         ( size_t len               );
+   static size_t reserveLength     ( size_t mapLen            );
 
 private:
    Video::ShmRenderer* q_ptr;
+
+private Q_SLOTS:
+   void deliverFrames();
+   void slotNotified ();
 };
 
+constexpr const size_t ShmRendererPrivate::SHM_RESERVE_MIN;
+constexpr const size_t ShmRendererPrivate::SHM_RESERVE_MAX;
+
 ShmRendererPrivate::ShmRendererPrivate(ShmRenderer* parent)
    : QObject     ( parent                              )
    , q_ptr       ( parent                              )
@@ -113,7 +174,15 @@ ShmRendererPrivate::ShmRendererPrivate(ShmRenderer* parent)
    , m_Fps       ( 0                                   )
    , m_pShmArea  ( (SHMHeader*)MAP_FAILED              )
    , m_ShmAreaLen( 0                                   )
+   , m_ReserveLen( 0                                   )
    , m_FrameGen  ( 0                                   )
+   , m_Pending   ( false                               )
+   , m_pWaiter   ( nullptr                             )
+   , m_Protocol  ( ShmRenderer::Protocol::SEMAPHORE    )
+   , m_DataOffset( 0                                   )
+   , m_BackFrame ( 0                                   )
+   , m_pNotifier ( nullptr                             )
+   , m_NotifyFd  ( -1                                  )
 #ifdef DEBUG_FPS
    , m_frameCount( 0                                   )
    , m_lastFrameDebug(std::chrono::system_clock::now() )
@@ -121,6 +190,63 @@ ShmRendererPrivate::ShmRendererPrivate(ShmRenderer* parent)
 {
 }
 
+ShmWaiter::ShmWaiter(ShmRendererPrivate* renderer, int fd) : QThread(nullptr),
+m_pRenderer(renderer), m_Stop(false)
+{
+   setObjectName("ShmWaiter");
+
+   m_pHeader = (SHMHeader*) ::mmap(nullptr, sizeof(SHMHeader), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+
+   if (m_pHeader == MAP_FAILED)
+      qDebug() << "Could not map the shared area header:" << strerror(errno);
+}
+
+ShmWaiter::~ShmWaiter()
+{
+   if (m_pHeader != MAP_FAILED)
+      ::munmap(m_pHeader, sizeof(SHMHeader));
+}
+
+bool ShmWaiter::isValid() const
+{
+   return m_pHeader != MAP_FAILED;
+}
+
+/// Wake the waiter up and wait for it to exit, this is never long
+void ShmWaiter::stop()
+{
+   m_Stop = true;
+
+   // The extra count is drained by the next reader
+   if (isRunning())
+      ::sem_post(&m_pHeader->frameGenMutex);
+
+   wait();
+}
+
+void ShmWaiter::run()
+{
+   while (!m_Stop) {
+      timespec timeout;
+      ::clock_gettime(CLOCK_REALTIME, &timeout);
+      timeout.tv_sec += WAIT_TIMEOUT_SEC;
+
+      if (::sem_timedwait(&m_pHeader->frameGenMutex, &timeout) < 0) {
+         if (errno == ETIMEDOUT || errno == EINTR)
+            continue;
+
+         qDebug() << "Could not wait for a frame:" << strerror(errno);
+         return;
+      }
+
+      // Only the frame generation matter, keep the semaphore from growing
+      while (::sem_trywait(&m_pHeader->frameGenMutex) == 0);
+
+      if (!m_Stop)
+         m_pRenderer->requestFrames();
+   }
+}
+
 /// Constructor
 ShmRenderer::ShmRenderer(const QByteArray& id, const QString& shmPath, const QSize& res)
    : Renderer(id, res)
@@ -133,102 +259,557 @@ ShmRenderer::ShmRenderer(const QByteArray& id, const QString& shmPath, const QSi
 /// Destructor
 ShmRenderer::~ShmRenderer()
 {
+   Video::Renderer::d_ptr->detachCompositors();
    stopShm();
 }
 
-/// Wait new frame data from shared memory and save pointer
-bool ShmRendererPrivate::getNewFrame(bool wait)
+/// Check if the producer published a frame since the last one was read
+/// This never block, a torn read only cause a spurious getNewFrame() call
+bool ShmRendererPrivate::hasNewFrame() const
 {
-   if (!shmLock())
-      return false;
+   return __atomic_load_n(&m_pShmArea->frameGen, __ATOMIC_RELAXED) != m_FrameGen;
+}
 
-   if (m_FrameGen == m_pShmArea->frameGen) {
-      shmUnlock();
+/// Save the pointer to the latest frame
+/// The renderer mutex is taken first so the daemon lock is never held
+/// while a client is reading the previous frame.
+bool ShmRendererPrivate::getNewFrame()
+{
+   QMutexLocker lk {q_ptr->mutex()};
 
-      if (not wait)
-         return false;
+   // The leased frames are copies, the producer memory can be reused and
+   // remapped freely
+   const bool ret = m_Protocol == ShmRenderer::Protocol::SEQLOCK ?
+      getNewFrameSeqlock() : getNewFrameLocked();
 
-      // wait for a new frame, max 33ms
-      static const struct timespec timeout = {0, 33000000};
-      if (::sem_timedwait(&m_pShmArea->frameGenMutex, &timeout) < 0)
-         return false;
+   if (!ret)
+      return false;
 
-      if (!shmLock())
-         return false;
+   q_ptr->Video::Renderer::d_ptr->updateScaledOutputs();
+   q_ptr->Video::Renderer::d_ptr->updateSharedFrame  ();
+
+   ++m_fpsC;
 
+   // Compute the FPS shown to the client
+   auto currentTime = std::chrono::system_clock::now();
+   const std::chrono::duration<double> seconds = currentTime - m_lastFrameDebug;
+   if (seconds.count() >= FPS_RATE_SEC) {
+      m_Fps = m_fpsC / seconds.count();
+      m_fpsC = 0;
+      m_lastFrameDebug = currentTime;
+#ifdef DEBUG_FPS
+      qDebug() << this << ": FPS " << m_fps;
+#endif
    }
 
+   return true;
+}
+
+/// Fetch the frame with the producer mutex held, for older daemons
+bool ShmRendererPrivate::getNewFrameLocked()
+{
+   if (!shmLock())
+      return false;
+
    // valid frame to render (daemon may have stopped)?
-   if (! m_pShmArea->frameSize) {
+   if (m_FrameGen == m_pShmArea->frameGen || ! m_pShmArea->frameSize) {
       shmUnlock();
       return false;
    }
 
+   // frames published by the daemon since the last one were missed
+   if (m_FrameGen && m_pShmArea->frameGen > m_FrameGen + 1)
+      q_ptr->Video::Renderer::d_ptr->m_DroppedFrames += m_pShmArea->frameGen - m_FrameGen - 1;
+
    // map frame data
-   if (!remapShm()) {
+   if (!remapShm(m_pShmArea->mapSize)) {
       qDebug() << "Could not resize shared memory";
       return false;
    }
 
-   q_ptr->Video::Renderer::d_ptr->m_pFrame    = (char*)(m_pShmArea->data + m_pShmArea->readOffset);
-   m_FrameGen                                 = m_pShmArea->frameGen;
-   q_ptr->Video::Renderer::d_ptr->m_FrameSize = m_pShmArea->frameSize;
+   Video::RendererPrivate* rd = q_ptr->Video::Renderer::d_ptr;
+
+   m_FrameGen       = m_pShmArea->frameGen;
+   rd->m_FrameSize  = m_pShmArea->frameSize;
+   rd->m_FrameGen   = m_FrameGen;
+   rd->m_Timestamp  = RendererPrivate::now();
+
+   // The daemon cannot publish while the lock is held, only copy the frame
+   // and convert it once the lock is released. The copy is always done, the
+   // leases, scaled outputs and sinks read the frame after the unlock.
+   QByteArray& back = backFrame(rd->m_FrameSize);
+   ::memcpy(back.data(), m_pShmArea->data + m_pShmArea->readOffset, rd->m_FrameSize);
 
    shmUnlock();
 
-   ++m_fpsC;
+   m_BackFrame       ^= 1;
+   rd->m_FrameBuffer  = back;
+   rd->m_pFrame       = rd->convertFrame(
+      const_cast<char*>(rd->m_FrameBuffer.constData()), Video::Renderer::ColorSpace::BGRA
+   );
 
-   // Compute the FPS shown to the client
-   auto currentTime = std::chrono::system_clock::now();
-   const std::chrono::duration<double> seconds = currentTime - m_lastFrameDebug;
-   if (seconds.count() >= FPS_RATE_SEC) {
-      m_Fps = m_fpsC / seconds.count();
-      m_fpsC = 0;
-      m_lastFrameDebug = currentTime;
-#ifdef DEBUG_FPS
-      qDebug() << this << ": FPS " << m_fps;
-#endif
+   return true;
+}
+
+/// The buffer to copy the next frame to, a leased one is never written again
+QByteArray& ShmRendererPrivate::backFrame(unsigned int size)
+{
+   QByteArray& back = m_lFrames[m_BackFrame];
+
+   if (back.isDetached())
+      back.resize(size);
+   else
+      back = QByteArray(size, Qt::Uninitialized);
+
+   return back;
+}
+
+/**
+ * Fetch the frame without taking the producer mutex.
+ *
+ * The header is read optimistically, then the frame is copied to the back
+ * buffer and the sequence checked again. If the producer swapped the
+ * buffers in between, the copy may be torn and the whole read is done
+ * again. Only a consistent copy is exposed, and converted, the current frame
+ * is left untouched otherwise.
+ */
+bool ShmRendererPrivate::getNewFrameSeqlock()
+{
+   Video::RendererPrivate* rd = q_ptr->Video::Renderer::d_ptr;
+
+   for (int i = 0; i < SEQLOCK_RETRIES; i++) {
+      Snapshot h;
+
+      if (!readHeader(h))
+         return false;
+
+      // valid frame to render (daemon may have stopped)?
+      if (m_FrameGen == h.frameGen || !h.frameSize)
+         return false;
+
+      if (!remapShm(h.mapSize)) {
+         qDebug() << "Could not resize shared memory";
+         return false;
+      }
+
+      if (h.readOffset + h.frameSize > m_ShmAreaLen - sizeof(SHMHeader) - m_DataOffset)
+         continue;
+
+      QByteArray& back = backFrame(h.frameSize);
+
+      ::memcpy(back.data(), m_pShmArea->data + m_DataOffset + h.readOffset, h.frameSize);
+
+      if (!isConsistent(h))
+         continue;
+
+      // frames published by the daemon since the last one were missed
+      if (m_FrameGen && h.frameGen > m_FrameGen + 1)
+         rd->m_DroppedFrames += h.frameGen - m_FrameGen - 1;
+
+      m_FrameGen         = h.frameGen;
+      m_BackFrame       ^= 1;
+      rd->m_FrameGen     = m_FrameGen;
+      rd->m_Timestamp    = RendererPrivate::now();
+      rd->m_FrameSize    = h.frameSize;
+      rd->m_FrameBuffer  = back;
+      rd->m_pFrame       = rd->convertFrame(
+         const_cast<char*>(rd->m_FrameBuffer.constData()), Video::Renderer::ColorSpace::BGRA
+      );
+
+      return true;
+   }
+
+   // The producer keep updating the header faster than it can be read, keep
+   // the previous frame
+   return false;
+}
+
+/// Copy the header fields, retrying while the producer is updating them
+bool ShmRendererPrivate::readHeader(Snapshot& snapshot) const
+{
+   SHMHeaderExt* e = ext();
+
+   for (int i = 0; i < SEQLOCK_RETRIES; i++) {
+      snapshot.seq = e->seq.load(std::memory_order_acquire);
+
+      if (snapshot.seq & 1) {
+         QThread::yieldCurrentThread();
+         continue;
+      }
+
+      snapshot.frameGen   = __atomic_load_n(&m_pShmArea->frameGen  , __ATOMIC_RELAXED);
+      snapshot.frameSize  = __atomic_load_n(&m_pShmArea->frameSize , __ATOMIC_RELAXED);
+      snapshot.mapSize    = __atomic_load_n(&m_pShmArea->mapSize   , __ATOMIC_RELAXED);
+      snapshot.readOffset = __atomic_load_n(&m_pShmArea->readOffset, __ATOMIC_RELAXED);
+
+      if (isConsistent(snapshot))
+         return true;
+   }
+
+   return false;
+}
+
+/// Check that the producer did not touch the header since the snapshot
+bool ShmRendererPrivate::isConsistent(const Snapshot& snapshot) const
+{
+   std::atomic_thread_fence(std::memory_order_acquire);
+
+   return ext()->seq.load(std::memory_order_relaxed) == snapshot.seq;
+}
+
+/// The protocol extension, only valid for version 2 producers
+SHMHeaderExt* ShmRendererPrivate::ext() const
+{
+   return reinterpret_cast<SHMHeaderExt*>(m_pShmArea->data);
+}
+
+/**
+ * Select the protocol version, must be called with the mapping in place.
+ *
+ * Older daemons have their first frame where the extension would be, so
+ * the shared memory must be large enough and have the magic in place.
+ */
+bool ShmRendererPrivate::negotiate()
+{
+   m_Protocol   = ShmRenderer::Protocol::SEMAPHORE;
+   m_DataOffset = 0;
+
+   struct stat st;
+
+   if (::fstat(m_fd, &st) || static_cast<size_t>(st.st_size) < sizeof(SHMHeader) + sizeof(SHMHeaderExt))
+      return true;
+
+   if (!shmLock())
+      return false;
+
+   SHMHeaderExt* e = ext();
+
+   if (e->magic == SHM_MAGIC && e->version >= 2) {
+      e->clientVersion = e->version < SHM_PROTOCOL_VERSION ? e->version : SHM_PROTOCOL_VERSION;
+      m_Protocol       = ShmRenderer::Protocol::SEQLOCK;
+      m_DataOffset     = sizeof(SHMHeaderExt);
    }
 
-   emit q_ptr->frameUpdated();
+   shmUnlock();
+
    return true;
 }
 
-/// Remap the shared memory
-/// Shared memory in unlocked state if returns false (resize failed).
-bool ShmRendererPrivate::remapShm()
+/// Queue a deliverFrames() in the renderer thread, unless one is already
+/// pending. This can be called from any thread.
+void ShmRendererPrivate::requestFrames()
 {
-   // This loop handles case where deamon resize shared memory
-   // during time we unlock it for remapping.
-   while (m_ShmAreaLen != m_pShmArea->mapSize) {
-      auto mapSize = m_pShmArea->mapSize;
-      shmUnlock();
+   bool expected = false;
 
-      if (::munmap(m_pShmArea, m_ShmAreaLen)) {
-         qDebug() << "Could not unmap shared area: " << strerror(errno);
-         return false;
+   if (m_Pending.compare_exchange_strong(expected, true))
+      QMetaObject::invokeMethod(this, "deliverFrames", Qt::QueuedConnection);
+}
+
+/**
+ * Read the latest frame, if there is one, and notify the clients.
+ *
+ * This run in the renderer thread, only when the daemon signal a frame:
+ * through the FIFO when it provide one, otherwise through the waiter. No
+ * timer is involved, an idle stream cost nothing. Many renderers share a
+ * worker thread, this never block on the producer.
+ */
+void ShmRendererPrivate::deliverFrames()
+{
+   m_Pending = false;
+
+   bool hasFrame = false;
+
+   {
+      QMutexLocker lk {&m_ShmMutex};
+
+      if ((!q_ptr->isRendering()) || m_pShmArea == MAP_FAILED)
+         return;
+
+      // A frame published before this is still read below
+      if (!(m_pNotifier || m_pWaiter))
+         startNotifications();
+
+      hasFrame = hasNewFrame() && getNewFrame();
+
+      // A remap found the FIFO, switch to it and check again for a frame
+      // published meanwhile
+      if (m_pWaiter && m_NotifyFd >= 0) {
+         startNotifications();
+         requestFrames();
       }
+   }
+
+   if (hasFrame)
+      q_ptr->Video::Renderer::d_ptr->notifyFrame();
+}
+
+/// Read the frame after a notification from the daemon
+void ShmRendererPrivate::slotNotified()
+{
+   {
+      QMutexLocker lk {&m_ShmMutex};
+
+      if (!m_pNotifier)
+         return;
+
+      char buffer[64];
+      while (::read(m_pNotifier->socket(), buffer, sizeof(buffer)) > 0);
+   }
+
+   deliverFrames();
+}
+
+/**
+ * Watch the daemon notification FIFO if there is one, start a waiter on the
+ * semaphore otherwise.
+ *
+ * This must be called from the renderer thread, with m_ShmMutex held.
+ */
+void ShmRendererPrivate::startNotifications()
+{
+   if (m_NotifyFd >= 0) {
+      if (m_pWaiter) {
+         m_pWaiter->stop();
+         delete m_pWaiter;
+         m_pWaiter = nullptr;
+      }
+
+      m_pNotifier = new QSocketNotifier(m_NotifyFd, QSocketNotifier::Read, this);
+      connect(m_pNotifier, &QSocketNotifier::activated, this, &ShmRendererPrivate::slotNotified);
+
+      return;
+   }
+
+   if (m_pWaiter)
+      return;
+
+   m_pWaiter = new ShmWaiter(this, m_fd);
+
+   if (!m_pWaiter->isValid()) {
+      delete m_pWaiter;
+      m_pWaiter = nullptr;
+      return;
+   }
+
+   m_pWaiter->start();
+}
+
+/// Stop watching for frames, must be called with m_ShmMutex held
+void ShmRendererPrivate::stopNotifications()
+{
+   if (m_pWaiter) {
+      m_pWaiter->stop();
+      delete m_pWaiter;
+      m_pWaiter = nullptr;
+   }
+
+   const int fd = m_NotifyFd;
+   m_NotifyFd   = -1;
+
+   if (!m_pNotifier) {
+      if (fd >= 0)
+         ::close(fd);
+
+      return;
+   }
+
+   // The notifier belong to the renderer thread, this may be called from
+   // another one
+   connect(m_pNotifier, &QObject::destroyed, [fd]() { ::close(fd); });
+
+   m_pNotifier->deleteLater();
+   m_pNotifier = nullptr;
+}
+
+/**
+ * Look for the daemon notification FIFO.
+ *
+ * No current daemon create it, so this is only done when the shared memory
+ * is opened or remapped, never for each frame. A missing FIFO is remembered
+ * until the next remap. Must be called with m_ShmMutex held.
+ */
+void ShmRendererPrivate::probeNotifier()
+{
+   if (m_NotifyFd >= 0)
+      return;
+
+   const QByteArray path = "/dev/shm" + m_ShmPath.toLatin1() + SHM_NOTIFY_SUFFIX;
+
+   // Also open it for writing, otherwise the FIFO would report a hangup
+   // whenever the daemon close it
+   const int fd = ::open(path, O_RDWR | O_NONBLOCK | O_CLOEXEC);
+
+   if (fd < 0)
+      return;
+
+   struct stat st;
+
+   if (::fstat(fd, &st) || !S_ISFIFO(st.st_mode)) {
+      ::close(fd);
+      return;
+   }
+
+   m_NotifyFd = fd;
+}
+
+/// Round a length up to a whole number of pages
+size_t ShmRendererPrivate::pageAlign(size_t len)
+{
+   static const size_t pageSize = ::sysconf(_SC_PAGESIZE);
+
+   return (len + pageSize - 1) / pageSize * pageSize;
+}
 
-      m_pShmArea = (SHMHeader*) ::mmap(nullptr, mapSize, PROT_READ | PROT_WRITE,
+/**
+ * The address range to reserve for a mapping of mapLen bytes.
+ *
+ * Twice the mapping leave room for the next resolution increase. It is
+ * bounded so a few streams never exhaust a 32 bit address space, a larger
+ * growth then relocate the mapping.
+ */
+size_t ShmRendererPrivate::reserveLength(size_t mapLen)
+{
+   const size_t len = std::min(std::max(2 * mapLen, SHM_RESERVE_MIN), SHM_RESERVE_MAX);
+
+   return pageAlign(std::max(len, mapLen));
+}
+
+/**
+ * Map the first len bytes of the shared memory at the start of a larger
+ * reserved address range.
+ *
+ * The reservation cost no memory, it only keep the following addresses free
+ * so the mapping can later grow in place. If the reservation cannot be made,
+ * only the shared memory is mapped.
+ */
+bool ShmRendererPrivate::mapShm(size_t len)
+{
+   const size_t mapLen     = pageAlign(len);
+   const size_t reserveLen = reserveLength(mapLen);
+
+   void* base = ::mmap(nullptr, reserveLen, PROT_NONE,
+                       MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+
+   if (base == MAP_FAILED) {
+      qDebug() << "Could not reserve the shared area range:" << strerror(errno);
+
+      m_pShmArea = (SHMHeader*) ::mmap(nullptr, mapLen, PROT_READ | PROT_WRITE,
                                        MAP_SHARED, m_fd, 0);
+      m_ReserveLen = m_pShmArea == MAP_FAILED ? 0 : mapLen;
+   }
+   else {
+      m_pShmArea = (SHMHeader*) ::mmap(base, mapLen, PROT_READ | PROT_WRITE,
+                                       MAP_SHARED | MAP_FIXED, m_fd, 0);
 
       if (m_pShmArea == MAP_FAILED) {
-         qDebug() << "Could not remap shared area: " << strerror(errno);
-         return false;
+         ::munmap(base, reserveLen);
+         m_ReserveLen = 0;
       }
+      else
+         m_ReserveLen = reserveLen;
+   }
 
-      if (!shmLock())
-         return false;
-
-      m_ShmAreaLen = mapSize;
+   if (m_pShmArea == MAP_FAILED) {
+      qDebug() << "Could not map shared area:" << strerror(errno);
+      m_ShmAreaLen = 0;
+      return false;
    }
 
+   m_ShmAreaLen = mapLen;
    return true;
 }
 
+/// Unmap the shared memory and the reserved range
+void ShmRendererPrivate::unmapShm()
+{
+   if (m_pShmArea == MAP_FAILED)
+      return;
+
+   ::munmap(m_pShmArea, m_ReserveLen);
+
+   m_ShmAreaLen = 0;
+   m_ReserveLen = 0;
+   m_pShmArea   = (SHMHeader*) MAP_FAILED;
+}
+
+/**
+ * Make sure the whole shared memory is mapped
+ *
+ * The mapping only ever grow. When the daemon enlarge the shared memory,
+ * the new pages are mapped right after the existing ones, inside the
+ * reserved range, without releasing the lock or moving the header. When it
+ * shrink, nothing is done and the tail of the mapping is left unused.
+ *
+ * Only if the new size exceed the reservation is the whole area relocated.
+ *
+ * Shared memory in unlocked state if returns false (resize failed).
+ * In the seqlock mode, the mapping may move and the header must be read
+ * again.
+ */
+bool ShmRendererPrivate::remapShm(size_t mapSize)
+{
+   if (mapSize <= m_ShmAreaLen)
+      return true;
+
+   const auto start = std::chrono::steady_clock::now();
+
+   bool ret = true;
+
+   if (mapSize <= m_ReserveLen) {
+      const size_t mapLen = pageAlign(mapSize);
+
+      // Pages beyond the end of the file are never read, so this is safe
+      // even if the daemon shrink the shared memory in the meantime
+      void* tail = ::mmap(reinterpret_cast<char*>(m_pShmArea) + m_ShmAreaLen,
+                          mapLen - m_ShmAreaLen, PROT_READ | PROT_WRITE,
+                          MAP_SHARED | MAP_FIXED, m_fd, m_ShmAreaLen);
+
+      if (tail == MAP_FAILED) {
+         qDebug() << "Could not grow shared area: " << strerror(errno);
+
+         if (m_Protocol == ShmRenderer::Protocol::SEMAPHORE)
+            shmUnlock();
+
+         ret = false;
+      }
+      else
+         m_ShmAreaLen = mapLen;
+   }
+   else if (m_Protocol == ShmRenderer::Protocol::SEQLOCK) {
+      // Nothing is locked, the header is read again after the move
+      unmapShm();
+
+      ret = mapShm(mapSize);
+   }
+   else {
+      // This loop handles case where deamon resize shared memory
+      // during time we unlock it for remapping.
+      while (ret && m_ShmAreaLen < m_pShmArea->mapSize) {
+         const size_t newSize = m_pShmArea->mapSize;
+         shmUnlock();
+
+         unmapShm();
+
+         ret = mapShm(newSize) && shmLock();
+      }
+   }
+
+   if (ret)
+      probeNotifier();
+
+   ++q_ptr->Video::Renderer::d_ptr->m_RemapCount;
+   q_ptr->Video::Renderer::d_ptr->m_RemapTime += std::chrono::duration_cast<std::chrono::microseconds>(
+      std::chrono::steady_clock::now() - start
+   ).count();
+
+   return ret;
+}
+
 /// Connect to the shared memory
 bool ShmRenderer::startShm()
 {
+   QMutexLocker lk {&d_ptr->m_ShmMutex};
+
    if (d_ptr->m_fd != -1) {
       qDebug() << "fd must be -1";
       return false;
@@ -242,43 +823,54 @@ bool ShmRenderer::startShm()
       return false;
    }
 
-   // Map only header data
-   const auto mapSize = sizeof(SHMHeader);
-   d_ptr->m_pShmArea = (SHMHeader*) ::mmap(nullptr, mapSize,
-      PROT_READ | PROT_WRITE,
-      MAP_SHARED, d_ptr->m_fd, 0
-   );
+   // Map only header data, the frames are mapped once their size is known
+   if (!d_ptr->mapShm(sizeof(SHMHeader) + sizeof(SHMHeaderExt)))
+      return false;
 
-   if (d_ptr->m_pShmArea == MAP_FAILED) {
-      qDebug() << "Could not remap shared area";
+   if (!d_ptr->negotiate())
       return false;
-   }
 
-   d_ptr->m_ShmAreaLen = mapSize;
+   d_ptr->probeNotifier();
+
+   d_ptr->m_FrameGen = 0;
    return true;
 }
 
 /// Disconnect from the shared memory
 void ShmRenderer::stopShm()
 {
+   QMutexLocker lk {&d_ptr->m_ShmMutex};
+
    if (d_ptr->m_fd < 0)
       return;
 
+   // Before the shared memory is closed, the waiter still use it
+   d_ptr->stopNotifications();
+
    ::close(d_ptr->m_fd);
    d_ptr->m_fd = -1;
 
-   if (d_ptr->m_pShmArea == MAP_FAILED)
-      return;
+   // The clients read the frame with the renderer mutex held
+   QMutexLocker frameLk {mutex()};
 
-   ::munmap(d_ptr->m_pShmArea, d_ptr->m_ShmAreaLen);
-   d_ptr->m_ShmAreaLen = 0;
-   d_ptr->m_pShmArea = (SHMHeader*) MAP_FAILED;
+   Video::Renderer::d_ptr->m_pFrame = nullptr;
+   Video::Renderer::d_ptr->m_Content.clear();
+
+   d_ptr->unmapShm();
 }
 
 /// Lock the memory while the copy is being made
 bool ShmRendererPrivate::shmLock()
 {
-   return ::sem_wait(&m_pShmArea->mutex) >= 0;
+   const auto start = std::chrono::steady_clock::now();
+
+   const bool ret = ::sem_wait(&m_pShmArea->mutex) >= 0;
+
+   q_ptr->Video::Renderer::d_ptr->m_LockWaitTime += std::chrono::duration_cast<std::chrono::microseconds>(
+      std::chrono::steady_clock::now() - start
+   ).count();
+
+   return ret;
 }
 
 /// Remove the lock, allow a new frame to be drawn
@@ -296,19 +888,21 @@ void ShmRendererPrivate::shmUnlock()
 /// Start the rendering loop
 void ShmRenderer::startRendering()
 {
-   QMutexLocker locker {mutex()};
-
    if (!startShm())
       return;
 
    Video::Renderer::d_ptr->m_isRendering = true;
+
+   // The frames are read in the renderer thread, not the caller one
+   d_ptr->requestFrames();
+
    emit started();
 }
 
 /// Stop the rendering loop
 void ShmRenderer::stopRendering()
 {
-   QMutexLocker locker {mutex()};
+   // The notifications stop with the shared memory
    Video::Renderer::d_ptr->m_isRendering = false;
 
    emit stopped();
@@ -327,20 +921,23 @@ int ShmRenderer::fps() const
    return d_ptr->m_Fps;
 }
 
-/// Get frame data pointer from shared memory
-const QByteArray& ShmRenderer::currentFrame() const
+/// How the daemon signal new frames
+ShmRenderer::Notification ShmRenderer::notification() const
 {
-   if (!isRendering())
-      return Renderer::currentFrame();
+   QMutexLocker lk {&d_ptr->m_ShmMutex};
+
+   return d_ptr->m_pNotifier ? Notification::FIFO : Notification::SEMAPHORE;
+}
 
-   QMutexLocker lk {mutex()};
-   d_ptr->getNewFrame(false);
-   return Renderer::currentFrame();
+/// The frame protocol selected with the daemon
+ShmRenderer::Protocol ShmRenderer::protocol() const
+{
+   return d_ptr->m_Protocol;
 }
 
 Video::Renderer::ColorSpace ShmRenderer::colorSpace() const
 {
-   return Video::Renderer::ColorSpace::BGRA;
+   return Video::Renderer::d_ptr->colorSpace(Video::Renderer::ColorSpace::BGRA);
 }
 
 /*****************************************************************************
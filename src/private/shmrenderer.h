@@ -45,6 +45,20 @@ class LIB_EXPORT ShmRenderer : public Renderer {
    friend class VideoRendererManagerPrivate ;
 
 public:
+   ///Synchronisation used to read the frames
+   enum class Protocol {
+      SEMAPHORE, /*!< The producer mutex is held while reading, older daemons */
+      SEQLOCK  , /*!< The header is read optimistically and checked after     */
+      COUNT__
+   };
+
+   ///How new frames are signalled
+   enum class Notification {
+      SEMAPHORE, /*!< A thread blocked on the producer semaphore            */
+      FIFO     , /*!< Daemon provided FIFO watched by the event loop        */
+      COUNT__
+   };
+
    //Constructor
    ShmRenderer (const QByteArray& id, const QString& shmPath, const QSize& res);
    virtual ~ShmRenderer();
@@ -54,12 +68,13 @@ public:
    bool startShm ();
 
    //Getters
-   int fps() const;
-   virtual const QByteArray& currentFrame() const override;
+   int          fps         () const;
+   Protocol     protocol    () const;
+   Notification notification() const;
    virtual ColorSpace        colorSpace  () const override;
 
    //Setters
-   void setShmPath(const QString& path);
+   void setShmPath   (const QString& path );
 
 private:
    QScopedPointer<ShmRendererPrivate> d_ptr;
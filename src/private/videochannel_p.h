@@ -26,6 +26,8 @@ public:
    QList<Video::Resolution*>   m_lValidResolutions;
    Video::Resolution*          m_pCurrentResolution;
    Video::Device*              m_pDevice;
+   MapStringVectorString       m_Capabilities;      /*!< Rates by resolution, from the daemon  */
+   bool                        m_Loaded;            /*!< m_lValidResolutions was created       */
 };
 
 #endif
@@ -20,6 +20,9 @@
 
 #include <QtCore/QObject>
 #include <QtCore/QList>
+#include <QtCore/QHash>
+
+#include <typedefs.h>
 
 namespace Video {
    class Channel;
@@ -41,15 +44,47 @@ public:
    explicit VideoDevicePrivate(Video::Device* parent = nullptr);
 
    //Attributes
-   QString                m_DeviceId       ;
-   Video::Channel*        m_pCurrentChannel;
-   QList<Video::Channel*> m_lChannels      ;
-   bool                   m_RequireSave    ;
+   QString                        m_DeviceId       ;
+   Video::Channel*                m_pCurrentChannel;
+   QList<Video::Channel*>         m_lChannels      ;
+   bool                           m_RequireSave    ;
+   MapStringMapStringVectorString m_Capabilities   ; /*!< Last known capabilities */
 
    Video::Device* q_ptr;
 
+   //Helpers
+   void setCapabilities(const MapStringMapStringVectorString& cap);
+
 public Q_SLOTS:
-   void saveIdle();
+   void saveIdle  ();
+   void revalidate();
+};
+
+/**
+ * Capabilities of the devices seen in the previous sessions.
+ *
+ * Fetching the capabilities of a camera can take a while, so they are
+ * stored on disk by device id. The cached value is used right away and is
+ * checked against the daemon later on.
+ */
+class VideoDeviceCache
+{
+public:
+   //Getters
+   static bool capabilities(const QString& id, MapStringMapStringVectorString& cap);
+
+   //Mutators
+   static void insert(const QString& id, const MapStringMapStringVectorString& cap);
+
+private:
+   //Constants
+   constexpr static const quint32 MAGIC   = 0x56444331; /*!< "VDC1" */
+   constexpr static const quint32 VERSION = 1;
+
+   //Helpers
+   static QHash<QString, MapStringMapStringVectorString>& cache();
+   static QString path();
+   static void    save();
 };
 
 #endif
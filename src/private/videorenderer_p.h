@@ -21,14 +21,19 @@
 //Qt
 #include <QtCore/QObject>
 #include <QtCore/QSize>
+#include <QtCore/QVector>
+#include <QtCore/QList>
+#include <QtCore/QHash>
+#include <QtCore/QMutex>
 
 #include <atomic>
 
-class QMutex;
+//Ring
+#include <video/renderer.h>
 
-namespace Video {
+class QTimer;
 
-class Renderer;
+namespace Video {
 
 class RendererPrivate : public QObject
 {
@@ -36,18 +41,79 @@ Q_OBJECT
 public:
    RendererPrivate(Video::Renderer* parent);
 
+   ///A downscaled copy of the frames, shared by all views of this size
+   struct ScaledOutput {
+      QSize        size    ;
+      int          refCount;
+      unsigned int frameGen;
+      QByteArray   frame   ;
+   };
+
+   ///The buffer behind the frames handed out by acquireFrame()
+   struct Lease {
+      QByteArray   buffer   ;
+      unsigned int frameGen ;
+      qint64       timestamp;
+      int          count    ;
+   };
+
    //Attributes
-   std::atomic_bool  m_isRendering;
-   QMutex*           m_pMutex     ;
-   QString           m_Id         ;
-   QSize             m_pSize      ;
-   char*             m_pFrame     ;
-   QByteArray        m_Content    ;
-   unsigned int      m_FrameSize  ;
+   std::atomic_bool            m_isRendering           ;
+   QMutex*                     m_pMutex                ;
+   QString                     m_Id                    ;
+   QSize                       m_pSize                 ;
+   char*                       m_pFrame                ;
+   QByteArray                  m_Content               ;
+   unsigned int                m_FrameSize             ;
+   unsigned int                m_FrameGen              ;
+   qint64                      m_Timestamp             ;
+   QHash<const char*, Lease>   m_hLeases               ; /*!< Leased buffers, by data pointer       */
+   QByteArray                  m_FrameBuffer           ; /*!< Owner of m_pFrame, if it can be shared */
+   QByteArray                  m_ConvertedFrame        ;
+   bool                        m_HasPreferredColorSpace;
+   Video::Renderer::ColorSpace m_PreferredColorSpace   ;
+   QVector<ScaledOutput>       m_lScaledOutputs        ;
+   QList<Video::Renderer::Sink*> m_lSinks              ;
+   QMutex                      m_DispatchMutex         ; /*!< Held while the sinks are called      */
+   Video::Renderer::SharedFrame m_SharedFrame          ; /*!< Last frame handed to the sinks      */
+   std::atomic_int             m_MaxFrameRate          ; /*!< 0 for unlimited                      */
+   std::atomic_int             m_StaleDeadline         ; /*!< In ms, 0 to never skip a frame      */
+   qint64                      m_LastEmit              ;
+   bool                        m_HasPendingFrame       ;
+   QTimer*                     m_pPacingTimer          ;
+   std::atomic_uint            m_CoalescedFrames       ; /*!< Frames replaced before being emitted */
+   std::atomic_uint            m_StaleFrames           ; /*!< Frames skipped past the deadline     */
+
+   //Statistics
+   std::atomic_uint            m_DeliveredFrames       ;
+   std::atomic_uint            m_DroppedFrames         ; /*!< Frames the producer sent but were missed */
+   std::atomic<double>         m_Jitter                ;
+   std::atomic<qint64>         m_LockWaitTime          ; /*!< In µs                                */
+   std::atomic_uint            m_RemapCount            ;
+   std::atomic<qint64>         m_RemapTime             ; /*!< In µs                                */
+   std::atomic_uint            m_lFrameAge[Video::Renderer::FRAME_AGE_BUCKET_COUNT];
+   qint64                      m_LastArrival           ;
+   qint64                      m_LastInterval          ;
+
+   //Helpers
+   Video::Renderer::ColorSpace colorSpace  (Video::Renderer::ColorSpace native) const;
+   char*                       convertFrame(char* frame, Video::Renderer::ColorSpace native);
+   void                        updateScaledOutputs(    );
+   void                        updateSharedFrame  (    );
+   void                        notifyFrame (           );
+   void                        emitFrame   (           );
+   void                        recordFrameAge(         );
+   QByteArray                  leaseBuffer (           ) const;
+   void                        detachCompositors(      );
+
+   static qint64 now();
 
 private:
    Video::Renderer* q_ptr;
 
+private Q_SLOTS:
+   void slotPacingTimeout();
+
 };
 
 }
@@ -20,9 +20,13 @@
 
 //libstdc++
 #include <vector>
+#include <algorithm>
+#include <memory>
 
 //Qt
 #include <QtCore/QMutex>
+#include <QtCore/QCoreApplication>
+#include <QtCore/QVector>
 
 //Ring
 #include <dbus/videomanager.h>
@@ -55,11 +59,35 @@ class VideoRendererManagerPrivate : public QObject
 public:
    VideoRendererManagerPrivate(VideoRendererManager* parent);
 
+#ifdef ENABLE_LIBWRAP
+   ///The renderer fed by a daemon sink, shared with the sink callback
+   struct SinkTarget {
+      QMutex                 mutex   ; /*!< Held while a frame is being handed over */
+      Video::DirectRenderer* renderer;
+   };
+#endif
+
    //Attributes
    bool                               m_PreviewState;
    uint                               m_BufferSize  ;
    QHash<QByteArray,Video::Renderer*> m_hRenderers  ;
-   QHash<Video::Renderer*, QThread*>  m_hThreads    ;
+   QHash<QObject*, int>               m_hAffinity   ; /*!< Renderer worker index    */
+   QVector<QThread*>                  m_lWorkers    ; /*!< Shared renderer threads  */
+   QVector<int>                       m_lWorkerLoad ; /*!< Renderers per worker     */
+   QHash<QByteArray,QList<Video::Renderer::Sink*> > m_hSinks; /*!< Sinks by renderer id */
+#ifdef ENABLE_LIBWRAP
+   QHash<QByteArray,std::shared_ptr<SinkTarget> > m_hSinkTargets; /*!< Daemon sinks by renderer id */
+#endif
+
+   //Helpers
+   void assignWorker (QObject* o        );
+   void releaseWorker(QObject* o        );
+   void attachSinks  (const QByteArray& id, Video::Renderer* r);
+   void detachSinks  (const QByteArray& id, Video::Renderer* r);
+#ifdef ENABLE_LIBWRAP
+   void registerSink  (const QString& id, const QSize& res);
+   void unregisterSink(const QByteArray& id);
+#endif
 
 
 private:
@@ -68,6 +96,7 @@ private:
 public Q_SLOTS:
    void startedDecoding(const QString& id, const QString& shmPath, int width, int height);
    void stoppedDecoding(const QString& id, const QString& shmPath);
+   void slotAboutToQuit();
 
 };
 
@@ -83,6 +112,8 @@ VideoRendererManager::VideoRendererManager():QObject(QCoreApplication::instance(
    VideoManagerInterface& interface = DBus::VideoManager::instance();
    connect( &interface , &VideoManagerInterface::startedDecoding, d_ptr.data(), &VideoRendererManagerPrivate::startedDecoding);
    connect( &interface , &VideoManagerInterface::stoppedDecoding, d_ptr.data(), &VideoRendererManagerPrivate::stoppedDecoding);
+
+   connect(QCoreApplication::instance(), &QCoreApplication::aboutToQuit, d_ptr.data(), &VideoRendererManagerPrivate::slotAboutToQuit);
 }
 
 
@@ -107,6 +138,19 @@ int VideoRendererManager::size() const
    return d_ptr->m_hRenderers.size();
 }
 
+///Return all active renderers, including the preview
+QList<Video::Renderer*> VideoRendererManager::renderers() const
+{
+   QList<Video::Renderer*> ret;
+
+   for (Video::Renderer* r : d_ptr->m_hRenderers) {
+      if (r)
+         ret << r;
+   }
+
+   return ret;
+}
+
 ///Return the call Renderer or nullptr
 Video::Renderer* VideoRendererManager::getRenderer(const Call* call) const
 {
@@ -140,13 +184,13 @@ Video::Renderer* VideoRendererManager::previewRenderer()
       r = new Video::ShmRenderer(PREVIEW_RENDERER_ID,"",res->size());
 #endif
 
-      QThread* t = new QThread(this);
-      d_ptr->m_hThreads[r] = t;
-
-      r->moveToThread(t);
+      d_ptr->assignWorker(r);
+      d_ptr->attachSinks(PREVIEW_RENDERER_ID, r);
 
       d_ptr->m_hRenderers[PREVIEW_RENDERER_ID] = r;
 
+      emit rendererAdded(r);
+
    }
    return d_ptr->m_hRenderers[PREVIEW_RENDERER_ID];
 }
@@ -186,6 +230,188 @@ void VideoRendererManager::setBufferSize(uint size)
    d_ptr->m_BufferSize = size;
 }
 
+/*****************************************************************************
+ *                                                                           *
+ *                               Worker pool                                 *
+ *                                                                           *
+ ****************************************************************************/
+
+/**
+ * Move a renderer to one of the shared worker threads.
+ *
+ * The least loaded worker is used. A new one is only started when all the
+ * existing workers are busy and there is less of them than CPU cores. A
+ * renderer stay on the same worker for its whole lifetime.
+ */
+void VideoRendererManagerPrivate::assignWorker(QObject* o)
+{
+   int worker = -1;
+
+   for (int i = 0; i < m_lWorkers.size(); i++) {
+      if (worker == -1 || m_lWorkerLoad[i] < m_lWorkerLoad[worker])
+         worker = i;
+   }
+
+   const int maxWorkers = std::max(1, QThread::idealThreadCount());
+
+   if (worker == -1 || (m_lWorkerLoad[worker] && m_lWorkers.size() < maxWorkers)) {
+      QThread* t = new QThread(this);
+      t->setObjectName(QString("VideoRenderer:%1").arg(m_lWorkers.size()));
+      t->start();
+
+      worker = m_lWorkers.size();
+      m_lWorkers    << t;
+      m_lWorkerLoad << 0;
+   }
+
+   m_hAffinity[o] = worker;
+   m_lWorkerLoad[worker]++;
+
+   o->moveToThread(m_lWorkers[worker]);
+}
+
+///Forget the renderer worker, the thread is kept for future renderers
+void VideoRendererManagerPrivate::releaseWorker(QObject* o)
+{
+   if (!m_hAffinity.contains(o))
+      return;
+
+   const int worker = m_hAffinity.take(o);
+
+   m_lWorkerLoad[worker]--;
+}
+
+/**
+ * Run an object, such as a compositor, on the renderer worker pool.
+ *
+ * The object must not have a parent. It has to be passed to unschedule()
+ * before being destroyed, with deleteLater() as it then belong to a worker.
+ */
+void VideoRendererManager::schedule(QObject* o)
+{
+   if (o && !o->parent())
+      d_ptr->assignWorker(o);
+}
+
+///Release the worker of an object passed to schedule()
+void VideoRendererManager::unschedule(QObject* o)
+{
+   d_ptr->releaseWorker(o);
+}
+
+///Stop the workers, the renderers are gone by now
+void VideoRendererManagerPrivate::slotAboutToQuit()
+{
+   for (QThread* t : m_lWorkers)
+      t->quit();
+
+   for (QThread* t : m_lWorkers)
+      t->wait();
+}
+
+/*****************************************************************************
+ *                                                                           *
+ *                                  Sinks                                    *
+ *                                                                           *
+ ****************************************************************************/
+
+/**
+ * Register a sink for the renderer of a sink id (a call id or the preview).
+ *
+ * Unlike Video::Renderer::addSink(), the registration outlive the
+ * renderer: the sink is attached to every renderer created for this id
+ * until removeSink() is called. Many sinks can share the same renderer,
+ * each frame is still fetched and converted once.
+ */
+void VideoRendererManager::addSink(const QByteArray& id, Video::Renderer::Sink* sink)
+{
+   QList<Video::Renderer::Sink*>& sinks = d_ptr->m_hSinks[id];
+
+   if ((!sink) || sinks.contains(sink))
+      return;
+
+   sinks << sink;
+
+   if (Video::Renderer* r = d_ptr->m_hRenderers.value(id))
+      r->addSink(sink);
+}
+
+/**
+ * Unregister a sink added with addSink().
+ *
+ * Like Video::Renderer::removeSink(), this wait for a delivery in progress,
+ * the sink can be destroyed once this returned.
+ */
+void VideoRendererManager::removeSink(const QByteArray& id, Video::Renderer::Sink* sink)
+{
+   if (!d_ptr->m_hSinks.contains(id))
+      return;
+
+   QList<Video::Renderer::Sink*>& sinks = d_ptr->m_hSinks[id];
+
+   sinks.removeAll(sink);
+
+   if (sinks.isEmpty())
+      d_ptr->m_hSinks.remove(id);
+
+   if (Video::Renderer* r = d_ptr->m_hRenderers.value(id))
+      r->removeSink(sink);
+}
+
+///Attach the registered sinks to a new renderer
+void VideoRendererManagerPrivate::attachSinks(const QByteArray& id, Video::Renderer* r)
+{
+   for (Video::Renderer::Sink* sink : m_hSinks.value(id))
+      r->addSink(sink);
+}
+
+///Detach the registered sinks from a renderer about to be destroyed
+void VideoRendererManagerPrivate::detachSinks(const QByteArray& id, Video::Renderer* r)
+{
+   for (Video::Renderer::Sink* sink : m_hSinks.value(id))
+      r->removeSink(sink);
+}
+
+#ifdef ENABLE_LIBWRAP
+/**
+ * Forward the frames of a daemon sink to its renderer.
+ *
+ * The callback run in the daemon thread. It never touch m_hRenderers, it
+ * only use the target registered here, whose renderer is reset by
+ * unregisterSink() before the renderer is destroyed.
+ */
+void VideoRendererManagerPrivate::registerSink(const QString& id, const QSize& res)
+{
+   const QByteArray rid = id.toLatin1();
+
+   unregisterSink(rid);
+
+   std::shared_ptr<SinkTarget> target = std::make_shared<SinkTarget>();
+   target->renderer = static_cast<Video::DirectRenderer*>(m_hRenderers.value(rid));
+
+   m_hSinkTargets[rid] = target;
+
+   DBus::VideoManager::instance().registerSinkTarget(id, [target, res] (const unsigned char* frame) {
+      QMutexLocker lk {&target->mutex};
+
+      if (target->renderer)
+         target->renderer->onNewFrame(frame, res);
+   });
+}
+
+///Detach a renderer from its daemon sink, wait for the frame being handed over
+void VideoRendererManagerPrivate::unregisterSink(const QByteArray& id)
+{
+   const std::shared_ptr<SinkTarget> target = m_hSinkTargets.take(id);
+
+   if (!target)
+      return;
+
+   QMutexLocker lk {&target->mutex};
+   target->renderer = nullptr;
+}
+#endif
+
 ///A video is not being rendered
 void VideoRendererManagerPrivate::startedDecoding(const QString& id, const QString& shmPath, int width, int height)
 {
@@ -206,11 +432,7 @@ void VideoRendererManagerPrivate::startedDecoding(const QString& id, const QStri
       qWarning() << "Calling registerFrameListener";
       m_hRenderers[rid] = r;
 
-      DBus::VideoManager::instance().registerSinkTarget(id, [this, id, width, height] (const unsigned char* frame) {
-         static_cast<Video::DirectRenderer*>(m_hRenderers[id.toLatin1()])->onNewFrame(
-            QByteArray::fromRawData(reinterpret_cast<const char *>(frame), width*height)
-         );
-      });
+      registerSink(id, res);
 
 #else //ENABLE_LIBWRAP
 
@@ -219,14 +441,10 @@ void VideoRendererManagerPrivate::startedDecoding(const QString& id, const QStri
 
 #endif
 
+      assignWorker(r);
+      attachSinks(rid, r);
 
-      QThread* t = new QThread(this);
-      m_hThreads[r] = t;
-
-      r->moveToThread(t);
-
-      if (!t->isRunning())
-         t->start();
+      emit q_ptr->rendererAdded(r);
 
    }
    else {
@@ -235,11 +453,7 @@ void VideoRendererManagerPrivate::startedDecoding(const QString& id, const QStri
 
 #ifdef ENABLE_LIBWRAP
 
-      DBus::VideoManager::instance().registerSinkTarget(id, [this, id, width, height] (const unsigned char* frame) {
-         static_cast<Video::DirectRenderer*>(m_hRenderers[id.toLatin1()])->onNewFrame(
-            QByteArray::fromRawData(reinterpret_cast<const char *>(frame), width*height)
-         );
-      });
+      registerSink(id, res);
 
 #else //ENABLE_LIBWRAP
 
@@ -284,7 +498,8 @@ void VideoRendererManagerPrivate::stoppedDecoding(const QString& id, const QStri
       return;
    }
 
-   r->stopRendering();
+   // Stopping may wait for the delivery loop, let the worker do it
+   QMetaObject::invokeMethod(r, "stopRendering", Qt::QueuedConnection);
 
    qDebug() << "Video stopped for call" << id <<  "Renderer found:" << (m_hRenderers[id.toLatin1()] != nullptr);
 
@@ -301,17 +516,22 @@ void VideoRendererManagerPrivate::stoppedDecoding(const QString& id, const QStri
 
    m_hRenderers[id.toLatin1()] = nullptr;
 
-   QThread* t = m_hThreads[r];
-   m_hThreads[r] = nullptr;
+   // The renderer is no longer found by removeSink(), it must not call the
+   // registered sinks anymore
+   detachSinks(id.toLatin1(), r);
 
-   if (t) {
-      t->quit();
-      t->wait();
-   }
+#ifdef ENABLE_LIBWRAP
+   // The daemon sink may outlive the renderer
+   unregisterSink(id.toLatin1());
+#endif
+
+   emit q_ptr->rendererRemoved(r);
 
-   delete r;
+   releaseWorker(r);
 
-   t->deleteLater();
+   // The renderer is destroyed by its worker once the pending frames are
+   // processed, the GUI never wait for it
+   r->deleteLater();
 }
 
 void VideoRendererManager::switchDevice(const Video::Device* device) const
@@ -26,9 +26,7 @@
 
 //Ring
 #include "video/device.h"
-namespace Video {
-   class Renderer;
-}
+#include "video/renderer.h"
 class Call;
 class QMutex;
 struct SHMHeader;
@@ -48,15 +46,24 @@ public:
    static VideoRendererManager* instance();
 
    //Getters
-   bool             isPreviewing   () const;
-   Video::Renderer* previewRenderer()      ;
-   int              size           () const;
+   bool                    isPreviewing   () const;
+   Video::Renderer*        previewRenderer()      ;
+   int                     size           () const;
+   QList<Video::Renderer*> renderers      () const;
 
    //Helpers
    Video::Renderer* getRenderer(const Call* call) const;
    void setBufferSize(uint size);
    void switchDevice(const Video::Device* device) const;
 
+   //Worker pool
+   void schedule  (QObject* o);
+   void unschedule(QObject* o);
+
+   //Sinks
+   void addSink   (const QByteArray& id, Video::Renderer::Sink* sink);
+   void removeSink(const QByteArray& id, Video::Renderer::Sink* sink);
+
 private:
    //Constructor
    explicit VideoRendererManager();
@@ -77,6 +84,9 @@ Q_SIGNALS:
    void previewStateChanged(bool startStop);
    void previewStarted(Video::Renderer* Renderer);
    void previewStopped(Video::Renderer* Renderer);
+   ///A renderer was created or is about to be destroyed
+   void rendererAdded  (Video::Renderer* renderer);
+   void rendererRemoved(Video::Renderer* renderer);
 
 };
 
@@ -31,6 +31,7 @@
 #include <callmanager_interface.h>
 #include "typedefs.h"
 #include "conversions_wrap.hpp"
+#include "signalqueue_wrap.h"
 
 /*
  * Proxy class for interface cx.ring.Ring.CallManager
@@ -51,155 +52,155 @@ public:
          callHandlers = {
             exportable_callback<CallSignal::StateChange>(
                 [this] (const std::string &callID, const std::string &state, int code) {
-                    QTimer::singleShot(0, [this,callID, state, code] {
+                    SignalQueue::instance().post("callStateChanged", [this,callID, state, code] {
                         LOG_DRING_SIGNAL3("callStateChanged",QString(callID.c_str()) , QString(state.c_str()) , code);
-                        Q_EMIT this->callStateChanged(QString(callID.c_str()), QString(state.c_str()), code);
+                        Q_EMIT this->callStateChanged(toQString(callID), toQString(state), code);
                     });
             }),
             exportable_callback<CallSignal::TransferFailed>(
                 [this] () {
-                       QTimer::singleShot(0, [this] {
+                       SignalQueue::instance().post("transferFailed", [this] {
                              LOG_DRING_SIGNAL("transferFailed","");
                              Q_EMIT this->transferFailed();
                        });
             }),
             exportable_callback<CallSignal::TransferSucceeded>(
                 [this] () {
-                       QTimer::singleShot(0, [this] {
+                       SignalQueue::instance().post("transferSucceeded", [this] {
                              LOG_DRING_SIGNAL("transferSucceeded","");
                              Q_EMIT this->transferSucceeded();
                        });
             }),
             exportable_callback<CallSignal::RecordPlaybackStopped>(
                 [this] (const std::string &filepath) {
-                       QTimer::singleShot(0, [this,filepath] {
+                       SignalQueue::instance().post("recordPlaybackStopped", [this,filepath] {
                              LOG_DRING_SIGNAL("recordPlaybackStopped",QString(filepath.c_str()));
-                             Q_EMIT this->recordPlaybackStopped(QString(filepath.c_str()));
+                             Q_EMIT this->recordPlaybackStopped(toQString(filepath));
                        });
             }),
             exportable_callback<CallSignal::VoiceMailNotify>(
                 [this] (const std::string &accountID, int count) {
-                       QTimer::singleShot(0, [this,accountID, count] {
+                       SignalQueue::instance().post("voiceMailNotify", [this,accountID, count] {
                              LOG_DRING_SIGNAL2("voiceMailNotify",QString(accountID.c_str()), count);
-                             Q_EMIT this->voiceMailNotify(QString(accountID.c_str()), count);
+                             Q_EMIT this->voiceMailNotify(toQString(accountID), count);
                        });
             }),
             exportable_callback<CallSignal::IncomingMessage>(
                 [this] (const std::string &callID, const std::string &from, const std::string &message) {
-                       QTimer::singleShot(0, [this,callID, from, message] {
+                       SignalQueue::instance().post("incomingMessage", [this,callID, from, message] {
                              LOG_DRING_SIGNAL3("incomingMessage",QString(callID.c_str()),QString(from.c_str()),QString(message.c_str()));
-                             Q_EMIT this->incomingMessage(QString(callID.c_str()), QString(from.c_str()), QString(message.c_str()));
+                             Q_EMIT this->incomingMessage(toQString(callID), toQString(from), toQString(message));
                        });
             }),
             exportable_callback<CallSignal::IncomingCall>(
                 [this] (const std::string &accountID, const std::string &callID, const std::string &from) {
-                       QTimer::singleShot(0, [this,accountID, callID, from] {
+                       SignalQueue::instance().post("incomingCall", [this,accountID, callID, from] {
                              LOG_DRING_SIGNAL3("incomingCall",QString(accountID.c_str()), QString(callID.c_str()), QString(from.c_str()));
-                             Q_EMIT this->incomingCall(QString(accountID.c_str()), QString(callID.c_str()), QString(from.c_str()));
+                             Q_EMIT this->incomingCall(toQString(accountID), toQString(callID), toQString(from));
                        });
             }),
             exportable_callback<CallSignal::RecordPlaybackFilepath>(
                 [this] (const std::string &callID, const std::string &filepath) {
-                       QTimer::singleShot(0, [this,callID, filepath] {
+                       SignalQueue::instance().post("recordPlaybackFilepath", [this,callID, filepath] {
                              LOG_DRING_SIGNAL2("recordPlaybackFilepath",QString(callID.c_str()), QString(filepath.c_str()));
-                             Q_EMIT this->recordPlaybackFilepath(QString(callID.c_str()), QString(filepath.c_str()));
+                             Q_EMIT this->recordPlaybackFilepath(toQString(callID), toQString(filepath));
                        });
             }),
             exportable_callback<CallSignal::ConferenceCreated>(
                 [this] (const std::string &confID) {
-                       QTimer::singleShot(0, [this,confID] {
+                       SignalQueue::instance().post("conferenceCreated", [this,confID] {
                              LOG_DRING_SIGNAL("conferenceCreated",QString(confID.c_str()));
-                             Q_EMIT this->conferenceCreated(QString(confID.c_str()));
+                             Q_EMIT this->conferenceCreated(toQString(confID));
                        });
             }),
             exportable_callback<CallSignal::ConferenceChanged>(
                 [this] (const std::string &confID, const std::string &state) {
-                       QTimer::singleShot(0, [this,confID, state] {
+                       SignalQueue::instance().post("conferenceChanged", [this,confID, state] {
                              LOG_DRING_SIGNAL2("conferenceChanged",QString(confID.c_str()), QString(state.c_str()));
-                             Q_EMIT this->conferenceChanged(QString(confID.c_str()), QString(state.c_str()));
+                             Q_EMIT this->conferenceChanged(toQString(confID), toQString(state));
                        });
             }),
             exportable_callback<CallSignal::UpdatePlaybackScale>(
                 [this] (const std::string &filepath, int position, int size) {
-                       QTimer::singleShot(0, [this,filepath, position, size] {
+                       SignalQueue::instance().post("updatePlaybackScale", [this,filepath, position, size] {
                              LOG_DRING_SIGNAL3("updatePlaybackScale",QString(filepath.c_str()), position, size);
-                             Q_EMIT this->updatePlaybackScale(QString(filepath.c_str()), position, size);
+                             Q_EMIT this->updatePlaybackScale(toQString(filepath), position, size);
                        });
             }),
             exportable_callback<CallSignal::ConferenceRemoved>(
                 [this] (const std::string &confID) {
-                       QTimer::singleShot(0, [this,confID] {
+                       SignalQueue::instance().post("conferenceRemoved", [this,confID] {
                              LOG_DRING_SIGNAL("conferenceRemoved",QString(confID.c_str()));
-                             Q_EMIT this->conferenceRemoved(QString(confID.c_str()));
+                             Q_EMIT this->conferenceRemoved(toQString(confID));
                        });
             }),
             exportable_callback<CallSignal::NewCallCreated>(
                 [this] (const std::string &accountID, const std::string &callID, const std::string &to) {
-                       QTimer::singleShot(0, [this,accountID, callID, to] {
+                       SignalQueue::instance().post("newCallCreated", [this,accountID, callID, to] {
                              LOG_DRING_SIGNAL3("newCallCreated",QString(accountID.c_str()), QString(callID.c_str()), QString(to.c_str()));
-                             Q_EMIT this->newCallCreated(QString(accountID.c_str()), QString(callID.c_str()), QString(to.c_str()));
+                             Q_EMIT this->newCallCreated(toQString(accountID), toQString(callID), toQString(to));
                        });
             }),
             exportable_callback<CallSignal::RecordingStateChanged>(
                 [this] (const std::string &callID, bool recordingState) {
-                       QTimer::singleShot(0, [this,callID, recordingState] {
+                       SignalQueue::instance().post("recordingStateChanged", [this,callID, recordingState] {
                              LOG_DRING_SIGNAL2("recordingStateChanged",QString(callID.c_str()), recordingState);
-                             Q_EMIT this->recordingStateChanged(QString(callID.c_str()), recordingState);
+                             Q_EMIT this->recordingStateChanged(toQString(callID), recordingState);
                        });
             }),
             exportable_callback<CallSignal::SecureSdesOn>(
                 [this] (const std::string &callID) {
-                       QTimer::singleShot(0, [this,callID] {
+                       SignalQueue::instance().post("secureSdesOn", [this,callID] {
                              LOG_DRING_SIGNAL("secureSdesOn",QString(callID.c_str()));
-                             Q_EMIT this->secureSdesOn(QString(callID.c_str()));
+                             Q_EMIT this->secureSdesOn(toQString(callID));
                        });
             }),
             exportable_callback<CallSignal::SecureSdesOff>(
                 [this] (const std::string &callID) {
-                       QTimer::singleShot(0, [this,callID] {
+                       SignalQueue::instance().post("secureSdesOff", [this,callID] {
                              LOG_DRING_SIGNAL("secureSdesOff",QString(callID.c_str()));
-                             Q_EMIT this->secureSdesOff(QString(callID.c_str()));
+                             Q_EMIT this->secureSdesOff(toQString(callID));
                        });
             }),
             exportable_callback<CallSignal::SecureZrtpOn>(
                 [this] (const std::string &callID, const std::string &cipher) {
-                       QTimer::singleShot(0, [this,callID,cipher] {
+                       SignalQueue::instance().post("secureZrtpOn", [this,callID,cipher] {
                              LOG_DRING_SIGNAL2("secureZrtpOn",QString(callID.c_str()), QString(cipher.c_str()));
-                             Q_EMIT this->secureZrtpOn(QString(callID.c_str()), QString(cipher.c_str()));
+                             Q_EMIT this->secureZrtpOn(toQString(callID), toQString(cipher));
                        });
             }),
             exportable_callback<CallSignal::SecureZrtpOff>(
                 [this] (const std::string &callID) {
-                       QTimer::singleShot(0, [this,callID] {
-                             Q_EMIT this->secureZrtpOff(QString(callID.c_str()));
+                       SignalQueue::instance().post("secureZrtpOff", [this,callID] {
+                             Q_EMIT this->secureZrtpOff(toQString(callID));
                        });
             }),
             exportable_callback<CallSignal::ShowSAS>(
                 [this] (const std::string &callID, const std::string &sas, bool verified) {
-                       QTimer::singleShot(0, [this,callID, sas, verified] {
+                       SignalQueue::instance().post("showSAS", [this,callID, sas, verified] {
                              LOG_DRING_SIGNAL3("showSAS",QString(callID.c_str()), QString(sas.c_str()), verified);
-                             Q_EMIT this->showSAS(QString(callID.c_str()), QString(sas.c_str()), verified);
+                             Q_EMIT this->showSAS(toQString(callID), toQString(sas), verified);
                        });
             }),
             exportable_callback<CallSignal::ZrtpNotSuppOther>(
                 [this] (const std::string &callID) {
-                       QTimer::singleShot(0, [this,callID] {
+                       SignalQueue::instance().post("zrtpNotSuppOther", [this,callID] {
                              LOG_DRING_SIGNAL("zrtpNotSuppOther",QString(callID.c_str()));
-                             Q_EMIT this->zrtpNotSuppOther(QString(callID.c_str()));
+                             Q_EMIT this->zrtpNotSuppOther(toQString(callID));
                        });
              }),
              exportable_callback<CallSignal::ZrtpNegotiationFailed>(
                  [this] (const std::string &callID, const std::string &reason, const std::string &severity) {
-                       QTimer::singleShot(0, [this,callID, reason, severity] {
+                       SignalQueue::instance().post("zrtpNegotiationFailed", [this,callID, reason, severity] {
                              LOG_DRING_SIGNAL3("zrtpNegotiationFailed",QString(callID.c_str()), QString(reason.c_str()), QString(severity.c_str()));
-                             Q_EMIT this->zrtpNegotiationFailed(QString(callID.c_str()), QString(reason.c_str()), QString(severity.c_str()));
+                             Q_EMIT this->zrtpNegotiationFailed(toQString(callID), toQString(reason), toQString(severity));
                        });
              }),
              exportable_callback<CallSignal::RtcpReportReceived>(
                  [this] (const std::string &callID, const std::map<std::string, int>& report) {
-                       QTimer::singleShot(0, [this,callID, report] {
+                       SignalQueue::instance().post("onRtcpReportReceived", [this,callID, report] {
                              LOG_DRING_SIGNAL2("onRtcpReportReceived",QString(callID.c_str()), convertStringInt(report));
-                             Q_EMIT this->onRtcpReportReceived(QString(callID.c_str()), convertStringInt(report));
+                             Q_EMIT this->onRtcpReportReceived(toQString(callID), convertStringInt(report));
                        });
              })
          };
@@ -212,44 +213,52 @@ public:
 public Q_SLOTS: // METHODS
     bool accept(const QString &callID)
     {
+        TRACE_DRING_CALL;
         return DRing::accept(callID.toStdString());
     }
 
     void acceptEnrollment(const QString &callID, bool accepted)
     {
+        TRACE_DRING_CALL;
         DRing::acceptEnrollment(callID.toStdString(), accepted);
     }
 
     bool addMainParticipant(const QString &confID)
     {
+        TRACE_DRING_CALL;
         return DRing::addMainParticipant(confID.toStdString());
     }
 
     bool addParticipant(const QString &callID, const QString &confID)
     {
+        TRACE_DRING_CALL;
         return DRing::addParticipant(
                         callID.toStdString(), confID.toStdString());
     }
 
     bool attendedTransfer(const QString &transferID, const QString &targetID)
     {
+        TRACE_DRING_CALL;
         return DRing::attendedTransfer(
                         transferID.toStdString(), targetID.toStdString());
     }
 
     void createConfFromParticipantList(const QStringList &participants)
     {
+        TRACE_DRING_CALL;
         DRing::createConfFromParticipantList(
                         convertStringList(participants));
     }
 
     bool detachParticipant(const QString &callID)
     {
+        TRACE_DRING_CALL;
         return DRing::detachParticipant(callID.toStdString());
     }
 
     MapStringString getCallDetails(const QString &callID)
     {
+        TRACE_DRING_CALL;
         MapStringString temp =
             convertMap(DRing::getCallDetails(callID.toStdString()));
         return temp;
@@ -257,6 +266,7 @@ public Q_SLOTS: // METHODS
 
     QStringList getCallList()
     {
+        TRACE_DRING_CALL;
         QStringList temp =
             convertStringList(DRing::getCallList());
         return temp;
@@ -264,6 +274,7 @@ public Q_SLOTS: // METHODS
 
     MapStringString getConferenceDetails(const QString &callID)
     {
+        TRACE_DRING_CALL;
         MapStringString temp =
             convertMap(DRing::getConferenceDetails(
                 callID.toStdString()));
@@ -272,12 +283,14 @@ public Q_SLOTS: // METHODS
 
     QString getConferenceId(const QString &callID)
     {
+        TRACE_DRING_CALL;
         QString temp(DRing::getConferenceId(callID.toStdString()).c_str());
         return temp;
     }
 
     QStringList getConferenceList()
     {
+        TRACE_DRING_CALL;
         QStringList temp =
             convertStringList(DRing::getConferenceList());
         return temp;
@@ -285,6 +298,7 @@ public Q_SLOTS: // METHODS
 
     Q_DECL_DEPRECATED QString getCurrentAudioCodecName(const QString &callID)
     {
+        TRACE_DRING_CALL;
         QString temp(
             DRing::getCurrentAudioCodecName(callID.toStdString()).c_str());
         return temp;
@@ -292,6 +306,7 @@ public Q_SLOTS: // METHODS
 
     QStringList getDisplayNames(const QString &confID)
     {
+        TRACE_DRING_CALL;
         QStringList temp =
             convertStringList(DRing::getDisplayNames(
                 confID.toStdString()));
@@ -300,12 +315,14 @@ public Q_SLOTS: // METHODS
 
     bool getIsRecording(const QString &callID)
     {
+        TRACE_DRING_CALL;
         //TODO: match API
         return DRing::getIsRecording(callID.toStdString());
     }
 
     QStringList getParticipantList(const QString &confID)
     {
+        TRACE_DRING_CALL;
         QStringList temp =
             convertStringList(DRing::getParticipantList(
                 confID.toStdString()));
@@ -314,122 +331,145 @@ public Q_SLOTS: // METHODS
 
     bool hangUp(const QString &callID)
     {
+        TRACE_DRING_CALL;
         return DRing::hangUp(callID.toStdString());
     }
 
     bool hangUpConference(const QString &confID)
     {
+        TRACE_DRING_CALL;
         return DRing::hangUpConference(confID.toStdString());
     }
 
     bool hold(const QString &callID)
     {
+        TRACE_DRING_CALL;
         return DRing::hold(callID.toStdString());
     }
 
     bool holdConference(const QString &confID)
     {
+        TRACE_DRING_CALL;
         return DRing::holdConference(confID.toStdString());
     }
 
     bool isConferenceParticipant(const QString &callID)
     {
+        TRACE_DRING_CALL;
         return DRing::isConferenceParticipant(callID.toStdString());
     }
 
     bool joinConference(const QString &sel_confID, const QString &drag_confID)
     {
+        TRACE_DRING_CALL;
         return DRing::joinConference(
             sel_confID.toStdString(), drag_confID.toStdString());
     }
 
     bool joinParticipant(const QString &sel_callID, const QString &drag_callID)
     {
+        TRACE_DRING_CALL;
         return DRing::joinParticipant(
             sel_callID.toStdString(), drag_callID.toStdString());
     }
 
     QString placeCall(const QString &accountID, const QString &to)
     {
+        TRACE_DRING_CALL;
         QString temp(DRing::placeCall(accountID.toStdString(), to.toStdString()).c_str());
         return temp;
     }
 
     void playDTMF(const QString &key)
     {
+        TRACE_DRING_CALL;
         DRing::playDTMF(key.toStdString());
     }
 
     void recordPlaybackSeek(double value)
     {
+        TRACE_DRING_CALL;
         DRing::recordPlaybackSeek(value);
     }
 
     bool refuse(const QString &callID)
     {
+        TRACE_DRING_CALL;
         return DRing::refuse(callID.toStdString());
     }
 
     void requestGoClear(const QString &callID)
     {
+        TRACE_DRING_CALL;
         DRing::requestGoClear(callID.toStdString());
     }
 
     void resetSASVerified(const QString &callID)
     {
+        TRACE_DRING_CALL;
         DRing::resetSASVerified(callID.toStdString());
     }
 
     void sendTextMessage(const QString &callID, const QString &message)
     {
+        TRACE_DRING_CALL;
         DRing::sendTextMessage(
             callID.toStdString(), message.toStdString());
     }
 
     void setConfirmGoClear(const QString &callID)
     {
+        TRACE_DRING_CALL;
         DRing::setConfirmGoClear(callID.toStdString());
     }
 
     void setSASVerified(const QString &callID)
     {
+        TRACE_DRING_CALL;
         DRing::setSASVerified(callID.toStdString());
     }
 
     bool startRecordedFilePlayback(const QString &filepath)
     {
+        TRACE_DRING_CALL;
         // TODO: Change method name to match API
         return DRing::startRecordedFilePlayback(filepath.toStdString());
     }
 
     void startTone(int start, int type)
     {
+        TRACE_DRING_CALL;
         DRing::startTone(start, type);
     }
 
     void stopRecordedFilePlayback(const QString &filepath)
     {
+        TRACE_DRING_CALL;
         DRing::stopRecordedFilePlayback(filepath.toStdString());
     }
 
     bool toggleRecording(const QString &callID)
     {
+        TRACE_DRING_CALL;
         return DRing::toggleRecording(callID.toStdString());
     }
 
     bool transfer(const QString &callID, const QString &to)
     {
+        TRACE_DRING_CALL;
         return DRing::transfer(
             callID.toStdString(), to.toStdString());
     }
 
     bool unhold(const QString &callID)
     {
+        TRACE_DRING_CALL;
         return DRing::unhold(callID.toStdString());
     }
 
     bool unholdConference(const QString &confID)
     {
+        TRACE_DRING_CALL;
         return DRing::unholdConference(confID.toStdString());
     }
 
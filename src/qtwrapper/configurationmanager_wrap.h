@@ -34,6 +34,7 @@
 
 #include "typedefs.h"
 #include "conversions_wrap.hpp"
+#include "signalqueue_wrap.h"
 
 // TEMPORARY
 #include <iostream>
@@ -60,40 +61,41 @@ public:
         confHandlers = {
             exportable_callback<ConfigurationSignal::VolumeChanged>(
                 [this] (const std::string &device, double value) {
-                       QTimer::singleShot(0, [this,device,value] {
-                             Q_EMIT this->volumeChanged(QString(device.c_str()), value);
+                       SignalQueue::instance().post("volumeChanged", [this,device,value] {
+                             Q_EMIT this->volumeChanged(toQString(device), value);
                        });
             }),
             exportable_callback<ConfigurationSignal::AccountsChanged>(
                 [this] () {
-                       QTimer::singleShot(0, [this] {
+                       SignalQueue::instance().post("accountsChanged", "accountsChanged", [this] {
                              Q_EMIT this->accountsChanged();
                        });
              }),
             exportable_callback<ConfigurationSignal::StunStatusFailed>(
                 [this] (const std::string &reason) {
-                       QTimer::singleShot(0, [this, reason] {
-                             Q_EMIT this->stunStatusFailure(QString(reason.c_str()));
+                       SignalQueue::instance().post("stunStatusFailure", [this, reason] {
+                             Q_EMIT this->stunStatusFailure(toQString(reason));
                        });
             }),
             exportable_callback<ConfigurationSignal::RegistrationStateChanged>(
                 [this] (const std::string &accountID, const std::string& registration_state, unsigned detail_code, const std::string& detail_str) {
-                       QTimer::singleShot(0, [this, accountID, registration_state, detail_code, detail_str] {
-                             Q_EMIT this->registrationStateChanged(QString(accountID.c_str()),
-                                                                QString(registration_state.c_str()),
+                       SignalQueue::instance().post("registrationStateChanged", [this, accountID, registration_state, detail_code, detail_str] {
+                             Q_EMIT this->registrationStateChanged(toQString(accountID),
+                                                                toQString(registration_state),
                                                                 detail_code,
-                                                                QString(detail_str.c_str()));
+                                                                toQString(detail_str));
                        });
             }),
             exportable_callback<ConfigurationSignal::VolatileDetailsChanged>(
                 [this] (const std::string &accountID, const std::map<std::string, std::string>& details) {
-                       QTimer::singleShot(0, [this, accountID, details] {
-                         Q_EMIT this->volatileAccountDetailsChanged(QString(accountID.c_str()), convertMap(details));
+                       // Each signal carry all the details, only the last one matter
+                       SignalQueue::instance().post("volatileAccountDetailsChanged", "volatileAccountDetailsChanged:" + accountID, [this, accountID, details] {
+                         Q_EMIT this->volatileAccountDetailsChanged(toQString(accountID), convertMap(details));
                        });
             }),
             exportable_callback<ConfigurationSignal::Error>(
                 [this] (int code) {
-                       QTimer::singleShot(0, [this,code] {
+                       SignalQueue::instance().post("errorAlert", [this,code] {
                          Q_EMIT this->errorAlert(code);
                        });
             })
@@ -105,6 +107,7 @@ public:
 public Q_SLOTS: // METHODS
     QString addAccount(MapStringString details)
     {
+        TRACE_DRING_CALL;
         QString temp(
             DRing::addAccount(convertMap(details)).c_str());
         return temp;
@@ -112,6 +115,7 @@ public Q_SLOTS: // METHODS
 
     MapStringString getAccountDetails(const QString &accountID)
     {
+        TRACE_DRING_CALL;
         MapStringString temp =
             convertMap(DRing::getAccountDetails(accountID.toStdString()));
         return temp;
@@ -119,6 +123,7 @@ public Q_SLOTS: // METHODS
 
     QStringList getAccountList()
     {
+        TRACE_DRING_CALL;
         QStringList temp =
             convertStringList(DRing::getAccountList());
         return temp;
@@ -126,6 +131,7 @@ public Q_SLOTS: // METHODS
 
     MapStringString getAccountTemplate(const QString& accountType)
     {
+        TRACE_DRING_CALL;
         MapStringString temp =
             convertMap(DRing::getAccountTemplate(accountType.toStdString()));
         return temp;
@@ -134,12 +140,14 @@ public Q_SLOTS: // METHODS
     // TODO: works?
     VectorUInt getActiveCodecList(const QString &accountID)
     {
+        TRACE_DRING_CALL;
         return QVector<unsigned int>::fromStdVector(
             DRing::getActiveCodecList(accountID.toStdString()));
     }
 
     QString getAddrFromInterfaceName(const QString &interface)
     {
+        TRACE_DRING_CALL;
         QString temp(
             DRing::getAddrFromInterfaceName(interface.toStdString()).c_str());
         return temp;
@@ -147,6 +155,7 @@ public Q_SLOTS: // METHODS
 
     QStringList getAllIpInterface()
     {
+        TRACE_DRING_CALL;
         QStringList temp =
             convertStringList(DRing::getAllIpInterface());
         return temp;
@@ -154,6 +163,7 @@ public Q_SLOTS: // METHODS
 
     QStringList getAllIpInterfaceByName()
     {
+        TRACE_DRING_CALL;
         QStringList temp =
             convertStringList(DRing::getAllIpInterfaceByName());
         return temp;
@@ -161,6 +171,7 @@ public Q_SLOTS: // METHODS
 
     MapStringString getCodecDetails(const QString accountID, int payload)
     {
+        TRACE_DRING_CALL;
         MapStringString temp =
             convertMap(DRing::getCodecDetails(
                 accountID.toStdString().c_str(), payload));
@@ -169,16 +180,19 @@ public Q_SLOTS: // METHODS
 
     VectorUInt getCodecList()
     {
+        TRACE_DRING_CALL;
         return QVector<unsigned int>::fromStdVector(DRing::getCodecList());
     }
 
     int getAudioInputDeviceIndex(const QString &devname)
     {
+        TRACE_DRING_CALL;
         return DRing::getAudioInputDeviceIndex(devname.toStdString());
     }
 
     QStringList getAudioInputDeviceList()
     {
+        TRACE_DRING_CALL;
         QStringList temp =
             convertStringList(DRing::getAudioInputDeviceList());
         return temp;
@@ -186,6 +200,7 @@ public Q_SLOTS: // METHODS
 
     QString getAudioManager()
     {
+        TRACE_DRING_CALL;
         QString temp(
             DRing::getAudioManager().c_str());
         return temp;
@@ -193,11 +208,13 @@ public Q_SLOTS: // METHODS
 
     int getAudioOutputDeviceIndex(const QString &devname)
     {
+        TRACE_DRING_CALL;
         return DRing::getAudioOutputDeviceIndex(devname.toStdString());
     }
 
     QStringList getAudioOutputDeviceList()
     {
+        TRACE_DRING_CALL;
         QStringList temp =
             convertStringList(DRing::getAudioOutputDeviceList());
         return temp;
@@ -205,6 +222,7 @@ public Q_SLOTS: // METHODS
 
     QStringList getAudioPluginList()
     {
+        TRACE_DRING_CALL;
         QStringList temp =
             convertStringList(DRing::getAudioPluginList());
         return temp;
@@ -212,6 +230,7 @@ public Q_SLOTS: // METHODS
 
     VectorMapStringString getCredentials(const QString &accountID)
     {
+        TRACE_DRING_CALL;
         VectorMapStringString temp;
         for(auto x : DRing::getCredentials(accountID.toStdString())) {
             temp.push_back(convertMap(x));
@@ -221,6 +240,7 @@ public Q_SLOTS: // METHODS
 
     QStringList getCurrentAudioDevicesIndex()
     {
+        TRACE_DRING_CALL;
         QStringList temp =
             convertStringList(DRing::getCurrentAudioDevicesIndex());
         return temp;
@@ -228,6 +248,7 @@ public Q_SLOTS: // METHODS
 
     QString getCurrentAudioOutputPlugin()
     {
+        TRACE_DRING_CALL;
         QString temp(
             DRing::getCurrentAudioOutputPlugin().c_str());
         return temp;
@@ -235,11 +256,13 @@ public Q_SLOTS: // METHODS
 
     int getHistoryLimit()
     {
+        TRACE_DRING_CALL;
         return DRing::getHistoryLimit();
     }
 
     MapStringString getHookSettings()
     {
+        TRACE_DRING_CALL;
         MapStringString temp =
             convertMap(DRing::getHookSettings());
         return temp;
@@ -247,6 +270,7 @@ public Q_SLOTS: // METHODS
 
     MapStringString getIp2IpDetails()
     {
+        TRACE_DRING_CALL;
         MapStringString temp =
             convertMap(DRing::getIp2IpDetails());
         return temp;
@@ -254,16 +278,19 @@ public Q_SLOTS: // METHODS
 
     bool getIsAlwaysRecording()
     {
+        TRACE_DRING_CALL;
         return DRing::getIsAlwaysRecording();
     }
 
     bool getNoiseSuppressState()
     {
+        TRACE_DRING_CALL;
         return DRing::getNoiseSuppressState();
     }
 
     QString getRecordPath()
     {
+        TRACE_DRING_CALL;
         QString temp(
             DRing::getRecordPath().c_str());
         return temp;
@@ -271,12 +298,14 @@ public Q_SLOTS: // METHODS
 
     QStringList getSupportedAudioManagers()
     {
+        TRACE_DRING_CALL;
         QStringList temp;
         return temp;
     }
 
     MapStringString getShortcuts()
     {
+        TRACE_DRING_CALL;
         MapStringString temp =
             convertMap(DRing::getShortcuts());
         return temp;
@@ -284,6 +313,7 @@ public Q_SLOTS: // METHODS
 
     QStringList getSupportedTlsMethod()
     {
+        TRACE_DRING_CALL;
         QStringList temp =
             convertStringList(DRing::getSupportedTlsMethod());
         return temp;
@@ -291,6 +321,7 @@ public Q_SLOTS: // METHODS
 
     MapStringString getTlsSettings()
     {
+        TRACE_DRING_CALL;
         MapStringString temp =
             convertMap(DRing::getTlsSettings());
         return temp;
@@ -298,6 +329,7 @@ public Q_SLOTS: // METHODS
 
     MapStringString validateCertificate(const QString& unused, const QString certificate, const QString& privateKey)
     {
+        TRACE_DRING_CALL;
         MapStringString temp =
             convertMap(DRing::validateCertificate(unused.toStdString(),
                                                 certificate.toStdString(),
@@ -307,6 +339,7 @@ public Q_SLOTS: // METHODS
 
     MapStringString validateCertificateRaw(const QString& unused, const QByteArray& content)
     {
+        TRACE_DRING_CALL;
         std::vector<unsigned char> raw(content.begin(), content.end());
         MapStringString temp =
             convertMap(DRing::validateCertificateRaw(unused.toStdString(), raw));
@@ -315,6 +348,7 @@ public Q_SLOTS: // METHODS
 
     MapStringString getCertificateDetails(const QString &certificate)
     {
+        TRACE_DRING_CALL;
         MapStringString temp =
             convertMap(DRing::getCertificateDetails(certificate.toStdString()));
         return temp;
@@ -322,6 +356,7 @@ public Q_SLOTS: // METHODS
 
     MapStringString getCertificateDetailsRaw(const QByteArray &content)
     {
+        TRACE_DRING_CALL;
         std::vector<unsigned char> raw(content.begin(), content.end());
         MapStringString temp =
             convertMap(DRing::getCertificateDetailsRaw(raw));
@@ -330,6 +365,7 @@ public Q_SLOTS: // METHODS
 
     QStringList getSupportedCiphers(const QString &accountID)
     {
+        TRACE_DRING_CALL;
         QStringList temp =
             convertStringList(DRing::getSupportedCiphers(accountID.toStdString()));
         return temp;
@@ -337,6 +373,7 @@ public Q_SLOTS: // METHODS
 
     MapStringString getTlsDefaultSettings()
     {
+        TRACE_DRING_CALL;
         MapStringString temp =
             convertMap(DRing::getTlsDefaultSettings());
         return temp;
@@ -344,77 +381,92 @@ public Q_SLOTS: // METHODS
 
     double getVolume(const QString &device)
     {
+        TRACE_DRING_CALL;
         return DRing::getVolume(device.toStdString());
     }
 
     bool isAgcEnabled()
     {
+        TRACE_DRING_CALL;
         return DRing::isAgcEnabled();
     }
 
     bool isCaptureMuted()
     {
+        TRACE_DRING_CALL;
         return DRing::isCaptureMuted();
     }
 
     bool isDtmfMuted()
     {
+        TRACE_DRING_CALL;
         return DRing::isDtmfMuted();
     }
 
     int isIax2Enabled()
     {
+        TRACE_DRING_CALL;
         return DRing::isIax2Enabled();
     }
 
     bool isPlaybackMuted()
     {
+        TRACE_DRING_CALL;
         return DRing::isPlaybackMuted();
     }
 
     void muteCapture(bool mute)
     {
+        TRACE_DRING_CALL;
         DRing::muteCapture(mute);
     }
 
     void muteDtmf(bool mute)
     {
+        TRACE_DRING_CALL;
         DRing::muteDtmf(mute);
     }
 
     void mutePlayback(bool mute)
     {
+        TRACE_DRING_CALL;
         DRing::mutePlayback(mute);
     }
 
     void registerAllAccounts()
     {
+        TRACE_DRING_CALL;
         DRing::registerAllAccounts();
     }
 
     void removeAccount(const QString &accountID)
     {
+        TRACE_DRING_CALL;
         DRing::removeAccount(accountID.toStdString());
     }
 
     void sendRegister(const QString &accountID, bool enable)
     {
+        TRACE_DRING_CALL;
         DRing::sendRegister(accountID.toStdString(), enable);
     }
 
     void setAccountDetails(const QString &accountID, MapStringString details)
     {
+        TRACE_DRING_CALL;
         DRing::setAccountDetails(accountID.toStdString(),
             convertMap(details));
     }
 
     void setAccountsOrder(const QString &order)
     {
+        TRACE_DRING_CALL;
         DRing::setAccountsOrder(order.toStdString());
     }
 
     void setActiveCodecList(const QString &accountID, VectorUInt &list)
     {
+        TRACE_DRING_CALL;
         //const std::vector<unsigned int> converted = convertStringList(list);
         DRing::setActiveCodecList(accountID.toStdString(),
         list.toStdVector());
@@ -422,36 +474,43 @@ public Q_SLOTS: // METHODS
 
     void setAgcState(bool enabled)
     {
+        TRACE_DRING_CALL;
         DRing::setAgcState(enabled);
     }
 
     void setAudioInputDevice(int index)
     {
+        TRACE_DRING_CALL;
         DRing::setAudioInputDevice(index);
     }
 
     bool setAudioManager(const QString &api)
     {
+        TRACE_DRING_CALL;
         return DRing::setAudioManager(api.toStdString());
     }
 
     void setAudioOutputDevice(int index)
     {
+        TRACE_DRING_CALL;
         DRing::setAudioOutputDevice(index);
     }
 
     void setAudioPlugin(const QString &audioPlugin)
     {
+        TRACE_DRING_CALL;
         DRing::setAudioPlugin(audioPlugin.toStdString());
     }
 
     void setAudioRingtoneDevice(int index)
     {
+        TRACE_DRING_CALL;
         DRing::setAudioRingtoneDevice(index);
     }
 
     void setCredentials(const QString &accountID, VectorMapStringString credentialInformation)
     {
+        TRACE_DRING_CALL;
         std::vector<std::map<std::string, std::string> > temp;
         for (auto x : credentialInformation) {
             temp.push_back(convertMap(x));
@@ -461,46 +520,55 @@ public Q_SLOTS: // METHODS
 
     void setHistoryLimit(int days)
     {
+        TRACE_DRING_CALL;
         DRing::setHistoryLimit(days);
     }
 
     void setHookSettings(MapStringString settings)
     {
+        TRACE_DRING_CALL;
         DRing::setHookSettings(convertMap(settings));
     }
 
     void setIsAlwaysRecording(bool enabled)
     {
+        TRACE_DRING_CALL;
         DRing::setIsAlwaysRecording(enabled);
     }
 
     void setNoiseSuppressState(bool state)
     {
+        TRACE_DRING_CALL;
         DRing::setNoiseSuppressState(state);
     }
 
     void setRecordPath(const QString &rec)
     {
+        TRACE_DRING_CALL;
         DRing::setRecordPath(rec.toStdString());
     }
 
     void setShortcuts(MapStringString shortcutsMap)
     {
+        TRACE_DRING_CALL;
         DRing::setShortcuts(convertMap(shortcutsMap));
     }
 
     void setTlsSettings(MapStringString details)
     {
+        TRACE_DRING_CALL;
         DRing::setTlsSettings(convertMap(details));
     }
 
     void setVolume(const QString &device, double value)
     {
+        TRACE_DRING_CALL;
         DRing::setVolume(device.toStdString(), value);
     }
 
     MapStringString getVolatileAccountDetails(const QString &accountID)
     {
+        TRACE_DRING_CALL;
         MapStringString temp = convertMap(DRing::getVolatileAccountDetails(accountID.toStdString()));
         return temp;
     }
@@ -20,9 +20,13 @@
 
 #include <map>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 #include "../typedefs.h"
+#include "../dbus/ipctrace.h"
+
+#include <account_const.h>
 
 #define Q_NOREPLY
 
@@ -39,51 +43,170 @@
  #define LOG_DRING_SIGNAL4(name,arg,arg2,arg3,arg4)
 #endif
 
+/*
+ * Implementation note: conversions
+ * The daemon maps use the same keys over and over, mostly the account and
+ * codec details. The known DRing::Account keys are converted once, in a
+ * read-only table built on first use, and then shared by all the maps
+ * through QString implicit sharing. The lookup need no lock and is cheaper
+ * than the UTF-8 decoding and the allocation. Any other key is decoded, so
+ * nothing sent by the daemon can make the table grow.
+ *
+ * The strings are decoded with their known size, in a single pass. The
+ * daemon maps are already sorted, they are appended at the end of the
+ * QMap instead of being looked up for each insertion.
+ *
+ * The converted bytes are accounted as the payload of the current
+ * DBus::IpcTrace event, this is the only place where they are all seen.
+ */
+
+///Decode a daemon string
+inline QString toQString(const std::string& s) {
+    DBus::IpcTrace::addPayload(s.size());
+    return QString::fromUtf8(s.data(), static_cast<int>(s.size()));
+}
+
+///Get the shared QString of a map key
+inline QString internKey(const std::string& key) {
+    using namespace DRing::Account;
+
+    static const std::unordered_map<std::string, QString> keys = [] {
+        std::unordered_map<std::string, QString> ret;
+
+        for (const char* k : {
+            ConfProperties::ALIAS,
+            ConfProperties::AUTOANSWER,
+            ConfProperties::Audio::PORT_MAX,
+            ConfProperties::Audio::PORT_MIN,
+            ConfProperties::CodecInfo::BITRATE,
+            ConfProperties::CodecInfo::CHANNEL_NUMBER,
+            ConfProperties::CodecInfo::FRAME_RATE,
+            ConfProperties::CodecInfo::NAME,
+            ConfProperties::CodecInfo::SAMPLE_RATE,
+            ConfProperties::CodecInfo::TYPE,
+            ConfProperties::DHT::PORT,
+            ConfProperties::DTMF_TYPE,
+            ConfProperties::ENABLED,
+            ConfProperties::HAS_CUSTOM_USER_AGENT,
+            ConfProperties::HOSTNAME,
+            ConfProperties::LOCAL_INTERFACE,
+            ConfProperties::LOCAL_PORT,
+            ConfProperties::MAILBOX,
+            ConfProperties::PASSWORD,
+            ConfProperties::PUBLISHED_ADDRESS,
+            ConfProperties::PUBLISHED_PORT,
+            ConfProperties::PUBLISHED_SAMEAS_LOCAL,
+            ConfProperties::Presence::ENABLED,
+            ConfProperties::Presence::SUPPORT_PUBLISH,
+            ConfProperties::Presence::SUPPORT_SUBSCRIBE,
+            ConfProperties::REALM,
+            ConfProperties::ROUTE,
+            ConfProperties::Registration::EXPIRE,
+            ConfProperties::Registration::STATUS,
+            ConfProperties::Ringtone::ENABLED,
+            ConfProperties::Ringtone::PATH,
+            ConfProperties::SRTP::ENABLED,
+            ConfProperties::SRTP::KEY_EXCHANGE,
+            ConfProperties::SRTP::RTP_FALLBACK,
+            ConfProperties::STUN::ENABLED,
+            ConfProperties::STUN::SERVER,
+            ConfProperties::TLS::CA_LIST_FILE,
+            ConfProperties::TLS::CERTIFICATE_FILE,
+            ConfProperties::TLS::CIPHERS,
+            ConfProperties::TLS::ENABLED,
+            ConfProperties::TLS::LISTENER_PORT,
+            ConfProperties::TLS::METHOD,
+            ConfProperties::TLS::NEGOTIATION_TIMEOUT_SEC,
+            ConfProperties::TLS::PASSWORD,
+            ConfProperties::TLS::PRIVATE_KEY_FILE,
+            ConfProperties::TLS::REQUIRE_CLIENT_CERTIFICATE,
+            ConfProperties::TLS::SERVER_NAME,
+            ConfProperties::TLS::VERIFY_CLIENT,
+            ConfProperties::TLS::VERIFY_SERVER,
+            ConfProperties::TYPE,
+            ConfProperties::UPNP_ENABLED,
+            ConfProperties::USERNAME,
+            ConfProperties::USER_AGENT,
+            ConfProperties::Video::ENABLED,
+            ConfProperties::Video::PORT_MAX,
+            ConfProperties::Video::PORT_MIN,
+            ConfProperties::ZRTP::DISPLAY_SAS,
+            ConfProperties::ZRTP::DISPLAY_SAS_ONCE,
+            ConfProperties::ZRTP::HELLO_HASH,
+            ConfProperties::ZRTP::NOT_SUPP_WARNING,
+            VolatileProperties::Registration::STATUS,
+            VolatileProperties::Transport::STATE_CODE,
+            VolatileProperties::Transport::STATE_DESC,
+        })
+            ret.emplace(k, QString::fromUtf8(k));
+
+        return ret;
+    }();
+
+    const auto i = keys.find(key);
+
+    if (i == keys.end())
+        return toQString(key);
+
+    DBus::IpcTrace::addPayload(key.size());
+    return i->second;
+}
+
 inline MapStringString convertMap(const std::map<std::string, std::string>& m) {
     MapStringString temp;
     for (const auto& x : m) {
-        temp[QString(x.first.c_str())] = QString(x.second.c_str());
+        temp.insert(temp.constEnd(), internKey(x.first), toQString(x.second));
     }
     return temp;
 }
 
 inline std::map<std::string, std::string> convertMap(const MapStringString& m) {
     std::map<std::string, std::string> temp;
-    for (const auto& x : m.toStdMap()) {
-        temp[x.first.toStdString()] = x.second.toStdString();
+    size_t bytes = 0;
+    for (auto x = m.constBegin(); x != m.constEnd(); ++x) {
+        const auto i = temp.emplace_hint(temp.end(), x.key().toStdString(), x.value().toStdString());
+        bytes += i->first.size() + i->second.size();
     }
+    DBus::IpcTrace::addPayload(bytes);
     return temp;
 }
 
 inline QStringList convertStringList(const std::vector<std::string>& v) {
     QStringList temp;
+    temp.reserve(static_cast<int>(v.size()));
     for (const auto& x : v) {
-        temp.push_back(QString(x.c_str()));
+        temp.push_back(toQString(x));
     }
     return temp;
 }
 
 inline VectorString convertVectorString(const std::vector<std::string>& v) {
     VectorString temp;
+    temp.reserve(static_cast<int>(v.size()));
     for (const auto& x : v) {
-        temp.push_back(QString(x.c_str()));
+        temp.push_back(toQString(x));
     }
     return temp;
 }
 
 inline std::vector<std::string> convertStringList(const QStringList& v) {
     std::vector<std::string> temp;
+    temp.reserve(v.size());
+    size_t bytes = 0;
     for (const auto& x : v) {
         temp.push_back(x.toStdString());
+        bytes += temp.back().size();
     }
+    DBus::IpcTrace::addPayload(bytes);
     return temp;
 }
 
 inline MapStringInt  convertStringInt(const std::map<std::string, int>& m) {
     MapStringInt temp;
     for (const auto& x : m) {
-        temp[QString(x.first.c_str())] = x.second;
+        temp.insert(temp.constEnd(), internKey(x.first), x.second);
     }
+    DBus::IpcTrace::addPayload(m.size() * sizeof(int));
     return temp;
 }
 
@@ -31,6 +31,7 @@
 #include "typedefs.h"
 #include <presencemanager_interface.h>
 #include "conversions_wrap.hpp"
+#include "signalqueue_wrap.h"
 
 
 /*
@@ -51,26 +52,26 @@ public:
         presHandlers = {
             exportable_callback<PresenceSignal::NewServerSubscriptionRequest>(
                 [this] (const std::string &buddyUri) {
-                       QTimer::singleShot(0, [this,buddyUri] {
-                             Q_EMIT this->newServerSubscriptionRequest(QString(buddyUri.c_str()));
+                       SignalQueue::instance().post("newServerSubscriptionRequest", [this,buddyUri] {
+                             Q_EMIT this->newServerSubscriptionRequest(toQString(buddyUri));
                        });
             }),
             exportable_callback<PresenceSignal::ServerError>(
                 [this] (const std::string &accountID, const std::string &error, const std::string &msg) {
-                       QTimer::singleShot(0, [this,accountID, error, msg] {
-                             Q_EMIT this->serverError(QString(accountID.c_str()), QString(error.c_str()), QString(msg.c_str()));
+                       SignalQueue::instance().post("serverError", [this,accountID, error, msg] {
+                             Q_EMIT this->serverError(toQString(accountID), toQString(error), toQString(msg));
                        });
             }),
             exportable_callback<PresenceSignal::NewBuddyNotification>(
                 [this] (const std::string &accountID, const std::string &buddyUri, bool status, const std::string &lineStatus) {
-                       QTimer::singleShot(0, [this,accountID, buddyUri, status, lineStatus] {
-                             Q_EMIT this->newBuddyNotification(QString(accountID.c_str()), QString(buddyUri.c_str()), status, QString(lineStatus.c_str()));
+                       SignalQueue::instance().post("newBuddyNotification", [this,accountID, buddyUri, status, lineStatus] {
+                             Q_EMIT this->newBuddyNotification(toQString(accountID), toQString(buddyUri), status, toQString(lineStatus));
                        });
             }),
             exportable_callback<PresenceSignal::SubscriptionStateChanged>(
                 [this] (const std::string &accountID, const std::string &buddyUri, bool state) {
-                       QTimer::singleShot(0, [this,accountID, buddyUri, state] {
-                             Q_EMIT this->subscriptionStateChanged(QString(accountID.c_str()), QString(buddyUri.c_str()), state);
+                       SignalQueue::instance().post("subscriptionStateChanged", [this,accountID, buddyUri, state] {
+                             Q_EMIT this->subscriptionStateChanged(toQString(accountID), toQString(buddyUri), state);
                        });
             })
          };
@@ -81,11 +82,13 @@ public:
 public Q_SLOTS: // METHODS
     void answerServerRequest(const QString &uri, bool flag)
     {
+        TRACE_DRING_CALL;
         DRing::answerServerRequest(uri.toStdString(), flag);
     }
 
     VectorMapStringString getSubscriptions(const QString &accountID)
     {
+        TRACE_DRING_CALL;
         VectorMapStringString temp;
         for (auto x : DRing::getSubscriptions(accountID.toStdString())) {
             temp.push_back(convertMap(x));
@@ -95,16 +98,19 @@ public Q_SLOTS: // METHODS
 
     void publish(const QString &accountID, bool status, const QString &note)
     {
+        TRACE_DRING_CALL;
         DRing::publish(accountID.toStdString(), status, note.toStdString());
     }
 
     void setSubscriptions(const QString &accountID, const QStringList &uriList)
     {
+        TRACE_DRING_CALL;
         DRing::setSubscriptions(accountID.toStdString(), convertStringList(uriList));
     }
 
     void subscribeBuddy(const QString &accountID, const QString &uri, bool flag)
     {
+        TRACE_DRING_CALL;
         DRing::subscribeBuddy(accountID.toStdString(), uri.toStdString(), flag);
     }
 
@@ -0,0 +1,162 @@
+/****************************************************************************
+ *   Copyright (C) 2015 by Savoir-Faire Linux                               *
+ *   Author : Emmanuel Lepage Vallee <emmanuel.lepage@savoirfairelinux.com> *
+ *                                                                          *
+ *   This library is free software; you can redistribute it and/or          *
+ *   modify it under the terms of the GNU Lesser General Public             *
+ *   License as published by the Free Software Foundation; either           *
+ *   version 2.1 of the License, or (at your option) any later version.     *
+ *                                                                          *
+ *   This library is distributed in the hope that it will be useful,        *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU      *
+ *   Lesser General Public License for more details.                        *
+ *                                                                          *
+ *   You should have received a copy of the GNU General Public License      *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>.  *
+ ***************************************************************************/
+#include "signalqueue_wrap.h"
+
+//Qt
+#include <QtCore/QCoreApplication>
+#include <QtCore/QThread>
+
+//Ring
+#include "ipctrace.h"
+
+//STD
+#include <vector>
+
+/* Implementation note: queue
+ * This is an intrusive multiple producers, single consumer linked list.
+ * A producer link its node by swapping the head, then publish the link
+ * from the previous node. It never wait and never fail. The consumer follow
+ * the links from the tail. A stub node keep the list from ever being empty,
+ * so the producers never touch the tail.
+ *
+ * When a producer was interrupted between the swap and the link, the
+ * consumer stop early. As the producer then check m_Scheduled after the
+ * consumer cleared it, a new drain() is always queued for the rest.
+ */
+
+SignalQueue::SignalQueue() : QObject(nullptr), m_pHead(&m_Stub), m_pTail(&m_Stub),
+m_Scheduled(false), m_Coalesced(0)
+{
+   m_Stub.next = nullptr;
+
+   // The first signal may come from a daemon thread
+   if (QCoreApplication::instance())
+      moveToThread(QCoreApplication::instance()->thread());
+}
+
+SignalQueue::~SignalQueue()
+{
+   while (Node* n = pop())
+      delete n;
+}
+
+SignalQueue& SignalQueue::instance()
+{
+   static SignalQueue* q = new SignalQueue();
+   return *q;
+}
+
+///Queue a functor, it is run in the Qt thread
+void SignalQueue::post(const char* name, std::function<void()>&& f)
+{
+   post(name, std::string(), std::move(f));
+}
+
+///Queue a functor, it replace the previous one if it was queued with the same key
+void SignalQueue::post(const char* name, std::string&& key, std::function<void()>&& f)
+{
+   Node* n   = new Node;
+   n->f      = std::move(f  );
+   n->key    = std::move(key);
+   n->name   = name;
+   n->posted = DBus::IpcTrace::now();
+
+   push(n);
+
+   if (!m_Scheduled.exchange(true, std::memory_order_acq_rel))
+      QMetaObject::invokeMethod(this, "drain", Qt::QueuedConnection);
+}
+
+///The number of functors which were superseded before being run
+uint SignalQueue::coalescedCount() const
+{
+   return m_Coalesced;
+}
+
+void SignalQueue::push(Node* n)
+{
+   n->next.store(nullptr, std::memory_order_relaxed);
+
+   Node* prev = m_pHead.exchange(n, std::memory_order_acq_rel);
+   prev->next.store(n, std::memory_order_release);
+}
+
+///Dequeue the oldest node, nullptr if the queue is empty or a push is in progress
+SignalQueue::Node* SignalQueue::pop()
+{
+   Node* tail = m_pTail;
+   Node* next = tail->next.load(std::memory_order_acquire);
+
+   if (tail == &m_Stub) {
+      if (!next)
+         return nullptr;
+
+      m_pTail = next;
+      tail    = next;
+      next    = next->next.load(std::memory_order_acquire);
+   }
+
+   if (next) {
+      m_pTail = next;
+      return tail;
+   }
+
+   if (tail != m_pHead.load(std::memory_order_acquire))
+      return nullptr;
+
+   // Put the stub back behind the last node to be able to take it
+   push(&m_Stub);
+
+   next = tail->next.load(std::memory_order_acquire);
+
+   if (next) {
+      m_pTail = next;
+      return tail;
+   }
+
+   return nullptr;
+}
+
+///Run everything queued so far, in one pass
+void SignalQueue::drain()
+{
+   m_Scheduled.store(false, std::memory_order_release);
+
+   std::vector<Node*> nodes;
+
+   while (Node* n = pop())
+      nodes.push_back(n);
+
+   // A functor is only superseded by the one right after it, any other
+   // signal in between could depend on the state it carry
+   for (size_t i = 0; i + 1 < nodes.size(); i++) {
+      if ((!nodes[i]->key.empty()) && nodes[i]->key == nodes[i + 1]->key) {
+         nodes[i]->f = nullptr;
+         ++m_Coalesced;
+      }
+   }
+
+   for (Node* n : nodes) {
+      if (n->f) {
+         DBus::IpcTrace::Scope trace(DBus::IpcTrace::Kind::DELIVERY, n->name, n->posted);
+         n->f();
+      }
+
+      delete n;
+   }
+}
@@ -0,0 +1,85 @@
+/******************************************************************************
+ *   Copyright (C) 2015 by Savoir-Faire Linux                                 *
+ *   Author : Emmanuel Lepage Vallee <emmanuel.lepage@savoirfairelinux.com>   *
+ *                                                                            *
+ *   This library is free software; you can redistribute it and/or            *
+ *   modify it under the terms of the GNU Lesser General Public               *
+ *   License as published by the Free Software Foundation; either             *
+ *   version 2.1 of the License, or (at your option) any later version.       *
+ *                                                                            *
+ *   This library is distributed in the hope that it will be useful,          *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of           *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU        *
+ *   Lesser General Public License for more details.                          *
+ *                                                                            *
+ *   You should have received a copy of the Lesser GNU General Public License *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>.    *
+ *****************************************************************************/
+#ifndef SIGNALQUEUE_WRAP_H
+#define SIGNALQUEUE_WRAP_H
+
+#include <QtCore/QObject>
+
+#include <atomic>
+#include <functional>
+#include <string>
+
+/**
+ * Deliver the daemon signals to the Qt thread.
+ *
+ * The daemon callbacks post a functor (emitting the Qt signal) from any
+ * thread without blocking. All the functors queued at a given time are then
+ * run in a single event loop iteration, in order.
+ *
+ * A functor posted with a key supersede the previous one if it has the
+ * same key and is still in the queue, it is then dropped without being
+ * run. Only consecutive functors are coalesced, so the signals are still
+ * delivered in order. This is meant for signals carrying a full state,
+ * where only the last one matter.
+ *
+ * The functors are named after the signal they emit, for DBus::IpcTrace.
+ */
+class SignalQueue : public QObject
+{
+   Q_OBJECT
+public:
+   //Singleton
+   static SignalQueue& instance();
+
+   //Mutators
+   void post(const char* name, std::function<void()>&& f);
+   void post(const char* name, std::string&& key, std::function<void()>&& f);
+
+   //Getters
+   uint coalescedCount() const;
+
+private:
+   ///A queued functor
+   struct Node {
+      std::atomic<Node*>    next;
+      std::function<void()> f   ;
+      std::string           key ; /*!< Empty if the functor is never superseded */
+      const char*           name;
+      qint64                posted; /*!< Emission time, see DBus::IpcTrace::now() */
+   };
+
+   //Constructor
+   explicit SignalQueue();
+   virtual ~SignalQueue();
+
+   //Attributes
+   std::atomic<Node*> m_pHead      ; /*!< Last queued node, swapped by the producers */
+   Node*              m_pTail      ; /*!< Next node to dequeue, only used by drain() */
+   Node               m_Stub       ;
+   std::atomic_bool   m_Scheduled  ; /*!< A drain() is already pending              */
+   std::atomic_uint   m_Coalesced  ;
+
+   //Helpers
+   void  push(Node* n);
+   Node* pop ();
+
+private Q_SLOTS:
+   void drain();
+};
+
+#endif
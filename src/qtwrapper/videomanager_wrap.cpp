@@ -23,27 +23,27 @@ VideoManagerInterface::VideoManagerInterface()
 #ifdef ENABLE_VIDEO
 
     proxy = new VideoManagerSignalProxy(this);
-    sender = new VideoManagerProxySender();
-
-    QObject::connect(sender,&VideoManagerProxySender::deviceEvent,proxy,&VideoManagerSignalProxy::slotDeviceEvent);
-    QObject::connect(sender,&VideoManagerProxySender::startedDecoding,proxy,&VideoManagerSignalProxy::slotStartedDecoding);
-    QObject::connect(sender,&VideoManagerProxySender::stoppedDecoding,proxy,&VideoManagerSignalProxy::slotStoppedDecoding);
-
 
     using DRing::exportable_callback;
     using DRing::VideoSignal;
     videoHandlers = {
         exportable_callback<VideoSignal::DeviceEvent>(
             [this] () {
-                emit sender->deviceEvent();
+                SignalQueue::instance().post("deviceEvent", "deviceEvent", [this] {
+                    emit deviceEvent();
+                });
         }),
         exportable_callback<VideoSignal::DecodingStarted>(
             [this] (const std::string &id, const std::string &shmPath, int width, int height, bool isMixer) {
-                emit sender->startedDecoding(QString(id.c_str()), QString(shmPath.c_str()), width, height, isMixer);
+                SignalQueue::instance().post("startedDecoding", [this, id, shmPath, width, height, isMixer] {
+                    proxy->queueStarted(toQString(id), toQString(shmPath), width, height, isMixer);
+                });
         }),
         exportable_callback<VideoSignal::DecodingStopped>(
             [this] (const std::string &id, const std::string &shmPath, bool isMixer) {
-                emit sender->stoppedDecoding(QString(id.c_str()), QString(shmPath.c_str()), isMixer);
+                SignalQueue::instance().post("stoppedDecoding", [this, id, shmPath, isMixer] {
+                    proxy->queueStopped(toQString(id), toQString(shmPath), isMixer);
+                });
         })
     };
 #endif
@@ -55,34 +55,103 @@ VideoManagerInterface::~VideoManagerInterface()
 }
 
 VideoManagerSignalProxy::VideoManagerSignalProxy(VideoManagerInterface* parent) : QObject(parent),
-m_pParent(parent), m_pSem(new QSemaphore(3))
+m_pParent(parent), m_Scheduled(false)
 {}
 
-void VideoManagerSignalProxy::slotDeviceEvent()
+bool VideoManagerSignalProxy::Params::operator==(const Params& other) const
 {
-    QTimer::singleShot(0, [=] {
-        emit m_pParent->deviceEvent();
-    });
+    return shmPath == other.shmPath && width  == other.width
+        && height  == other.height  && isMixer == other.isMixer;
 }
 
-void VideoManagerSignalProxy::slotStartedDecoding(const QString &id, const QString &shmPath, int width, int height, bool isMixer)
+///The sink state, created as stopped
+VideoManagerSignalProxy::Sink& VideoManagerSignalProxy::sink(const QString& id)
 {
-    QTimer::singleShot(0, [=] {
-        if(m_pSem->available() == 3)
-            emit m_pParent->startedDecoding(id,shmPath,width,height,isMixer);
-        else {
-            QTimer::singleShot(0, [=] {
-                slotStartedDecoding(id,shmPath,width,height,isMixer);
-            });
-        }
-    });
+    if (!m_hSinks.contains(id))
+        m_hSinks[id] = Sink { Command::NONE, false, Params { QString(), 0, 0, false }, Params { QString(), 0, 0, false } };
+
+    return m_hSinks[id];
+}
+
+///Flush the pending commands once the current SignalQueue pass is over
+void VideoManagerSignalProxy::schedule(const QString& id)
+{
+    if (!m_lPending.contains(id))
+        m_lPending << id;
+
+    if (!m_Scheduled) {
+        m_Scheduled = true;
+        QMetaObject::invokeMethod(this, "flush", Qt::QueuedConnection);
+    }
+}
+
+///A pending stop is replaced, flush() compare the parameters with the running ones
+void VideoManagerSignalProxy::queueStarted(const QString &id, const QString &shmPath, int width, int height, bool isMixer)
+{
+    Sink& s = sink(id);
+
+    s.command = Command::START;
+    s.next    = Params { shmPath, width, height, isMixer };
+
+    schedule(id);
+}
+
+///A pending start the client never saw is cancelled
+void VideoManagerSignalProxy::queueStopped(const QString &id, const QString &shmPath, bool isMixer)
+{
+    Sink& s = sink(id);
+
+    s.command      = (s.command == Command::START && !s.started) ? Command::NONE : Command::STOP;
+    s.next.shmPath = shmPath;
+    s.next.isMixer = isMixer;
+
+    schedule(id);
 }
 
-void VideoManagerSignalProxy::slotStoppedDecoding(const QString &id, const QString &shmPath, bool isMixer)
+///Emit the coalesced commands, in the order the sinks got them
+void VideoManagerSignalProxy::flush()
 {
-    m_pSem->acquire(1);
-    QTimer::singleShot(0, [=] {
-        emit m_pParent->stoppedDecoding(id,shmPath,isMixer);
-        m_pSem->release(1);
-    });
+    m_Scheduled = false;
+
+    QStringList pending;
+    pending.swap(m_lPending);
+
+    foreach(const QString& id, pending) {
+        if (!m_hSinks.contains(id))
+            continue;
+
+        // The slots may queue new commands, work on a copy
+        const Sink s = m_hSinks[id];
+
+        m_hSinks[id].command = Command::NONE;
+
+        switch(s.command) {
+            case Command::START:
+                // A restart with the same parameters, the renderer is reused
+                if (s.started && s.next == s.current)
+                    break;
+
+                m_hSinks[id].started = true;
+                m_hSinks[id].current = s.next;
+
+                if (s.started)
+                    emit m_pParent->stoppedDecoding(id, s.current.shmPath, s.current.isMixer);
+
+                emit m_pParent->startedDecoding(id, s.next.shmPath, s.next.width, s.next.height, s.next.isMixer);
+                break;
+            case Command::STOP:
+                if (s.started) {
+                    m_hSinks[id].started = false;
+                    emit m_pParent->stoppedDecoding(id, s.next.shmPath, s.next.isMixer);
+                }
+                break;
+            case Command::NONE:
+            case Command::COUNT__:
+                break;
+        }
+
+        // Forget the stopped sinks
+        if (m_hSinks.contains(id) && !m_hSinks[id].started && m_hSinks[id].command == Command::NONE)
+            m_hSinks.remove(id);
+    }
 }
@@ -26,10 +26,10 @@
 #include <QtCore/QObject>
 #include <QtCore/QCoreApplication>
 #include <QtCore/QByteArray>
+#include <QtCore/QHash>
 #include <QtCore/QThread>
 #include <QtCore/QList>
 #include <QtCore/QMap>
-#include <QtCore/QSemaphore>
 #include <QtCore/QString>
 #include <QtCore/QStringList>
 #include <QtCore/QVariant>
@@ -40,40 +40,73 @@
 
 #include "typedefs.h"
 #include "conversions_wrap.hpp"
+#include "signalqueue_wrap.h"
 
 class VideoManagerInterface;
-class QSemaphore;
 
+/**
+ * Sequence the decoding start and stop of each sink.
+ *
+ * The daemon signals reach this object through the SignalQueue, in order.
+ * The commands of a sink are then coalesced until the end of the event
+ * loop iteration: a start followed by a stop is dropped if the client
+ * never saw the start, and a stop followed by a start of a running sink is
+ * dropped if the shared memory path, the size and the mixer flag did not
+ * change, so the existing renderer is reused. Otherwise the stop and the
+ * start are both sent, in order. Nothing ever wait, neither in the daemon
+ * thread nor in the Qt one.
+ */
 class VideoManagerSignalProxy : public QObject
 {
    Q_OBJECT
 public:
    VideoManagerSignalProxy(VideoManagerInterface* parent);
 
-public Q_SLOTS:
-   void slotDeviceEvent();
-   void slotStartedDecoding(const QString &id, const QString &shmPath, int width, int height, bool isMixer);
-   void slotStoppedDecoding(const QString &id, const QString &shmPath, bool isMixer);
+   //Mutators
+   void queueStarted(const QString &id, const QString &shmPath, int width, int height, bool isMixer);
+   void queueStopped(const QString &id, const QString &shmPath, bool isMixer);
 
 private:
-   VideoManagerInterface* m_pParent;
-   QSemaphore*            m_pSem;
-};
-
-class VideoManagerProxySender : public QObject
-{
-    Q_OBJECT
-    friend class VideoManagerInterface;
-public:
-
-Q_SIGNALS:
-    void deviceEvent();
-    void startedDecoding(const QString &id, const QString &shmPath, int width, int height, bool isMixer);
-    void stoppedDecoding(const QString &id, const QString &shmPath, bool isMixer);
+   ///The pending command of a sink
+   enum class Command {
+      NONE ,
+      START,
+      STOP ,
+      COUNT__
+   };
+
+   ///The decoding parameters of a sink
+   struct Params {
+      QString shmPath;
+      int     width  ;
+      int     height ;
+      bool    isMixer;
+
+      bool operator==(const Params& other) const;
+   };
+
+   ///A sink, as requested by the daemon and as last seen by the client
+   struct Sink {
+      Command command; /*!< Pending, already coalesced    */
+      bool    started; /*!< Last state sent to the client */
+      Params  next   ; /*!< Of the pending command        */
+      Params  current; /*!< Last started by the client    */
+   };
+
+   //Attributes
+   VideoManagerInterface* m_pParent  ;
+   QHash<QString, Sink>   m_hSinks   ;
+   QStringList            m_lPending ; /*!< Sinks with a command, in arrival order */
+   bool                   m_Scheduled; /*!< A flush() is already queued           */
+
+   //Helpers
+   Sink& sink(const QString& id);
+   void  schedule(const QString& id);
+
+private Q_SLOTS:
+   void flush();
 };
 
-
-
 /*
  * Proxy class for interface org.ring.Ring.VideoManager
  */
@@ -94,11 +127,11 @@ public:
 
 private:
     VideoManagerSignalProxy* proxy;
-    VideoManagerProxySender* sender;
 
 public Q_SLOTS: // METHODS
     void applySettings(const QString &name, MapStringString settings)
     {
+        TRACE_DRING_CALL;
 #ifdef ENABLE_VIDEO
         DRing::applySettings(
             name.toStdString(), convertMap(settings));
@@ -108,17 +141,18 @@ public Q_SLOTS: // METHODS
 // TODO: test!!!!!!!!!!!!!!!
     MapStringMapStringVectorString getCapabilities(const QString &name)
     {
+        TRACE_DRING_CALL;
         MapStringMapStringVectorString ret;
 #ifdef ENABLE_VIDEO
         std::map<std::string, std::map<std::string, std::vector<std::string>>> temp;
         temp = DRing::getCapabilities(name.toStdString());
 
         for (auto& x : temp) {
-                QMap<QString, VectorString> ytemp;
+            QMap<QString, VectorString> ytemp;
             for (auto& y : x.second) {
-                ytemp[QString(y.first.c_str())] = convertVectorString(y.second);
+                ytemp.insert(ytemp.constEnd(), internKey(y.first), convertVectorString(y.second));
             }
-            ret[QString(x.first.c_str())] = ytemp;
+            ret.insert(ret.constEnd(), toQString(x.first), ytemp);
         }
 #endif
         return ret;
@@ -126,6 +160,7 @@ public Q_SLOTS: // METHODS
 
     QString getDefaultDevice()
     {
+        TRACE_DRING_CALL;
 #ifdef ENABLE_VIDEO
         QString temp(
             DRing::getDefaultDevice().c_str());
@@ -137,6 +172,7 @@ public Q_SLOTS: // METHODS
 
     QStringList getDeviceList()
     {
+        TRACE_DRING_CALL;
 #ifdef ENABLE_VIDEO
         QStringList temp =
             convertStringList(DRing::getDeviceList());
@@ -148,6 +184,7 @@ public Q_SLOTS: // METHODS
 
     MapStringString getSettings(const QString &device)
     {
+        TRACE_DRING_CALL;
 #ifdef ENABLE_VIDEO
         MapStringString temp =
             convertMap(DRing::getSettings(device.toStdString()));
@@ -159,6 +196,7 @@ public Q_SLOTS: // METHODS
 
     bool hasCameraStarted()
     {
+        TRACE_DRING_CALL;
 #ifdef ENABLE_VIDEO
         return DRing::hasCameraStarted();
 #else
@@ -168,6 +206,7 @@ public Q_SLOTS: // METHODS
 
     void setDefaultDevice(const QString &name)
     {
+        TRACE_DRING_CALL;
 #ifdef ENABLE_VIDEO
         DRing::setDefaultDevice(name.toStdString());
 #endif
@@ -175,6 +214,7 @@ public Q_SLOTS: // METHODS
 
     void startCamera()
     {
+        TRACE_DRING_CALL;
 #ifdef ENABLE_VIDEO
         DRing::startCamera();
 #endif
@@ -182,6 +222,7 @@ public Q_SLOTS: // METHODS
 
     void stopCamera()
     {
+        TRACE_DRING_CALL;
 #ifdef ENABLE_VIDEO
         DRing::stopCamera();
 #endif
@@ -189,6 +230,7 @@ public Q_SLOTS: // METHODS
 
     bool switchInput(const QString &resource)
     {
+        TRACE_DRING_CALL;
 #ifdef ENABLE_VIDEO
         return DRing::switchInput(resource.toStdString());
 #else
@@ -198,6 +240,7 @@ public Q_SLOTS: // METHODS
 
     void registerSinkTarget(const QString &sinkID, std::function<void(uint8_t*)>&& cb)
     {
+        TRACE_DRING_CALL;
 #ifdef ENABLE_VIDEO
         DRing::registerSinkTarget(sinkID.toStdString(), std::move(cb));
 #endif
@@ -205,6 +248,7 @@ public Q_SLOTS: // METHODS
 
     void registerSinkTarget(const QString &sinkID, std::function<void(uint8_t*)>& cb)
     {
+        TRACE_DRING_CALL;
 #ifdef ENABLE_VIDEO
         DRing::registerSinkTarget(sinkID.toStdString(), std::move(cb));
 #endif
@@ -19,13 +19,15 @@
 
 //Ring
 #include "resolution.h"
+#include "rate.h"
 #include "device.h"
 #include "../dbus/videomanager.h"
 #include "../private/videochannel_p.h"
 #include "../private/videodevice_p.h"
+#include "../private/videoresolution_p.h"
 
 VideoChannelPrivate::VideoChannelPrivate() : m_pCurrentResolution(nullptr),
-m_pDevice(nullptr)
+m_pDevice(nullptr), m_Loaded(false)
 {
 }
 
@@ -43,6 +45,7 @@ Video::Channel::~Channel()
 
 QVariant Video::Channel::data( const QModelIndex& index, int role) const
 {
+   loadResolutions();
    if (index.isValid() && role == Qt::DisplayRole && d_ptr->m_lValidResolutions.size() > index.row()) {
       return d_ptr->m_lValidResolutions[index.row()]->name();
    }
@@ -51,7 +54,11 @@ QVariant Video::Channel::data( const QModelIndex& index, int role) const
 
 int Video::Channel::rowCount( const QModelIndex& parent) const
 {
-   return (parent.isValid())?0:d_ptr->m_lValidResolutions.size();
+   if (parent.isValid())
+      return 0;
+
+   loadResolutions();
+   return d_ptr->m_lValidResolutions.size();
 }
 
 Qt::ItemFlags Video::Channel::flags( const QModelIndex& idx) const
@@ -75,11 +82,13 @@ int Video::Channel::relativeIndex() {
 
 bool Video::Channel::setActiveResolution(int idx)
 {
+   loadResolutions();
    if (idx < 0 || idx >= d_ptr->m_lValidResolutions.size()) return false;
    return setActiveResolution(d_ptr->m_lValidResolutions[idx]);
 }
 
 bool Video::Channel::setActiveResolution(Video::Resolution* res) {
+   loadResolutions();
    if ((!res) || d_ptr->m_lValidResolutions.indexOf(res) == -1 || res->name().isEmpty()) {
       qWarning() << "Invalid active resolution" << (res?res->name():"NULL");
       return false;
@@ -90,6 +99,7 @@ bool Video::Channel::setActiveResolution(Video::Resolution* res) {
 
    d_ptr->m_pCurrentResolution = res;
    d_ptr->m_pDevice->save();
+   emit activeResolutionChanged(res);
    return true;
 }
 
@@ -121,9 +131,123 @@ QString Video::Channel::name() const
 
 QList<Video::Resolution*> Video::Channel::validResolutions() const
 {
+   loadResolutions();
    return d_ptr->m_lValidResolutions;
 }
 Video::Device* Video::Channel::device() const
 {
    return d_ptr->m_pDevice;
 }
+
+/**
+ * Create the resolutions and rates objects the first time they are needed.
+ *
+ * Most channels are never displayed nor selected, there is no need to
+ * allocate their whole capability tree when the device is created.
+ */
+void Video::Channel::loadResolutions() const
+{
+   if (d_ptr->m_Loaded)
+      return;
+
+   d_ptr->m_Loaded = true;
+
+   Video::Channel* self = const_cast<Video::Channel*>(this);
+
+   for (auto i = d_ptr->m_Capabilities.constBegin(); i != d_ptr->m_Capabilities.constEnd(); ++i) {
+      Video::Resolution* res = new Video::Resolution(i.key(), self);
+      d_ptr->m_lValidResolutions << res;
+
+      foreach(const QString& rate, i.value())
+         res->d_ptr->m_lValidRates << new Video::Rate(res, rate);
+   }
+}
+
+/**
+ * Replace the capabilities.
+ *
+ * The resolutions and rates which still exist are kept, along with the
+ * active ones. Those which disappeared are only removed from the lists, as
+ * a client may still use them, they are freed with the channel.
+ */
+void Video::Channel::setCapabilities(const MapStringVectorString& cap)
+{
+   if (d_ptr->m_Capabilities == cap)
+      return;
+
+   d_ptr->m_Capabilities = cap;
+
+   // Nothing was created yet, loadResolutions() will use the new ones
+   if (!d_ptr->m_Loaded)
+      return;
+
+   Video::Resolution* current = d_ptr->m_pCurrentResolution;
+
+   for (int i = d_ptr->m_lValidResolutions.size() - 1; i >= 0; i--) {
+      Video::Resolution* res = d_ptr->m_lValidResolutions[i];
+
+      if (cap.contains(res->name()))
+         continue;
+
+      beginRemoveRows(QModelIndex(), i, i);
+      d_ptr->m_lValidResolutions.removeAt(i);
+      endRemoveRows();
+
+      if (d_ptr->m_pCurrentResolution == res)
+         d_ptr->m_pCurrentResolution = nullptr;
+   }
+
+   for (auto i = cap.constBegin(); i != cap.constEnd(); ++i) {
+      Video::Resolution* res = nullptr;
+
+      foreach(Video::Resolution* r, d_ptr->m_lValidResolutions) {
+         if (r->name() == i.key()) {
+            res = r;
+            break;
+         }
+      }
+
+      if (!res) {
+         beginInsertRows(QModelIndex(), d_ptr->m_lValidResolutions.size(), d_ptr->m_lValidResolutions.size());
+         res = new Video::Resolution(i.key(), this);
+         d_ptr->m_lValidResolutions << res;
+         endInsertRows();
+      }
+
+      VideoResolutionPrivate* rd = res->d_ptr;
+
+      for (int j = rd->m_lValidRates.size() - 1; j >= 0; j--) {
+         if (i.value().contains(rd->m_lValidRates[j]->name()))
+            continue;
+
+         res->beginRemoveRows(QModelIndex(), j, j);
+
+         if (rd->m_pCurrentRate == rd->m_lValidRates[j])
+            rd->m_pCurrentRate = nullptr;
+
+         rd->m_lValidRates.removeAt(j);
+         res->endRemoveRows();
+      }
+
+      foreach(const QString& name, i.value()) {
+         bool found = false;
+
+         foreach(Video::Rate* rate, rd->m_lValidRates) {
+            if (rate->name() == name) {
+               found = true;
+               break;
+            }
+         }
+
+         if (!found) {
+            res->beginInsertRows(QModelIndex(), rd->m_lValidRates.size(), rd->m_lValidRates.size());
+            rd->m_lValidRates << new Video::Rate(res, name);
+            res->endInsertRows();
+         }
+      }
+   }
+
+   // A new one is picked, from the daemon settings or the first valid one
+   if (d_ptr->m_pCurrentResolution != current)
+      emit activeResolutionChanged(activeResolution());
+}
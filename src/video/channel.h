@@ -29,14 +29,21 @@ namespace Video {
    class Device;
 }
 class VideoChannelPrivate;
+class VideoDevicePrivate;
 
 namespace Video {
 
 ///@typedef Channel A channel available in a Device
 class LIB_EXPORT Channel : public QAbstractListModel
 {
+   #pragma GCC diagnostic push
+   #pragma GCC diagnostic ignored "-Wzero-as-null-pointer-constant"
+   Q_OBJECT
+   #pragma GCC diagnostic pop
+
    //Only Video::Device can add resolutions
    friend class Video::Device;
+   friend class ::VideoDevicePrivate;
 public:
    QString name() const;
    Video::Resolution* activeResolution();
@@ -57,7 +64,15 @@ private:
    Channel(Video::Device* dev,const QString& name);
    virtual ~Channel();
 
+   //Helpers
+   void setCapabilities(const MapStringVectorString& cap);
+   void loadResolutions() const;
+
    QScopedPointer<VideoChannelPrivate> d_ptr;
+
+Q_SIGNALS:
+   ///The active resolution was changed or removed by the daemon
+   void activeResolutionChanged(Video::Resolution* res);
 };
 
 }
@@ -0,0 +1,535 @@
+/****************************************************************************
+ *   Copyright (C) 2015 by Savoir-Faire Linux                               *
+ *   Author : Emmanuel Lepage Vallee <emmanuel.lepage@savoirfairelinux.com> *
+ *                                                                          *
+ *   This library is free software; you can redistribute it and/or          *
+ *   modify it under the terms of the GNU Lesser General Public             *
+ *   License as published by the Free Software Foundation; either           *
+ *   version 2.1 of the License, or (at your option) any later version.     *
+ *                                                                          *
+ *   This library is distributed in the hope that it will be useful,        *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU      *
+ *   Lesser General Public License for more details.                        *
+ *                                                                          *
+ *   You should have received a copy of the GNU General Public License      *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>.  *
+ ***************************************************************************/
+#include "compositor.h"
+
+//Qt
+#include <QtCore/QMutex>
+#include <QtCore/QTimer>
+#include <QtCore/QVector>
+
+//STD
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+
+//Ring
+#include "video/frameconverter.h"
+#include "private/videorenderer_p.h"
+#include "private/videorenderermanager.h"
+
+namespace Video {
+
+/* Implementation note: threading
+ * The Compositor live in the thread it was created in, like any client
+ * object. The composition is done by CompositorPrivate, which is moved to
+ * the renderer worker pool. It write into a back buffer and swap it with
+ * the front one under the renderer mutex, then queue the notification to
+ * the Compositor thread, where the pacing timer, the views and the sinks
+ * live.
+ *
+ * m_Mutex is held for the whole composition pass. This way, removing a
+ * source or destroying the Compositor wait for the pass to be over. Each
+ * source frame is only leased for the time of its own blit.
+ *
+ * The renderers are destroyed in their own thread. They detach themselves
+ * from all compositors before anything is torn down, using the registry of
+ * the live compositors. The lock order is the registry mutex, then m_Mutex,
+ * then the source renderers mutex.
+ */
+
+class CompositorPrivate : public QObject
+{
+   Q_OBJECT
+public:
+   CompositorPrivate(Compositor* parent);
+
+   ///A composited renderer and the last generation drawn
+   struct Source {
+      Video::Renderer* renderer;
+      uint             frameGen;
+   };
+
+   // Constants
+   constexpr static const int  DEFAULT_RATE = 30      ;
+   constexpr static const uint BACKGROUND   = 0xFF000000; /*!< Opaque black in BGRA and RGBA */
+
+   // Attributes
+   QMutex             m_Mutex       ; /*!< Protect the sources, the layout and q_ptr */
+   QVector<Source>    m_lSources    ;
+   Compositor::Layout m_Layout      ;
+   QList<QRectF>      m_lRegions    ; /*!< Normalized regions of the CUSTOM layout   */
+   bool               m_Dirty       ; /*!< The layout changed since the last pass    */
+   QByteArray         m_lBuffers[2] ; /*!< Front and back output frames              */
+   int                m_Back        ;
+   uint               m_FrameGen    ;
+   std::atomic_int    m_FrameRate   ;
+   QTimer*            m_pTimer      ;
+   Compositor*        q_ptr         ;
+
+   // Registry of the live compositors
+   static QMutex*                    registryMutex();
+   static QList<CompositorPrivate*>& registry     ();
+
+   // Helpers
+   QList<QRectF> layoutRegions(int count) const;
+   static QRect  fit          (const QSize& source, const QRect& region);
+   static uint   currentGen   (Video::Renderer* r);
+   bool          removeSource (Video::Renderer* r);
+   void          blit         (const Video::Renderer::Frame& f, const QRectF& region, const QSize& size,
+                                 QByteArray& back, Video::Renderer::ColorSpace cs) const;
+
+public Q_SLOTS:
+   void start  ();
+   void stop   ();
+   void compose();
+};
+
+}
+
+Video::CompositorPrivate::CompositorPrivate(Compositor* parent) : QObject(nullptr),
+m_Layout(Compositor::Layout::GRID), m_Dirty(true), m_Back(0), m_FrameGen(0),
+m_FrameRate(DEFAULT_RATE), m_pTimer(nullptr), q_ptr(parent)
+{
+}
+
+///Constructor
+Video::Compositor::Compositor(const QSize& res, QObject* parent) :
+Renderer("compositor:"+QByteArray::number(reinterpret_cast<quintptr>(this), 16), res),
+d_ptr(new CompositorPrivate(this))
+{
+   setParent(parent);
+   setObjectName("Video::Compositor");
+
+   // Renderers are only removed from the manager when they stop decoding
+   connect(VideoRendererManager::instance(), &VideoRendererManager::rendererRemoved,
+      this, &Compositor::removeRenderer);
+
+   {
+      QMutexLocker lk {CompositorPrivate::registryMutex()};
+      CompositorPrivate::registry() << d_ptr;
+   }
+
+   VideoRendererManager::instance()->schedule(d_ptr);
+}
+
+/**
+ * Destructor
+ *
+ * Wait for the composition pass in progress, if any, then let the worker
+ * dispose of the private object.
+ */
+Video::Compositor::~Compositor()
+{
+   // The Compositor may itself be the source of another one
+   Video::Renderer::d_ptr->detachCompositors();
+
+   {
+      QMutexLocker lk  {CompositorPrivate::registryMutex()};
+      QMutexLocker lk2 {&d_ptr->m_Mutex                  };
+
+      CompositorPrivate::registry().removeAll(d_ptr);
+
+      d_ptr->m_lSources.clear();
+      d_ptr->q_ptr = nullptr;
+   }
+
+   VideoRendererManager::instance()->unschedule(d_ptr);
+
+   QMetaObject::invokeMethod(d_ptr, "stop", Qt::QueuedConnection);
+   d_ptr->deleteLater();
+}
+
+/*****************************************************************************
+ *                                                                           *
+ *                                 Getters                                   *
+ *                                                                           *
+ ****************************************************************************/
+
+///The composited renderers, in layout order
+QList<Video::Renderer*> Video::Compositor::renderers() const
+{
+   QMutexLocker lk {&d_ptr->m_Mutex};
+
+   QList<Video::Renderer*> ret;
+
+   for (const CompositorPrivate::Source& s : d_ptr->m_lSources)
+      ret << s.renderer;
+
+   return ret;
+}
+
+Video::Compositor::Layout Video::Compositor::layout() const
+{
+   QMutexLocker lk {&d_ptr->m_Mutex};
+   return d_ptr->m_Layout;
+}
+
+///The normalized region of each renderer for the current layout
+QList<QRectF> Video::Compositor::regions() const
+{
+   QMutexLocker lk {&d_ptr->m_Mutex};
+   return d_ptr->layoutRegions(d_ptr->m_lSources.size());
+}
+
+///The maximum number of frames composited per second
+int Video::Compositor::frameRate() const
+{
+   return d_ptr->m_FrameRate;
+}
+
+Video::Renderer::ColorSpace Video::Compositor::colorSpace() const
+{
+   return Video::Renderer::d_ptr->colorSpace(Video::Renderer::ColorSpace::BGRA);
+}
+
+/*****************************************************************************
+ *                                                                           *
+ *                                 Setters                                   *
+ *                                                                           *
+ ****************************************************************************/
+
+void Video::Compositor::setLayout(Layout layout)
+{
+   QMutexLocker lk {&d_ptr->m_Mutex};
+   d_ptr->m_Layout = layout;
+   d_ptr->m_Dirty  = true;
+}
+
+/**
+ * Set the regions used by the CUSTOM layout.
+ *
+ * The regions are normalized, from (0,0) to (1,1), and are used in the
+ * renderers order. The renderers without a region are not drawn.
+ */
+void Video::Compositor::setRegions(const QList<QRectF>& regions)
+{
+   QMutexLocker lk {&d_ptr->m_Mutex};
+   d_ptr->m_lRegions = regions;
+   d_ptr->m_Dirty    = true;
+}
+
+void Video::Compositor::setFrameRate(int fps)
+{
+   d_ptr->m_FrameRate = fps > 0 ? fps : CompositorPrivate::DEFAULT_RATE;
+
+   if (isRendering())
+      QMetaObject::invokeMethod(d_ptr, "start", Qt::QueuedConnection);
+}
+
+/*****************************************************************************
+ *                                                                           *
+ *                                 Mutators                                  *
+ *                                                                           *
+ ****************************************************************************/
+
+///Add a renderer at the end of the layout
+void Video::Compositor::addRenderer(Renderer* renderer)
+{
+   if ((!renderer) || renderer == this)
+      return;
+
+   QMutexLocker lk {&d_ptr->m_Mutex};
+
+   for (const CompositorPrivate::Source& s : d_ptr->m_lSources) {
+      if (s.renderer == renderer)
+         return;
+   }
+
+   d_ptr->m_lSources << CompositorPrivate::Source { renderer, 0 };
+   d_ptr->m_Dirty = true;
+}
+
+void Video::Compositor::removeRenderer(Renderer* renderer)
+{
+   QMutexLocker lk {&d_ptr->m_Mutex};
+   d_ptr->removeSource(renderer);
+}
+
+/**
+ * Remove a renderer being destroyed from all the compositors.
+ *
+ * This wait for the composition passes in progress, the renderer is never
+ * used again once this return.
+ */
+void Video::Compositor::detachRenderer(Renderer* renderer)
+{
+   QMutexLocker lk {CompositorPrivate::registryMutex()};
+
+   for (CompositorPrivate* d : CompositorPrivate::registry()) {
+      QMutexLocker lk2 {&d->m_Mutex};
+      d->removeSource(renderer);
+   }
+}
+
+///Forget a source, m_Mutex has to be held
+bool Video::CompositorPrivate::removeSource(Video::Renderer* r)
+{
+   for (int i = 0; i < m_lSources.size(); i++) {
+      if (m_lSources[i].renderer == r) {
+         m_lSources.remove(i);
+         m_Dirty = true;
+         return true;
+      }
+   }
+
+   return false;
+}
+
+void Video::Compositor::startRendering()
+{
+   Video::Renderer::d_ptr->m_isRendering = true;
+   QMetaObject::invokeMethod(d_ptr, "start", Qt::QueuedConnection);
+   emit started();
+}
+
+void Video::Compositor::stopRendering()
+{
+   Video::Renderer::d_ptr->m_isRendering = false;
+   QMetaObject::invokeMethod(d_ptr, "stop", Qt::QueuedConnection);
+   emit stopped();
+}
+
+///Notify the views from the Compositor thread
+void Video::Compositor::slotFrameReady()
+{
+   Video::Renderer::d_ptr->notifyFrame();
+}
+
+/*****************************************************************************
+ *                                                                           *
+ *                                 Helpers                                   *
+ *                                                                           *
+ ****************************************************************************/
+
+///The normalized region of each of the "count" sources
+QList<QRectF> Video::CompositorPrivate::layoutRegions(int count) const
+{
+   QList<QRectF> ret;
+
+   if (!count)
+      return ret;
+
+   switch(m_Layout) {
+      case Compositor::Layout::GRID: {
+         const int cols = static_cast<int>(std::ceil(std::sqrt(static_cast<double>(count))));
+         const int rows = (count + cols - 1) / cols;
+
+         for (int i = 0; i < count; i++)
+            ret << QRectF(qreal(i % cols) / cols, qreal(i / cols) / rows, 1.0 / cols, 1.0 / rows);
+      }
+         break;
+      case Compositor::Layout::FOCUS:
+         if (count == 1) {
+            ret << QRectF(0, 0, 1, 1);
+            break;
+         }
+
+         // The others share a strip at the bottom
+         ret << QRectF(0, 0, 1, 0.75);
+
+         for (int i = 0; i < count - 1; i++)
+            ret << QRectF(qreal(i) / (count - 1), 0.75, 1.0 / (count - 1), 0.25);
+
+         break;
+      case Compositor::Layout::PICTURE_IN_PICTURE:
+         ret << QRectF(0, 0, 1, 1);
+
+         // The others are stacked from the bottom right corner
+         for (int i = 1; i < count; i++)
+            ret << QRectF(1.0 - 0.27 * i, 0.73, 0.25, 0.25);
+
+         break;
+      case Compositor::Layout::CUSTOM:
+         ret = m_lRegions.mid(0, count);
+         break;
+      case Compositor::Layout::COUNT__:
+         break;
+   }
+
+   return ret;
+}
+
+///Protect registry()
+QMutex* Video::CompositorPrivate::registryMutex()
+{
+   static QMutex m;
+   return &m;
+}
+
+///The live compositors
+QList<Video::CompositorPrivate*>& Video::CompositorPrivate::registry()
+{
+   static QList<CompositorPrivate*> l;
+   return l;
+}
+
+///The generation of the current frame of a renderer, 0 if it has none
+uint Video::CompositorPrivate::currentGen(Video::Renderer* r)
+{
+   Video::RendererPrivate* rd = r->Video::Renderer::d_ptr;
+
+   QMutexLocker lk {rd->m_pMutex};
+
+   return rd->m_pFrame ? rd->m_FrameGen : 0;
+}
+
+///The largest rectangle of the source aspect ratio centered in region
+QRect Video::CompositorPrivate::fit(const QSize& source, const QRect& region)
+{
+   const QSize size = source.scaled(region.size(), Qt::KeepAspectRatio);
+
+   return QRect(
+      region.x() + (region.width () - size.width ()) / 2,
+      region.y() + (region.height() - size.height()) / 2,
+      size.width(), size.height()
+   );
+}
+
+void Video::CompositorPrivate::start()
+{
+   if (!m_pTimer) {
+      m_pTimer = new QTimer(this);
+      m_pTimer->setTimerType(Qt::PreciseTimer);
+      connect(m_pTimer, &QTimer::timeout, this, &CompositorPrivate::compose);
+   }
+
+   {
+      QMutexLocker lk {&m_Mutex};
+      m_Dirty = true;
+   }
+
+   m_pTimer->start(1000 / m_FrameRate);
+}
+
+void Video::CompositorPrivate::stop()
+{
+   if (m_pTimer)
+      m_pTimer->stop();
+}
+
+///Scale a source frame into its region of the back buffer
+void Video::CompositorPrivate::blit(const Video::Renderer::Frame& f, const QRectF& n, const QSize& size,
+                                   QByteArray& back, Video::Renderer::ColorSpace cs) const
+{
+   if ((!f.data) || f.resolution.isEmpty())
+      return;
+
+   const uint stride = size.width() * 4;
+
+   const QRect tile = fit(f.resolution, QRect(
+      qRound(n.x() * size.width()), qRound(n.y() * size.height()),
+      qRound(n.width() * size.width()), qRound(n.height() * size.height())
+   ).intersected(QRect(QPoint(0, 0), size)));
+
+   if (tile.isEmpty())
+      return;
+
+   char* dst = back.data() + tile.y() * stride + tile.x() * 4;
+
+   FrameConverter::scale(f.data, f.stride, f.resolution, dst, stride, tile.size());
+
+   // The blit kept the source byte order, swap it in place if needed
+   if (f.colorSpace != cs) {
+      FrameConverter::convert(
+         dst, f.colorSpace == Video::Renderer::ColorSpace::BGRA ?
+            FrameConverter::Format::BGRA : FrameConverter::Format::RGBA, stride,
+         dst, cs == Video::Renderer::ColorSpace::BGRA ?
+            FrameConverter::Format::BGRA : FrameConverter::Format::RGBA, stride,
+         tile.size()
+      );
+   }
+}
+
+/**
+ * Composite the latest frame of each source into the back buffer and
+ * publish it.
+ *
+ * Nothing is done if none of the sources produced a frame since the last
+ * pass and the layout didn't change.
+ */
+void Video::CompositorPrivate::compose()
+{
+   QMutexLocker lk {&m_Mutex};
+
+   if ((!q_ptr) || (!q_ptr->isRendering()))
+      return;
+
+   Video::RendererPrivate* rd = q_ptr->Video::Renderer::d_ptr;
+
+   const QSize size = rd->m_pSize;
+
+   if (size.isEmpty())
+      return;
+
+   bool changed = m_Dirty;
+
+   for (const Source& src : m_lSources) {
+      const uint gen = currentGen(src.renderer);
+      changed |= gen && gen != src.frameGen;
+   }
+
+   if (!changed)
+      return;
+
+   const Video::Renderer::ColorSpace cs = q_ptr->colorSpace();
+   const int   length = size.width() * 4 * size.height();
+   QByteArray& back   = m_lBuffers[m_Back];
+
+   // The buffer may still be leased by a client or held by a sink
+   if (back.size() != length || !back.isDetached())
+      back = QByteArray(length, Qt::Uninitialized);
+
+   const uint background = BACKGROUND;
+   uint*      pixels     = reinterpret_cast<uint*>(back.data());
+   std::fill(pixels, pixels + size.width() * size.height(), background);
+
+   const QList<QRectF> regions = layoutRegions(m_lSources.size());
+
+   for (int i = 0; i < regions.size(); i++) {
+      // Only hold the frame for the time of its own blit
+      const Video::Renderer::Frame f = m_lSources[i].renderer->acquireFrame();
+
+      m_lSources[i].frameGen = f.frameGen;
+
+      blit(f, regions[i], size, back, cs);
+
+      m_lSources[i].renderer->releaseFrame(f);
+   }
+
+   m_Dirty = false;
+
+   {
+      QMutexLocker lk2 {rd->m_pMutex};
+
+      // Leases share the buffer, it is not written again while they exist
+      rd->m_FrameBuffer = back;
+      rd->m_pFrame      = const_cast<char*>(rd->m_FrameBuffer.constData());
+      rd->m_FrameSize   = rd->m_FrameBuffer.size();
+      rd->m_FrameGen    = ++m_FrameGen;
+      rd->m_Timestamp   = RendererPrivate::now();
+
+      rd->updateScaledOutputs();
+      rd->updateSharedFrame  ();
+
+      m_Back ^= 1;
+   }
+
+   QMetaObject::invokeMethod(q_ptr, "slotFrameReady", Qt::QueuedConnection);
+}
+
+#include <compositor.moc>
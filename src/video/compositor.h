@@ -0,0 +1,100 @@
+/****************************************************************************
+ *   Copyright (C) 2015 by Savoir-Faire Linux                               *
+ *   Author : Emmanuel Lepage Vallee <emmanuel.lepage@savoirfairelinux.com> *
+ *                                                                          *
+ *   This library is free software; you can redistribute it and/or          *
+ *   modify it under the terms of the GNU Lesser General Public             *
+ *   License as published by the Free Software Foundation; either           *
+ *   version 2.1 of the License, or (at your option) any later version.     *
+ *                                                                          *
+ *   This library is distributed in the hope that it will be useful,        *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU      *
+ *   Lesser General Public License for more details.                        *
+ *                                                                          *
+ *   You should have received a copy of the GNU General Public License      *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>.  *
+ ***************************************************************************/
+#ifndef VIDEO_COMPOSITOR_H
+#define VIDEO_COMPOSITOR_H
+
+//Base
+#include "video/renderer.h"
+#include <typedefs.h>
+
+//Qt
+#include <QtCore/QList>
+#include <QtCore/QRectF>
+
+namespace Video {
+
+class CompositorPrivate;
+
+/**
+ * Blend many renderers into a single frame, for example to record a
+ * conference or to display it on a low power device.
+ *
+ * The composition run on the renderer worker pool. As it is a Renderer
+ * itself, the result can be shown by the existing views, scaled or handed
+ * to sinks like any other stream.
+ *
+ * The renderers stopped by the daemon or destroyed are removed automatically.
+ */
+class LIB_EXPORT Compositor : public Renderer
+{
+   #pragma GCC diagnostic push
+   #pragma GCC diagnostic ignored "-Wzero-as-null-pointer-constant"
+   Q_OBJECT
+   #pragma GCC diagnostic pop
+
+   friend class CompositorPrivate;
+   friend class RendererPrivate  ;
+
+public:
+   ///How the renderers are placed in the output frame
+   enum class Layout {
+      GRID              , /*!< Equal tiles, in as many rows as columns            */
+      FOCUS             , /*!< The first renderer large, the others in a strip    */
+      PICTURE_IN_PICTURE, /*!< The first renderer full frame, the others inset    */
+      CUSTOM            , /*!< The regions set with setRegions()                  */
+      COUNT__
+   };
+
+   //Constructor
+   explicit Compositor(const QSize& res, QObject* parent = nullptr);
+   virtual ~Compositor();
+
+   //Getters
+   QList<Renderer*>   renderers () const;
+   Layout             layout    () const;
+   QList<QRectF>      regions   () const;
+   int                frameRate () const;
+   virtual ColorSpace colorSpace() const override;
+
+   //Setters
+   void setLayout   ( Layout layout                 );
+   void setRegions  ( const QList<QRectF>& regions  );
+   void setFrameRate( int fps                       );
+
+   //Mutators
+   void addRenderer   ( Renderer* renderer );
+   void removeRenderer( Renderer* renderer );
+
+private:
+   CompositorPrivate* d_ptr;
+   Q_DECLARE_PRIVATE(Compositor)
+
+   //Helpers
+   static void detachRenderer(Renderer* renderer);
+
+public Q_SLOTS:
+   virtual void startRendering() override;
+   virtual void stopRendering () override;
+
+private Q_SLOTS:
+   void slotFrameReady();
+};
+
+}
+
+#endif
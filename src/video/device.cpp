@@ -18,9 +18,16 @@
 #include "device.h"
 
 //Qt
+#include <QtCore/QDataStream>
+#include <QtCore/QDir>
+#include <QtCore/QFile>
+#include <QtCore/QFileInfo>
+#include <QtCore/QSaveFile>
+#include <QtCore/QStandardPaths>
 #include <QtCore/QTimer>
 
 //Ring
+#include "../dbus/asyncquery.h"
 #include "../dbus/videomanager.h"
 #include "devicemodel.h"
 #include "resolution.h"
@@ -45,29 +52,14 @@ Video::Device::Device(const QString &id) : QAbstractListModel(nullptr),
 d_ptr(new VideoDevicePrivate(this))
 {
    d_ptr->m_DeviceId = id;
-   VideoManagerInterface& interface = DBus::VideoManager::instance();
-   MapStringMapStringVectorString cap = interface.getCapabilities(id);
-   QMapIterator<QString, MapStringVectorString> channels(cap);
-   while (channels.hasNext()) {
-      channels.next();
-
-      Video::Channel* chan = new Video::Channel(this,channels.key());
-      d_ptr->m_lChannels << chan;
-
-      QMapIterator<QString, VectorString> resolutions(channels.value());
-      while (resolutions.hasNext()) {
-         resolutions.next();
 
-         Video::Resolution* res = new Video::Resolution(resolutions.key(),chan);
-         chan->d_ptr->m_lValidResolutions << res;
+   // Use the capabilities from the previous session, if any, while the
+   // daemon is asked for them. The channels are filled on demand
+   MapStringMapStringVectorString cap;
+   if (VideoDeviceCache::capabilities(id, cap))
+      d_ptr->setCapabilities(cap);
 
-         foreach(const QString& rate, resolutions.value()) {
-            Video::Rate* r = new Video::Rate(res,rate);
-            res->d_ptr->m_lValidRates << r;
-         }
-      }
-   }
-   Q_UNUSED(cap)
+   d_ptr->revalidate();
 }
 
 ///Destructor
@@ -224,3 +216,162 @@ void VideoDevicePrivate::saveIdle()
       Video::PreviewManager::instance()->startPreview();
    }
 }
+
+/**
+ * Fetch the capabilities from the daemon and update the cache if they changed.
+ *
+ * Probing a camera can take a while, so the reply is not waited for. An
+ * unknown device has no channel until it arrives.
+ */
+void VideoDevicePrivate::revalidate()
+{
+   const QString id = m_DeviceId;
+
+   DBus::AsyncQuery::getCapabilities(id, this, [this, id](const MapStringMapStringVectorString& cap, bool ok) {
+      // Keep the cached capabilities, they are better than nothing
+      if (!ok)
+         return;
+
+      setCapabilities(cap);
+      VideoDeviceCache::insert(id, cap);
+   });
+}
+
+/**
+ * Update the channels, keeping those which still exist.
+ *
+ * Only the channels whose capabilities changed are updated, see
+ * Video::Channel::setCapabilities().
+ */
+void VideoDevicePrivate::setCapabilities(const MapStringMapStringVectorString& cap)
+{
+   if (cap == m_Capabilities)
+      return;
+
+   m_Capabilities = cap;
+
+   for (int i = m_lChannels.size() - 1; i >= 0; i--) {
+      Video::Channel* chan = m_lChannels[i];
+
+      if (cap.contains(chan->name()))
+         continue;
+
+      q_ptr->beginRemoveRows(QModelIndex(), i, i);
+      m_lChannels.removeAt(i);
+      q_ptr->endRemoveRows();
+
+      // It is not deleted, a client may still use it or its resolutions
+      if (m_pCurrentChannel == chan)
+         m_pCurrentChannel = nullptr;
+   }
+
+   for (auto i = cap.constBegin(); i != cap.constEnd(); ++i) {
+      Video::Channel* chan = nullptr;
+
+      foreach(Video::Channel* c, m_lChannels) {
+         if (c->name() == i.key()) {
+            chan = c;
+            break;
+         }
+      }
+
+      if (!chan) {
+         q_ptr->beginInsertRows(QModelIndex(), m_lChannels.size(), m_lChannels.size());
+         chan = new Video::Channel(q_ptr, i.key());
+         m_lChannels << chan;
+         q_ptr->endInsertRows();
+      }
+
+      chan->setCapabilities(i.value());
+   }
+}
+
+/*****************************************************************************
+ *                                                                           *
+ *                                  Cache                                    *
+ *                                                                           *
+ ****************************************************************************/
+
+///The cache content, loaded from disk on first use
+QHash<QString, MapStringMapStringVectorString>& VideoDeviceCache::cache()
+{
+   static QHash<QString, MapStringMapStringVectorString> c;
+   static bool loaded = false;
+
+   if (!loaded) {
+      loaded = true;
+
+      QFile file(path());
+
+      if (file.open(QIODevice::ReadOnly)) {
+         QDataStream stream(&file);
+         stream.setVersion(QDataStream::Qt_5_0);
+
+         quint32 magic(0), version(0);
+         stream >> magic >> version;
+
+         // Anything unexpected is discarded, it will be fetched again
+         if (magic == MAGIC && version == VERSION) {
+            stream >> c;
+
+            if (stream.status() != QDataStream::Ok)
+               c.clear();
+         }
+      }
+   }
+
+   return c;
+}
+
+QString VideoDeviceCache::path()
+{
+   return QStandardPaths::writableLocation(QStandardPaths::AppDataLocation) + "/videodevices.cache";
+}
+
+///Get the cached capabilities of a device, if any
+bool VideoDeviceCache::capabilities(const QString& id, MapStringMapStringVectorString& cap)
+{
+   const QHash<QString, MapStringMapStringVectorString>& c = cache();
+
+   auto i = c.constFind(id);
+
+   if (i == c.constEnd())
+      return false;
+
+   cap = i.value();
+   return true;
+}
+
+///Remember the capabilities of a device, the file is only written if they changed
+void VideoDeviceCache::insert(const QString& id, const MapStringMapStringVectorString& cap)
+{
+   QHash<QString, MapStringMapStringVectorString>& c = cache();
+
+   auto i = c.constFind(id);
+
+   if (i != c.constEnd() && i.value() == cap)
+      return;
+
+   c[id] = cap;
+   save();
+}
+
+void VideoDeviceCache::save()
+{
+   const QString p = path();
+   QDir().mkpath(QFileInfo(p).absolutePath());
+
+   QSaveFile file(p);
+
+   if (!file.open(QIODevice::WriteOnly)) {
+      qWarning() << "Cannot save the video device cache" << p;
+      return;
+   }
+
+   QDataStream stream(&file);
+   stream.setVersion(QDataStream::Qt_5_0);
+
+   stream << MAGIC << VERSION << cache();
+
+   file.commit();
+}
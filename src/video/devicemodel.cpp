@@ -166,42 +166,56 @@ void Video::DeviceModel::setActive(const Video::Device* device)
    emit currentIndexChanged(idx);
 }
 
+/**
+ * Synchronize the devices with the daemon.
+ *
+ * Only the devices which were plugged or unplugged are created or removed,
+ * the others (and their channels) are kept as they are.
+ */
 void Video::DeviceModel::reload()
 {
-   QHash<QString,Video::Device*> devicesHash;
    VideoManagerInterface& interface = DBus::VideoManager::instance();
    const QStringList deviceList = interface.getDeviceList();
-   if (deviceList.size() == d_ptr->m_hDevices.size()) {
-      d_ptr->m_lDevices = d_ptr->m_hDevices.values();
+
+   bool changed = false;
+
+   for (int i = d_ptr->m_lDevices.size() - 1; i >= 0; i--) {
+      Video::Device* dev = d_ptr->m_lDevices[i];
+
+      if (deviceList.contains(dev->id()))
+         continue;
+
+      beginRemoveRows(QModelIndex(), i, i);
+      d_ptr->m_lDevices.removeAt(i);
+      d_ptr->m_hDevices.remove(dev->id());
+      endRemoveRows();
+
+      dev->deleteLater();
+      changed = true;
    }
 
    foreach(const QString& deviceName,deviceList) {
-      if (!d_ptr->m_hDevices[deviceName]) {
-         devicesHash[deviceName] = new Video::Device(deviceName);
-      }
-      else {
-         devicesHash[deviceName] = d_ptr->m_hDevices[deviceName];
-      }
-   }
-   foreach(Video::Device* dev, d_ptr->m_hDevices) {
-      if (dev && devicesHash.key(dev).isEmpty()) {
-         dev->deleteLater();
-      }
+      if (d_ptr->m_hDevices.contains(deviceName))
+         continue;
+
+      Video::Device* dev = new Video::Device(deviceName);
+
+      beginInsertRows(QModelIndex(), d_ptr->m_lDevices.size(), d_ptr->m_lDevices.size());
+      d_ptr->m_hDevices[deviceName] = dev;
+      d_ptr->m_lDevices << dev;
+      endInsertRows();
+
+      changed = true;
    }
-   d_ptr->m_pActiveDevice = nullptr;
-   d_ptr->m_hDevices.clear();
-   d_ptr->m_hDevices = devicesHash;
 
-   beginResetModel();
-   d_ptr->m_lDevices = d_ptr->m_hDevices.values();
-   endResetModel();
+   if (!changed)
+      return;
 
-   emit layoutChanged();
-//    channelModel   ()->reload();
+   //The daemon may have picked another default device
+   d_ptr->m_pActiveDevice = nullptr;
 
    //Avoid a possible infinite loop by using a reload event
    QTimer::singleShot(0,d_ptr.data(),SLOT(idleReload()));
-
 }
 
 
@@ -212,7 +226,7 @@ Video::Device* Video::DeviceModel::activeDevice() const
       const QString deId = interface.getDefaultDevice();
       if (!d_ptr->m_lDevices.size())
          const_cast<Video::DeviceModel*>(this)->reload();
-      Video::Device* dev =  d_ptr->m_hDevices[deId];
+      Video::Device* dev =  d_ptr->m_hDevices.value(deId);
 
       //Handling null everywhere is too long, better create a dummy device and
       //log the event
@@ -236,7 +250,7 @@ int Video::DeviceModel::activeIndex() const
 
 Video::Device* Video::DeviceModel::getDevice(const QString& devId) const
 {
-   return d_ptr->m_hDevices[devId];
+   return d_ptr->m_hDevices.value(devId);
 }
 
 QList<Video::Device*> Video::DeviceModel::devices() const
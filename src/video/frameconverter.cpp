@@ -0,0 +1,682 @@
+/****************************************************************************
+ *   Copyright (C) 2015 by Savoir-Faire Linux                               *
+ *   Author : Emmanuel Lepage Vallee <emmanuel.lepage@savoirfairelinux.com> *
+ *                                                                          *
+ *   This library is free software; you can redistribute it and/or          *
+ *   modify it under the terms of the GNU Lesser General Public             *
+ *   License as published by the Free Software Foundation; either           *
+ *   version 2.1 of the License, or (at your option) any later version.     *
+ *                                                                          *
+ *   This library is distributed in the hope that it will be useful,        *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU      *
+ *   Lesser General Public License for more details.                        *
+ *                                                                          *
+ *   You should have received a copy of the GNU General Public License      *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>.  *
+ ***************************************************************************/
+#include "frameconverter.h"
+
+//libstdc++
+#include <cstring>
+#include <vector>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+ #define FRAMECONVERTER_X86
+ #include <immintrin.h>
+#endif
+
+/* Conversion kernels
+ * Implementation note: each kernel convert a single row. The SIMD versions
+ * process as many pixels as their register width allow and let the scalar
+ * version handle the remaining ones, so all backends produce the exact same
+ * output.
+ *
+ * YUV to RGB use BT.601 limited range coefficients with 6 bits of
+ * precision so the intermediate values fit in saturated 16bit lanes.
+ *
+ * Downscaling first halve the frame with a 2x2 box filter as long as
+ * possible, then use a bilinear filter with 7 bits weights for the
+ * remaining non power of two ratio. Upscaling only use the bilinear filter.
+ */
+
+namespace {
+
+typedef unsigned char uchar;
+
+///Convert a row of BGRA to RGBA or the other way around
+typedef void (*SwapRowFunc       )(const uchar* src, uchar* dst, int pixels);
+
+///Premultiply a row of 32bit pixels with their alpha (4th byte)
+typedef void (*PremultiplyRowFunc)(const uchar* src, uchar* dst, int pixels);
+
+///Convert a row of YUV with 2x1 subsampled chroma to RGBA or BGRA
+///@param uvStep 1 for planar chroma, 2 for interleaved chroma
+typedef void (*YuvRowFunc        )(const uchar* y, const uchar* u, const uchar* v,
+                                   int uvStep, uchar* dst, int width, bool bgr);
+
+///Average two rows of 32bit pixels into one row of half the width
+typedef void (*HalveRowFunc      )(const uchar* r0, const uchar* r1, uchar* dst, int dstPixels);
+
+///Interpolate a row of 32bit pixels from two source rows
+///@param x0 the left source pixel for each destination pixel
+///@param wx the weight (0-127) of the right source pixel
+///@param wy the weight (0-127) of r1
+typedef void (*BilinearRowFunc   )(const uchar* r0, const uchar* r1, int wy, const int* x0,
+                                   const int* wx, int srcPixels, uchar* dst, int dstPixels);
+
+struct Kernels {
+   Video::FrameConverter::Backend backend    ;
+   SwapRowFunc                    swap       ;
+   PremultiplyRowFunc             premultiply;
+   YuvRowFunc                     yuv        ;
+   HalveRowFunc                   halve      ;
+   BilinearRowFunc                bilinear   ;
+};
+
+/*****************************************************************************
+ *                                                                           *
+ *                                  Scalar                                   *
+ *                                                                           *
+ ****************************************************************************/
+
+inline uchar clampByte(int v)
+{
+   return v < 0 ? 0 : (v > 255 ? 255 : v);
+}
+
+///Exact rounded division by 255 of a product of two bytes
+inline uchar mulDiv255(int a, int b)
+{
+   const int t = a * b + 128;
+   return (t + (t >> 8)) >> 8;
+}
+
+void swapRowScalar(const uchar* src, uchar* dst, int pixels)
+{
+   for (int i = 0; i < pixels; i++) {
+      const uchar c0 = src[0];
+      dst[0] = src[2];
+      dst[1] = src[1];
+      dst[2] = c0;
+      dst[3] = src[3];
+      src += 4;
+      dst += 4;
+   }
+}
+
+void premultiplyRowScalar(const uchar* src, uchar* dst, int pixels)
+{
+   for (int i = 0; i < pixels; i++) {
+      const int a = src[3];
+      dst[0] = mulDiv255(src[0], a);
+      dst[1] = mulDiv255(src[1], a);
+      dst[2] = mulDiv255(src[2], a);
+      dst[3] = a;
+      src += 4;
+      dst += 4;
+   }
+}
+
+void yuvRowScalar(const uchar* y, const uchar* u, const uchar* v, int uvStep, uchar* dst, int width, bool bgr)
+{
+   const int ri = bgr ? 2 : 0;
+   const int bi = bgr ? 0 : 2;
+
+   for (int x = 0; x < width; x++) {
+      const int c = y[x] - 16;
+      const int d = u[(x >> 1) * uvStep] - 128;
+      const int e = v[(x >> 1) * uvStep] - 128;
+
+      dst[ri] = clampByte((74 * c + 102 * e          + 32) >> 6);
+      dst[1 ] = clampByte((74 * c -  25 * d - 52 * e + 32) >> 6);
+      dst[bi] = clampByte((74 * c + 129 * d          + 32) >> 6);
+      dst[3 ] = 0xFF;
+      dst += 4;
+   }
+}
+
+inline uchar avgByte(int a, int b)
+{
+   return (a + b + 1) >> 1;
+}
+
+void halveRowScalar(const uchar* r0, const uchar* r1, uchar* dst, int dstPixels)
+{
+   for (int i = 0; i < dstPixels; i++) {
+      for (int c = 0; c < 4; c++)
+         dst[c] = avgByte(avgByte(r0[c], r1[c]), avgByte(r0[c+4], r1[c+4]));
+      r0  += 8;
+      r1  += 8;
+      dst += 4;
+   }
+}
+
+inline int lerp7(int a, int b, int w)
+{
+   return a + (((b - a) * w) >> 7);
+}
+
+///Interpolate a single pixel
+inline void bilinearPixelScalar(const uchar* r0, const uchar* r1, int wy, int x0, int x1, int wx, uchar* dst)
+{
+   for (int c = 0; c < 4; c++) {
+      const int v0 = lerp7(r0[x0*4+c], r1[x0*4+c], wy);
+      const int v1 = lerp7(r0[x1*4+c], r1[x1*4+c], wy);
+      dst[c] = lerp7(v0, v1, wx);
+   }
+}
+
+void bilinearRowScalar(const uchar* r0, const uchar* r1, int wy, const int* x0, const int* wx,
+                       int srcPixels, uchar* dst, int dstPixels)
+{
+   for (int i = 0; i < dstPixels; i++) {
+      const int x1 = x0[i] + 1 < srcPixels ? x0[i] + 1 : x0[i];
+      bilinearPixelScalar(r0, r1, wy, x0[i], x1, wx[i], dst + i*4);
+   }
+}
+
+/*****************************************************************************
+ *                                                                           *
+ *                                   SSE2                                    *
+ *                                                                           *
+ ****************************************************************************/
+
+#ifdef FRAMECONVERTER_X86
+
+__attribute__((target("sse2")))
+void swapRowSse2(const uchar* src, uchar* dst, int pixels)
+{
+   const __m128i ga = _mm_set1_epi32(static_cast<int>(0xFF00FF00));
+   const __m128i lo = _mm_set1_epi32(0x000000FF);
+
+   int i = 0;
+   for (; i + 4 <= pixels; i += 4) {
+      const __m128i p = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i*4));
+
+      const __m128i r = _mm_or_si128(
+         _mm_and_si128(p, ga),
+         _mm_or_si128(
+            _mm_and_si128(_mm_srli_epi32(p, 16), lo),
+            _mm_slli_epi32(_mm_and_si128(p, lo), 16)
+         )
+      );
+
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i*4), r);
+   }
+
+   swapRowScalar(src + i*4, dst + i*4, pixels - i);
+}
+
+__attribute__((target("sse2")))
+inline __m128i premultiplySse2(__m128i p, __m128i alphaMask, __m128i alphaOne, __m128i half)
+{
+   // Broadcast the alpha of each pixel, but keep alpha itself unchanged
+   __m128i a = _mm_shufflehi_epi16(_mm_shufflelo_epi16(p, _MM_SHUFFLE(3,3,3,3)), _MM_SHUFFLE(3,3,3,3));
+   a = _mm_or_si128(_mm_andnot_si128(alphaMask, a), alphaOne);
+
+   __m128i t = _mm_add_epi16(_mm_mullo_epi16(p, a), half);
+   return _mm_srli_epi16(_mm_add_epi16(t, _mm_srli_epi16(t, 8)), 8);
+}
+
+__attribute__((target("sse2")))
+void premultiplyRowSse2(const uchar* src, uchar* dst, int pixels)
+{
+   const __m128i zero      = _mm_setzero_si128();
+   const __m128i alphaMask = _mm_set_epi16(-1, 0, 0, 0, -1, 0, 0, 0);
+   const __m128i alphaOne  = _mm_set_epi16(255, 0, 0, 0, 255, 0, 0, 0);
+   const __m128i half      = _mm_set1_epi16(128);
+
+   int i = 0;
+   for (; i + 4 <= pixels; i += 4) {
+      const __m128i p = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i*4));
+
+      const __m128i l = premultiplySse2(_mm_unpacklo_epi8(p, zero), alphaMask, alphaOne, half);
+      const __m128i h = premultiplySse2(_mm_unpackhi_epi8(p, zero), alphaMask, alphaOne, half);
+
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i*4), _mm_packus_epi16(l, h));
+   }
+
+   premultiplyRowScalar(src + i*4, dst + i*4, pixels - i);
+}
+
+///Duplicate the low 16 bits of each 32bit lane into the high 16 bits
+__attribute__((target("sse2")))
+inline __m128i dupChroma(__m128i c32)
+{
+   return _mm_or_si128(c32, _mm_slli_epi32(c32, 16));
+}
+
+__attribute__((target("sse2")))
+void yuvRowSse2(const uchar* y, const uchar* u, const uchar* v, int uvStep, uchar* dst, int width, bool bgr)
+{
+   const __m128i zero   = _mm_setzero_si128();
+   const __m128i low16  = _mm_set1_epi32(0x0000FFFF);
+   const __m128i y16    = _mm_set1_epi16(16 );
+   const __m128i c128   = _mm_set1_epi16(128);
+   const __m128i round  = _mm_set1_epi16(32 );
+   const __m128i kY     = _mm_set1_epi16(74 );
+   const __m128i kRV    = _mm_set1_epi16(102);
+   const __m128i kGU    = _mm_set1_epi16(25 );
+   const __m128i kGV    = _mm_set1_epi16(52 );
+   const __m128i kBU    = _mm_set1_epi16(129);
+   const __m128i alpha  = _mm_set1_epi8(static_cast<char>(0xFF));
+
+   int x = 0;
+   for (; x + 8 <= width; x += 8) {
+      // 8 luma samples to 16bit
+      const __m128i yy = _mm_mullo_epi16(_mm_sub_epi16(
+         _mm_unpacklo_epi8(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(y + x)), zero), y16
+      ), kY);
+
+      // 4 chroma samples each, as 32bit lanes
+      __m128i u32, v32;
+      if (uvStep == 2) {
+         const __m128i uv = _mm_unpacklo_epi8(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(u + x)), zero);
+         u32 = _mm_and_si128(uv, low16);
+         v32 = _mm_srli_epi32(uv, 16);
+      }
+      else {
+         int us, vs;
+         memcpy(&us, u + x/2, 4);
+         memcpy(&vs, v + x/2, 4);
+         u32 = _mm_unpacklo_epi16(_mm_unpacklo_epi8(_mm_cvtsi32_si128(us), zero), zero);
+         v32 = _mm_unpacklo_epi16(_mm_unpacklo_epi8(_mm_cvtsi32_si128(vs), zero), zero);
+      }
+
+      const __m128i d = _mm_sub_epi16(dupChroma(u32), c128);
+      const __m128i e = _mm_sub_epi16(dupChroma(v32), c128);
+
+      const __m128i base = _mm_add_epi16(yy, round);
+
+      const __m128i r = _mm_srai_epi16(_mm_adds_epi16(base, _mm_mullo_epi16(e, kRV)), 6);
+      const __m128i g = _mm_srai_epi16(_mm_subs_epi16(_mm_subs_epi16(base,
+         _mm_mullo_epi16(d, kGU)), _mm_mullo_epi16(e, kGV)), 6);
+      const __m128i b = _mm_srai_epi16(_mm_adds_epi16(base, _mm_mullo_epi16(d, kBU)), 6);
+
+      const __m128i r8 = _mm_packus_epi16(bgr ? b : r, zero);
+      const __m128i g8 = _mm_packus_epi16(g, zero);
+      const __m128i b8 = _mm_packus_epi16(bgr ? r : b, zero);
+
+      const __m128i rg = _mm_unpacklo_epi8(r8, g8   );
+      const __m128i ba = _mm_unpacklo_epi8(b8, alpha);
+
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + x*4     ), _mm_unpacklo_epi16(rg, ba));
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + x*4 + 16), _mm_unpackhi_epi16(rg, ba));
+   }
+
+   yuvRowScalar(y + x, u + (x/2)*uvStep, v + (x/2)*uvStep, uvStep, dst + x*4, width - x, bgr);
+}
+
+__attribute__((target("sse2")))
+void halveRowSse2(const uchar* r0, const uchar* r1, uchar* dst, int dstPixels)
+{
+   int i = 0;
+   for (; i + 4 <= dstPixels; i += 4) {
+      const __m128i v0 = _mm_avg_epu8(
+         _mm_loadu_si128(reinterpret_cast<const __m128i*>(r0 + i*8     )),
+         _mm_loadu_si128(reinterpret_cast<const __m128i*>(r1 + i*8     ))
+      );
+      const __m128i v1 = _mm_avg_epu8(
+         _mm_loadu_si128(reinterpret_cast<const __m128i*>(r0 + i*8 + 16)),
+         _mm_loadu_si128(reinterpret_cast<const __m128i*>(r1 + i*8 + 16))
+      );
+
+      // Separate the even and odd pixels, then average them
+      const __m128 f0 = _mm_castsi128_ps(v0);
+      const __m128 f1 = _mm_castsi128_ps(v1);
+
+      const __m128i even = _mm_castps_si128(_mm_shuffle_ps(f0, f1, _MM_SHUFFLE(2,0,2,0)));
+      const __m128i odd  = _mm_castps_si128(_mm_shuffle_ps(f0, f1, _MM_SHUFFLE(3,1,3,1)));
+
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i*4), _mm_avg_epu8(even, odd));
+   }
+
+   halveRowScalar(r0 + i*8, r1 + i*8, dst + i*4, dstPixels - i);
+}
+
+__attribute__((target("sse2")))
+void bilinearRowSse2(const uchar* r0, const uchar* r1, int wy, const int* x0, const int* wx,
+                     int srcPixels, uchar* dst, int dstPixels)
+{
+   const __m128i zero = _mm_setzero_si128();
+   const __m128i vwy  = _mm_set1_epi16(static_cast<short>(wy));
+
+   for (int i = 0; i < dstPixels; i++) {
+      // The last column has no right neighbour
+      if (x0[i] + 1 >= srcPixels) {
+         bilinearPixelScalar(r0, r1, wy, x0[i], x0[i], wx[i], dst + i*4);
+         continue;
+      }
+
+      // Both neighbours of each row as 16bit lanes
+      const __m128i a = _mm_unpacklo_epi8(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(r0 + x0[i]*4)), zero);
+      const __m128i b = _mm_unpacklo_epi8(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(r1 + x0[i]*4)), zero);
+
+      const __m128i v  = _mm_add_epi16(a, _mm_srai_epi16(_mm_mullo_epi16(_mm_sub_epi16(b, a), vwy), 7));
+      const __m128i vr = _mm_srli_si128(v, 8);
+
+      const __m128i h  = _mm_add_epi16(v, _mm_srai_epi16(_mm_mullo_epi16(_mm_sub_epi16(vr, v),
+         _mm_set1_epi16(static_cast<short>(wx[i]))), 7));
+
+      const int px = _mm_cvtsi128_si32(_mm_packus_epi16(h, zero));
+      memcpy(dst + i*4, &px, 4);
+   }
+}
+
+/*****************************************************************************
+ *                                                                           *
+ *                                   AVX2                                    *
+ *                                                                           *
+ ****************************************************************************/
+
+__attribute__((target("avx2")))
+void swapRowAvx2(const uchar* src, uchar* dst, int pixels)
+{
+   const __m256i mask = _mm256_setr_epi8(
+      2,1,0,3, 6,5,4,7, 10,9,8,11, 14,13,12,15,
+      2,1,0,3, 6,5,4,7, 10,9,8,11, 14,13,12,15
+   );
+
+   int i = 0;
+   for (; i + 8 <= pixels; i += 8) {
+      const __m256i p = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i*4));
+      _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i*4), _mm256_shuffle_epi8(p, mask));
+   }
+
+   swapRowSse2(src + i*4, dst + i*4, pixels - i);
+}
+
+__attribute__((target("avx2")))
+void premultiplyRowAvx2(const uchar* src, uchar* dst, int pixels)
+{
+   const __m256i zero      = _mm256_setzero_si256();
+   const __m256i alphaMask = _mm256_set_epi16(-1,0,0,0,-1,0,0,0,-1,0,0,0,-1,0,0,0);
+   const __m256i alphaOne  = _mm256_set_epi16(255,0,0,0,255,0,0,0,255,0,0,0,255,0,0,0);
+   const __m256i half      = _mm256_set1_epi16(128);
+
+   int i = 0;
+   for (; i + 8 <= pixels; i += 8) {
+      const __m256i p = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i*4));
+
+      // unpack/pack work per 128bit lane, so the pixel order is preserved
+      __m256i l = _mm256_unpacklo_epi8(p, zero);
+      __m256i h = _mm256_unpackhi_epi8(p, zero);
+
+      __m256i al = _mm256_shufflehi_epi16(_mm256_shufflelo_epi16(l, _MM_SHUFFLE(3,3,3,3)), _MM_SHUFFLE(3,3,3,3));
+      __m256i ah = _mm256_shufflehi_epi16(_mm256_shufflelo_epi16(h, _MM_SHUFFLE(3,3,3,3)), _MM_SHUFFLE(3,3,3,3));
+      al = _mm256_or_si256(_mm256_andnot_si256(alphaMask, al), alphaOne);
+      ah = _mm256_or_si256(_mm256_andnot_si256(alphaMask, ah), alphaOne);
+
+      l = _mm256_add_epi16(_mm256_mullo_epi16(l, al), half);
+      h = _mm256_add_epi16(_mm256_mullo_epi16(h, ah), half);
+      l = _mm256_srli_epi16(_mm256_add_epi16(l, _mm256_srli_epi16(l, 8)), 8);
+      h = _mm256_srli_epi16(_mm256_add_epi16(h, _mm256_srli_epi16(h, 8)), 8);
+
+      _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i*4), _mm256_packus_epi16(l, h));
+   }
+
+   premultiplyRowSse2(src + i*4, dst + i*4, pixels - i);
+}
+
+#endif //FRAMECONVERTER_X86
+
+///Select the best kernels for this CPU
+Kernels selectKernels()
+{
+#ifdef FRAMECONVERTER_X86
+   __builtin_cpu_init();
+
+   if (__builtin_cpu_supports("avx2"))
+      return { Video::FrameConverter::Backend::AVX2, swapRowAvx2, premultiplyRowAvx2, yuvRowSse2,
+         halveRowSse2, bilinearRowSse2 };
+
+   if (__builtin_cpu_supports("sse2"))
+      return { Video::FrameConverter::Backend::SSE2, swapRowSse2, premultiplyRowSse2, yuvRowSse2,
+         halveRowSse2, bilinearRowSse2 };
+#endif
+
+   return { Video::FrameConverter::Backend::SCALAR, swapRowScalar, premultiplyRowScalar, yuvRowScalar,
+      halveRowScalar, bilinearRowScalar };
+}
+
+const Kernels& kernels()
+{
+   static const Kernels k = selectKernels();
+   return k;
+}
+
+inline bool isPacked(Video::FrameConverter::Format f)
+{
+   return f == Video::FrameConverter::Format::BGRA || f == Video::FrameConverter::Format::RGBA;
+}
+
+void halve(const Kernels& k, const uchar* src, int srcStride, const QSize& srcSize, uchar* dst, int dstStride)
+{
+   const int w = srcSize.width () / 2;
+   const int h = srcSize.height() / 2;
+
+   for (int row = 0; row < h; row++)
+      k.halve(src + 2*row*srcStride, src + (2*row+1)*srcStride, dst + row*dstStride, w);
+}
+
+///Source position, in 1/128 pixel, of each destination pixel center
+void bilinearMap(int srcLen, int dstLen, int* pos0, int* weight)
+{
+   for (int i = 0; i < dstLen; i++) {
+      int p = static_cast<int>(((2ll*i + 1) * srcLen * 128) / (2ll * dstLen)) - 64;
+
+      if (p < 0)
+         p = 0;
+
+      pos0  [i] = p >> 7;
+      weight[i] = p & 127;
+
+      if (pos0[i] >= srcLen - 1) {
+         pos0  [i] = srcLen - 1;
+         weight[i] = 0;
+      }
+   }
+}
+
+void bilinear(const Kernels& k, const uchar* src, int srcStride, const QSize& srcSize,
+              uchar* dst, int dstStride, const QSize& dstSize)
+{
+   std::vector<int> x0(dstSize.width ()), wx(dstSize.width ());
+   std::vector<int> y0(dstSize.height()), wy(dstSize.height());
+
+   bilinearMap(srcSize.width (), dstSize.width (), x0.data(), wx.data());
+   bilinearMap(srcSize.height(), dstSize.height(), y0.data(), wy.data());
+
+   for (int row = 0; row < dstSize.height(); row++) {
+      const int y1 = y0[row] + 1 < srcSize.height() ? y0[row] + 1 : y0[row];
+
+      k.bilinear(src + y0[row]*srcStride, src + y1*srcStride, wy[row], x0.data(), wx.data(),
+         srcSize.width(), dst + row*dstStride, dstSize.width());
+   }
+}
+
+} //anonymous namespace
+
+///Return the instruction set used by the conversions
+Video::FrameConverter::Backend Video::FrameConverter::backend()
+{
+   return kernels().backend;
+}
+
+///The minimal stride (in bytes) of the first plane for a given format
+uint Video::FrameConverter::stride(Format format, int width)
+{
+   return isPacked(format) ? width * 4 : width;
+}
+
+///The size of a frame, including all planes
+uint Video::FrameConverter::frameSize(Format format, const QSize& size, uint stride)
+{
+   if (!stride)
+      stride = FrameConverter::stride(format, size.width());
+
+   const uint h = size.height();
+
+   switch(format) {
+      case Format::BGRA:
+      case Format::RGBA:
+         return stride * h;
+      case Format::I420:
+         return stride * h + 2 * ((stride + 1) / 2) * ((h + 1) / 2);
+      case Format::NV12:
+         return stride * h + stride * ((h + 1) / 2);
+      case Format::COUNT__:
+         break;
+   }
+
+   return 0;
+}
+
+/**
+ * Convert a frame
+ *
+ * @param premultiply multiply the color channels by the alpha channel
+ * @return false if the conversion is not supported
+ * @note Converting from the planar formats is supported, converting to them
+ *       is not
+ * @note src and dst may be the same buffer if both formats are packed and
+ *       share the same stride
+ */
+bool Video::FrameConverter::convert(const char* src, Format from, uint srcStride,
+                                          char* dst, Format to  , uint dstStride,
+                                    const QSize& size, bool premultiply)
+{
+   if ((!src) || (!dst) || (!isPacked(to)) || size.isEmpty())
+      return false;
+
+   if (!srcStride)
+      srcStride = stride(from, size.width());
+
+   if (!dstStride)
+      dstStride = stride(to, size.width());
+
+   const Kernels& k = kernels();
+   const int      w = size.width ();
+   const int      h = size.height();
+
+   const uchar* s = reinterpret_cast<const uchar*>(src);
+   uchar*       d = reinterpret_cast<uchar*      >(dst);
+
+   switch(from) {
+      case Format::BGRA:
+      case Format::RGBA:
+         for (int row = 0; row < h; row++) {
+            const uchar* srcRow = s + row * srcStride;
+            uchar*       dstRow = d + row * dstStride;
+
+            if (from != to)
+               k.swap(srcRow, dstRow, w);
+            else if (srcRow != dstRow && !premultiply)
+               memcpy(dstRow, srcRow, w * 4);
+
+            if (premultiply)
+               k.premultiply(from != to ? dstRow : srcRow, dstRow, w);
+         }
+         return true;
+      case Format::I420: {
+         const uint   uvStride = (srcStride + 1) / 2;
+         const uchar* uPlane   = s + srcStride * h;
+         const uchar* vPlane   = uPlane + uvStride * ((h + 1) / 2);
+
+         // The alpha is always opaque, premultiplying is a no-op
+         for (int row = 0; row < h; row++)
+            k.yuv(s + row * srcStride, uPlane + (row / 2) * uvStride, vPlane + (row / 2) * uvStride,
+               1, d + row * dstStride, w, to == Format::BGRA);
+
+         return true;
+      }
+      case Format::NV12: {
+         const uchar* uvPlane = s + srcStride * h;
+
+         for (int row = 0; row < h; row++) {
+            const uchar* uv = uvPlane + (row / 2) * srcStride;
+            k.yuv(s + row * srcStride, uv, uv + 1, 2, d + row * dstStride, w, to == Format::BGRA);
+         }
+
+         return true;
+      }
+      case Format::COUNT__:
+         break;
+   }
+
+   return false;
+}
+
+/**
+ * Resize a frame of 32bit pixels, the channel order does not matter.
+ *
+ * Upscaling only use the bilinear filter. The strides allow to scale into
+ * a region of a larger frame.
+ *
+ * @note src and dst must not overlap
+ * @return false if a size is empty
+ */
+bool Video::FrameConverter::scale(const char* src, uint srcStride, const QSize& srcSize,
+                                        char* dst, uint dstStride, const QSize& dstSize)
+{
+   if ((!src) || (!dst) || srcSize.isEmpty() || dstSize.isEmpty())
+      return false;
+
+   if (!srcStride)
+      srcStride = srcSize.width() * 4;
+
+   if (!dstStride)
+      dstStride = dstSize.width() * 4;
+
+   const Kernels& k = kernels();
+
+   const uchar* s = reinterpret_cast<const uchar*>(src);
+   uchar*       d = reinterpret_cast<uchar*      >(dst);
+
+   if (srcSize == dstSize) {
+      for (int row = 0; row < dstSize.height(); row++)
+         memcpy(d + row*dstStride, s + row*srcStride, dstSize.width() * 4);
+      return true;
+   }
+
+   // Box filter passes, the last one write directly into dst
+   std::vector<uchar> buffers[2];
+   QSize cur       = srcSize;
+   int   curStride = srcStride;
+   int   pass      = 0;
+
+   while (cur.width() / 2 >= dstSize.width() && cur.height() / 2 >= dstSize.height()) {
+      const QSize next(cur.width() / 2, cur.height() / 2);
+
+      if (next == dstSize) {
+         halve(k, s, curStride, cur, d, dstStride);
+         return true;
+      }
+
+      std::vector<uchar>& buf = buffers[pass++ % 2];
+      buf.resize(next.width() * next.height() * 4);
+
+      halve(k, s, curStride, cur, buf.data(), next.width() * 4);
+
+      s         = buf.data();
+      cur       = next;
+      curStride = next.width() * 4;
+   }
+
+   bilinear(k, s, curStride, cur, d, dstStride, dstSize);
+
+   return true;
+}
+
+///Convenience overload resizing dst as needed, tightly packed frames only
+bool Video::FrameConverter::convert(const QByteArray& src, Format from, QByteArray& dst,
+                                    Format to, const QSize& size, bool premultiply)
+{
+   if (static_cast<uint>(src.size()) < frameSize(from, size))
+      return false;
+
+   dst.resize(frameSize(to, size));
+
+   return convert(src.constData(), from, 0, dst.data(), to, 0, size, premultiply);
+}
@@ -0,0 +1,83 @@
+/****************************************************************************
+ *   Copyright (C) 2015 by Savoir-Faire Linux                               *
+ *   Author : Emmanuel Lepage Vallee <emmanuel.lepage@savoirfairelinux.com> *
+ *                                                                          *
+ *   This library is free software; you can redistribute it and/or          *
+ *   modify it under the terms of the GNU Lesser General Public             *
+ *   License as published by the Free Software Foundation; either           *
+ *   version 2.1 of the License, or (at your option) any later version.     *
+ *                                                                          *
+ *   This library is distributed in the hope that it will be useful,        *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU      *
+ *   Lesser General Public License for more details.                        *
+ *                                                                          *
+ *   You should have received a copy of the GNU General Public License      *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>.  *
+ ***************************************************************************/
+#ifndef VIDEO_FRAME_CONVERTER_H
+#define VIDEO_FRAME_CONVERTER_H
+
+#include <typedefs.h>
+
+//Qt
+#include <QtCore/QSize>
+#include <QtCore/QByteArray>
+
+namespace Video {
+
+/**
+ * Convert frames between the pixel formats used by the daemon and the
+ * clients.
+ *
+ * The best implementation available on the CPU (AVX2, SSE2 or plain C++)
+ * is selected the first time a conversion is requested.
+ *
+ * The planar formats are expected to be contiguous in memory: for I420, the
+ * U and V planes (with a stride of (stride+1)/2) follow the Y plane. For
+ * NV12, the interleaved UV plane (with the same stride as Y) follow the Y
+ * plane.
+ */
+class LIB_EXPORT FrameConverter
+{
+public:
+   ///Pixel formats
+   enum class Format {
+      BGRA , /*!< 32bit packed, BLUE GREEN RED ALPHA byte order  */
+      RGBA , /*!< 32bit packed, RED GREEN BLUE ALPHA byte order  */
+      I420 , /*!< 8bit planar Y, U and V, 2x2 chroma subsampling */
+      NV12 , /*!< 8bit planar Y, interleaved UV, 2x2 subsampling */
+      COUNT__
+   };
+
+   ///Instruction set used by the conversion kernels
+   enum class Backend {
+      SCALAR,
+      SSE2  ,
+      AVX2  ,
+      COUNT__
+   };
+
+   //Getters
+   static Backend backend   (                                          );
+   static uint    stride    ( Format format, int width                  );
+   static uint    frameSize ( Format format, const QSize& size, uint stride = 0 );
+
+   //Mutators
+   static bool convert(const char* src, Format from, uint srcStride,
+                             char* dst, Format to  , uint dstStride,
+                       const QSize& size, bool premultiply = false);
+
+   static bool convert(const QByteArray& src, Format from, QByteArray& dst,
+                       Format to, const QSize& size, bool premultiply = false);
+
+   static bool scale(const char* src, uint srcStride, const QSize& srcSize,
+                           char* dst, uint dstStride, const QSize& dstSize);
+
+private:
+   FrameConverter() = delete;
+};
+
+}
+
+#endif
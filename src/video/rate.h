@@ -23,6 +23,7 @@
 //Ring
 namespace Video {
    class Resolution;
+   class Channel;
    class Device;
 }
 
@@ -33,8 +34,9 @@ namespace Video {
 ///@typedef Rate The rate for a device
 class LIB_EXPORT Rate
 {
-   //Can only be created by Video::Device
+   //Can only be created by Video::Device and Video::Channel
    friend class Video::Device;
+   friend class Video::Channel;
 
 public:
    QString name() const;
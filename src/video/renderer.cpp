@@ -19,16 +19,37 @@
 
 //Ring
 #include "private/videorenderer_p.h"
+#include "video/compositor.h"
+#include "video/frameconverter.h"
 
 //Qt
+#include <QtCore/QDebug>
 #include <QtCore/QMutex>
+#include <QtCore/QTimer>
+
+//libstdc++
+#include <chrono>
+#include <cstring>
 
 Video::RendererPrivate::RendererPrivate(Video::Renderer* parent)
    : QObject(parent), q_ptr(parent)
-   , m_pMutex(new QMutex()),m_pFrame(nullptr),m_FrameSize(0),m_isRendering(false)
+   , m_pMutex(new QMutex()),m_pFrame(nullptr),m_FrameSize(0),m_FrameGen(0),m_Timestamp(0)
+   , m_isRendering(false),m_HasPreferredColorSpace(false),m_PreferredColorSpace(Video::Renderer::ColorSpace::BGRA)
+   , m_MaxFrameRate(0),m_StaleDeadline(0),m_LastEmit(0),m_HasPendingFrame(false),m_pPacingTimer(new QTimer(this))
+   , m_CoalescedFrames(0),m_StaleFrames(0),m_DeliveredFrames(0),m_DroppedFrames(0),m_Jitter(0)
+   , m_LockWaitTime(0),m_RemapCount(0),m_RemapTime(0),m_LastArrival(0),m_LastInterval(0)
+   , m_DispatchMutex(QMutex::Recursive)
+   , m_SharedFrame{QByteArray(),QSize(),Video::Renderer::ColorSpace::BGRA,0,0}
 {
+   for (std::atomic_uint& bucket : m_lFrameAge)
+      bucket = 0;
+
+   m_pPacingTimer->setSingleShot(true);
+   connect(m_pPacingTimer, &QTimer::timeout, this, &RendererPrivate::slotPacingTimeout);
 }
 
+constexpr const int Video::Renderer::FRAME_AGE_BUCKETS[];
+
 Video::Renderer::Renderer(const QByteArray& id, const QSize& res) : d_ptr(new RendererPrivate(this))
 {
    setObjectName("Renderer:"+id);
@@ -39,9 +60,284 @@ Video::Renderer::Renderer(const QByteArray& id, const QSize& res) : d_ptr(new Re
 
 Video::Renderer::~Renderer()
 {
+   d_ptr->detachCompositors();
    delete d_ptr;
 }
 
+///Monotonic time used to timestamp the frames, in milliseconds
+qint64 Video::RendererPrivate::now()
+{
+   return std::chrono::duration_cast<std::chrono::milliseconds>(
+      std::chrono::steady_clock::now().time_since_epoch()
+   ).count();
+}
+
+/**
+ * Emit frameUpdated() for a new frame, according to the pacing policy.
+ *
+ * This is called by the implementations from the renderer thread, without
+ * the mutex. Frames older than the stale deadline are skipped. When the
+ * maximum frame rate is reached, the notification is deferred and only the
+ * latest frame is emitted once the interval elapsed.
+ */
+void Video::RendererPrivate::notifyFrame()
+{
+   const qint64 current = now();
+
+   // Interarrival jitter, as defined by RFC 3550
+   if (m_LastArrival) {
+      const qint64 interval = m_Timestamp - m_LastArrival;
+
+      if (m_LastInterval) {
+         const qint64 d = interval > m_LastInterval ? interval - m_LastInterval : m_LastInterval - interval;
+         m_Jitter = m_Jitter + (d - m_Jitter) / 16.0;
+      }
+
+      m_LastInterval = interval;
+   }
+
+   m_LastArrival = m_Timestamp;
+
+   if (m_StaleDeadline && current - m_Timestamp > m_StaleDeadline) {
+      ++m_StaleFrames;
+      return;
+   }
+
+   const int maxRate = m_MaxFrameRate;
+
+   if (maxRate) {
+      const qint64 remaining = m_LastEmit + 1000 / maxRate - current;
+
+      if (remaining > 0) {
+         if (m_HasPendingFrame)
+            ++m_CoalescedFrames;
+
+         m_HasPendingFrame = true;
+
+         if (!m_pPacingTimer->isActive())
+            m_pPacingTimer->start(remaining);
+
+         return;
+      }
+   }
+
+   m_HasPendingFrame = false;
+   m_LastEmit        = current;
+
+   emitFrame();
+}
+
+/**
+ * Notify the views and hand the frame to the sinks.
+ *
+ * The sinks are called with m_DispatchMutex held, so removeSink() can wait
+ * for the delivery in progress. A sink removed during the delivery, from
+ * one of the sinks, is skipped.
+ */
+void Video::RendererPrivate::emitFrame()
+{
+   ++m_DeliveredFrames;
+   emit q_ptr->frameUpdated();
+
+   QMutexLocker dispatchLk {&m_DispatchMutex};
+
+   QList<Video::Renderer::Sink*> sinks;
+   Video::Renderer::SharedFrame  frame;
+
+   {
+      QMutexLocker lk {m_pMutex};
+
+      if (m_lSinks.isEmpty() || m_SharedFrame.data.isEmpty())
+         return;
+
+      sinks = m_lSinks     ;
+      frame = m_SharedFrame;
+   }
+
+   for (Video::Renderer::Sink* sink : sinks) {
+      {
+         QMutexLocker lk {m_pMutex};
+
+         if (!m_lSinks.contains(sink))
+            continue;
+      }
+
+      sink->frameReady(frame);
+   }
+}
+
+///Record the age of the frame being read by a client
+void Video::RendererPrivate::recordFrameAge()
+{
+   if (!m_Timestamp)
+      return;
+
+   const qint64 age = now() - m_Timestamp;
+
+   int bucket = 0;
+
+   while (bucket < Video::Renderer::FRAME_AGE_BUCKET_COUNT - 1 && age >= Video::Renderer::FRAME_AGE_BUCKETS[bucket])
+      bucket++;
+
+   ++m_lFrameAge[bucket];
+}
+
+///Emit the latest frame deferred by the pacing
+void Video::RendererPrivate::slotPacingTimeout()
+{
+   if (!m_HasPendingFrame)
+      return;
+
+   m_HasPendingFrame = false;
+
+   if (m_StaleDeadline && now() - m_Timestamp > m_StaleDeadline) {
+      ++m_StaleFrames;
+      return;
+   }
+
+   m_LastEmit = now();
+
+   emitFrame();
+}
+
+///The colorspace presented to the clients, given the one of the producer
+Video::Renderer::ColorSpace Video::RendererPrivate::colorSpace(Video::Renderer::ColorSpace native) const
+{
+   return m_HasPreferredColorSpace ? m_PreferredColorSpace : native;
+}
+
+/**
+ * Convert a new frame to the preferred colorspace, if any.
+ *
+ * This is called by the implementations from the thread receiving the
+ * frame, with the mutex locked.
+ *
+ * @return the frame to expose to the clients
+ */
+char* Video::RendererPrivate::convertFrame(char* frame, Video::Renderer::ColorSpace native)
+{
+   if ((!frame) || colorSpace(native) == native)
+      return frame;
+
+   const uint size = m_pSize.width() * m_pSize.height() * 4;
+
+   if ((!size) || m_FrameSize < size)
+      return frame;
+
+   // The previous frame may still be shared with the sinks
+   if (m_ConvertedFrame.isDetached())
+      m_ConvertedFrame.resize(size);
+   else
+      m_ConvertedFrame = QByteArray(size, Qt::Uninitialized);
+
+   Video::FrameConverter::convert(
+      frame                  , native == Video::Renderer::ColorSpace::BGRA ?
+         Video::FrameConverter::Format::BGRA : Video::FrameConverter::Format::RGBA, 0,
+      m_ConvertedFrame.data(), m_PreferredColorSpace == Video::Renderer::ColorSpace::BGRA ?
+         Video::FrameConverter::Format::BGRA : Video::FrameConverter::Format::RGBA, 0,
+      m_pSize
+   );
+
+   return m_ConvertedFrame.data();
+}
+
+/**
+ * The memory kept alive by a lease of the current frame.
+ *
+ * This is called with the mutex locked. The buffers owned by the renderer
+ * are implicitly shared, they are never written again while a lease hold a
+ * reference to them. A frame still in the producer memory, which the
+ * producer may overwrite at any time, is copied.
+ */
+QByteArray Video::RendererPrivate::leaseBuffer() const
+{
+   if (m_pFrame == m_FrameBuffer.constData())
+      return m_FrameBuffer;
+
+   if (m_pFrame == m_ConvertedFrame.constData())
+      return m_ConvertedFrame;
+
+   if (m_SharedFrame.frameGen == m_FrameGen && m_SharedFrame.data.size() == static_cast<int>(m_FrameSize))
+      return m_SharedFrame.data;
+
+   return QByteArray(m_pFrame, m_FrameSize);
+}
+
+/**
+ * Stop being composited before the renderer is torn down.
+ *
+ * The implementations call this first in their destructor, as a composition
+ * pass still use the virtual methods. ~Renderer() call it again for the
+ * others, it does nothing once detached.
+ */
+void Video::RendererPrivate::detachCompositors()
+{
+   Video::Compositor::detachRenderer(q_ptr);
+}
+
+/**
+ * Downscale the current frame for each registered output.
+ *
+ * This is called by the implementations from the thread receiving the
+ * frame, with the mutex locked. Buffers still used by a view are left
+ * untouched, a new one is allocated instead.
+ */
+void Video::RendererPrivate::updateScaledOutputs()
+{
+   const uint size = m_pSize.width() * m_pSize.height() * 4;
+
+   if ((!m_pFrame) || (!size) || m_FrameSize < size)
+      return;
+
+   for (ScaledOutput& output : m_lScaledOutputs) {
+      if (output.frameGen == m_FrameGen && !output.frame.isEmpty())
+         continue;
+
+      const int outputSize = output.size.width() * output.size.height() * 4;
+
+      if (output.frame.isDetached())
+         output.frame.resize(outputSize);
+      else
+         output.frame = QByteArray(outputSize, Qt::Uninitialized);
+
+      if (!Video::FrameConverter::scale(m_pFrame, 0, m_pSize, output.frame.data(), 0, output.size))
+         output.frame.clear();
+
+      output.frameGen = m_FrameGen;
+   }
+}
+
+/**
+ * Prepare the frame handed to the sinks.
+ *
+ * This is called by the implementations from the thread receiving the
+ * frame, with the mutex locked, after convertFrame(). A converted frame is
+ * shared as is, a frame still in the producer memory is copied once for
+ * all the sinks. Nothing is done when there is no sink.
+ */
+void Video::RendererPrivate::updateSharedFrame()
+{
+   if (m_lSinks.isEmpty() || (!m_pFrame) || !m_FrameSize)
+      return;
+
+   if (m_pFrame == m_ConvertedFrame.constData())
+      m_SharedFrame.data = m_ConvertedFrame;
+   else {
+      // Recycle the buffer if all the sinks are done with it
+      if (m_SharedFrame.data.isDetached())
+         m_SharedFrame.data.resize(m_FrameSize);
+      else
+         m_SharedFrame.data = QByteArray(m_FrameSize, Qt::Uninitialized);
+
+      ::memcpy(m_SharedFrame.data.data(), m_pFrame, m_FrameSize);
+   }
+
+   m_SharedFrame.resolution = m_pSize;
+   m_SharedFrame.colorSpace = q_ptr->colorSpace();
+   m_SharedFrame.frameGen   = m_FrameGen;
+   m_SharedFrame.timestamp  = m_Timestamp;
+}
+
 /*****************************************************************************
 *                                                                           *
 *                                 Getters                                   *
@@ -68,11 +364,216 @@ QSize Video::Renderer::size() const
 
 const QByteArray& Video::Renderer::currentFrame() const
 {
-   if (d_ptr->m_pFrame && d_ptr->m_FrameSize)
+   if (d_ptr->m_pFrame && d_ptr->m_FrameSize) {
       d_ptr->m_Content.setRawData(d_ptr->m_pFrame,d_ptr->m_FrameSize);
+      d_ptr->recordFrameAge();
+   }
    return d_ptr->m_Content;
 }
 
+/**
+ * Lease the current frame.
+ *
+ * The frame memory is guaranteed to stay valid and unchanged until
+ * releaseFrame() is called. Each successful call has to be matched by a
+ * releaseFrame(). The renderer keep receiving frames in the meantime: the
+ * lease hold a reference to the buffer of the frame, or a copy of it when
+ * the frame is still in the producer memory.
+ */
+Video::Renderer::Frame Video::Renderer::acquireFrame() const
+{
+   QMutexLocker lk {d_ptr->m_pMutex};
+
+   if ((!d_ptr->m_pFrame) || !d_ptr->m_FrameSize)
+      return Frame { nullptr, 0, 0, d_ptr->m_pSize, colorSpace(), d_ptr->m_FrameGen, d_ptr->m_Timestamp };
+
+   const char* data = nullptr;
+
+   // The same frame leased many times share the same buffer
+   for (auto i = d_ptr->m_hLeases.begin(); i != d_ptr->m_hLeases.end(); ++i) {
+      if (i.value().frameGen == d_ptr->m_FrameGen && i.value().timestamp == d_ptr->m_Timestamp) {
+         i.value().count++;
+         data = i.key();
+         break;
+      }
+   }
+
+   if (!data) {
+      const QByteArray buffer = d_ptr->leaseBuffer();
+      data = buffer.constData();
+      d_ptr->m_hLeases[data] = RendererPrivate::Lease { buffer, d_ptr->m_FrameGen, d_ptr->m_Timestamp, 1 };
+   }
+
+   d_ptr->recordFrameAge();
+
+   return Frame {
+      data                                           ,
+      d_ptr->m_FrameSize                             ,
+      static_cast<uint>(d_ptr->m_pSize.width()) * 4  ,
+      d_ptr->m_pSize                                 ,
+      colorSpace()                                   ,
+      d_ptr->m_FrameGen                              ,
+      d_ptr->m_Timestamp                             ,
+   };
+}
+
+///The maximum number of frameUpdated() per second, 0 if unlimited
+int Video::Renderer::maximumFrameRate() const
+{
+   return d_ptr->m_MaxFrameRate;
+}
+
+///The age (in ms) after which a frame is skipped instead of emitted, 0 if never
+int Video::Renderer::staleFrameDeadline() const
+{
+   return d_ptr->m_StaleDeadline;
+}
+
+///Get a snapshot of the frame pipeline counters
+Video::Renderer::Statistics Video::Renderer::statistics() const
+{
+   Statistics s;
+
+   s.deliveredFrames = d_ptr->m_DeliveredFrames;
+   s.coalescedFrames = d_ptr->m_CoalescedFrames;
+   s.staleFrames     = d_ptr->m_StaleFrames    ;
+   s.droppedFrames   = d_ptr->m_DroppedFrames + s.coalescedFrames + s.staleFrames;
+   s.jitter          = d_ptr->m_Jitter         ;
+   s.lockWaitTime    = d_ptr->m_LockWaitTime   ;
+   s.remapCount      = d_ptr->m_RemapCount     ;
+   s.remapTime       = d_ptr->m_RemapTime      ;
+
+   for (int i = 0; i < FRAME_AGE_BUCKET_COUNT; i++)
+      s.frameAge[i] = d_ptr->m_lFrameAge[i];
+
+   return s;
+}
+
+/**
+ * Request a downscaled copy of each frame.
+ *
+ * The scaling is done once per frame in the renderer thread and the result
+ * is shared by all the views using the same size. Each call has to be
+ * matched by a removeScaledOutput().
+ *
+ * A new output is only filled by the next frame, scaledFrame() return an
+ * empty array until then. The caller thread never does the scaling.
+ *
+ * @param size The output size, for example size()/2 or size()/4
+ */
+void Video::Renderer::addScaledOutput(const QSize& size)
+{
+   if (size.isEmpty())
+      return;
+
+   QMutexLocker lk {d_ptr->m_pMutex};
+
+   for (RendererPrivate::ScaledOutput& output : d_ptr->m_lScaledOutputs) {
+      if (output.size == size) {
+         output.refCount++;
+         return;
+      }
+   }
+
+   d_ptr->m_lScaledOutputs << RendererPrivate::ScaledOutput { size, 1, 0, QByteArray() };
+}
+
+///Stop producing a downscaled output once no views use it
+void Video::Renderer::removeScaledOutput(const QSize& size)
+{
+   QMutexLocker lk {d_ptr->m_pMutex};
+
+   for (int i = 0; i < d_ptr->m_lScaledOutputs.size(); i++) {
+      if (d_ptr->m_lScaledOutputs[i].size == size) {
+         if (!--d_ptr->m_lScaledOutputs[i].refCount)
+            d_ptr->m_lScaledOutputs.remove(i);
+         return;
+      }
+   }
+}
+
+/**
+ * Get the latest downscaled frame for a size registered with
+ * addScaledOutput().
+ *
+ * The returned array is implicitly shared with the renderer and the other
+ * views, it is never modified once returned.
+ */
+QByteArray Video::Renderer::scaledFrame(const QSize& size) const
+{
+   QMutexLocker lk {d_ptr->m_pMutex};
+
+   for (const RendererPrivate::ScaledOutput& output : d_ptr->m_lScaledOutputs) {
+      if (output.size == size)
+         return output.frame;
+   }
+
+   return QByteArray();
+}
+
+/**
+ * Get the last frame handed to the sinks.
+ *
+ * This is only kept up to date while at least one sink is registered.
+ */
+Video::Renderer::SharedFrame Video::Renderer::sharedFrame() const
+{
+   QMutexLocker lk {d_ptr->m_pMutex};
+
+   return d_ptr->m_SharedFrame;
+}
+
+/**
+ * Hand every new frame to a sink.
+ *
+ * A stream shown in many places is then fetched and converted only once.
+ * The sink must stay valid until removeSink() returned.
+ */
+void Video::Renderer::addSink(Sink* sink)
+{
+   QMutexLocker lk {d_ptr->m_pMutex};
+
+   if (sink && !d_ptr->m_lSinks.contains(sink))
+      d_ptr->m_lSinks << sink;
+}
+
+/**
+ * Stop handing frames to a sink.
+ *
+ * If the sink is being called from the renderer thread, this wait for it
+ * to return. Once this returned, the sink is never called again and can be
+ * destroyed. This can also be called from the sink itself.
+ */
+void Video::Renderer::removeSink(Sink* sink)
+{
+   QMutexLocker dispatchLk {&d_ptr->m_DispatchMutex};
+   QMutexLocker lk {d_ptr->m_pMutex};
+
+   d_ptr->m_lSinks.removeAll(sink);
+
+   if (d_ptr->m_lSinks.isEmpty())
+      d_ptr->m_SharedFrame.data.clear();
+}
+
+///Release a frame obtained from acquireFrame(), unbalanced calls are ignored
+void Video::Renderer::releaseFrame(const Frame& frame) const
+{
+   if (!frame.data)
+      return;
+
+   QMutexLocker lk {d_ptr->m_pMutex};
+
+   auto i = d_ptr->m_hLeases.find(frame.data);
+
+   if (i == d_ptr->m_hLeases.end()) {
+      qWarning() << "Releasing a frame that is not leased" << objectName();
+      return;
+   }
+
+   if (!--i.value().count)
+      d_ptr->m_hLeases.erase(i);
+}
+
 /*****************************************************************************
  *                                                                           *
  *                                 Setters                                   *
@@ -84,4 +585,42 @@ void Video::Renderer::setSize(const QSize& size) const
   d_ptr->m_pSize = size;
 }
 
+/**
+ * Limit the rate of frameUpdated().
+ *
+ * Frames arriving faster are coalesced: only the latest one is notified
+ * once the interval elapsed. This is intended for small previews that do
+ * not need the full frame rate.
+ *
+ * @param fps the maximum rate, 0 to notify every frame
+ */
+void Video::Renderer::setMaximumFrameRate(int fps)
+{
+  d_ptr->m_MaxFrameRate = fps > 0 ? fps : 0;
+}
+
+/**
+ * Skip frames that could not be notified in time.
+ *
+ * @param ms the maximum age of a frame when frameUpdated() is emitted, 0 to
+ *           never skip frames
+ */
+void Video::Renderer::setStaleFrameDeadline(int ms)
+{
+  d_ptr->m_StaleDeadline = ms > 0 ? ms : 0;
+}
+
+/**
+ * Convert the frames to the colorspace used by the client.
+ *
+ * The conversion is done once per frame in the renderer thread, the
+ * converted frame is then shared by all views.
+ */
+void Video::Renderer::setPreferredColorSpace(ColorSpace colorSpace)
+{
+  QMutexLocker lk {d_ptr->m_pMutex};
+  d_ptr->m_HasPreferredColorSpace = true;
+  d_ptr->m_PreferredColorSpace    = colorSpace;
+}
+
 #include <renderer.moc>
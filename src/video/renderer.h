@@ -23,6 +23,8 @@
 #include <typedefs.h>
 
 //Qt
+#include <QtCore/QByteArray>
+#include <QtCore/QSize>
 class QMutex;
 
 //Ring
@@ -36,6 +38,8 @@ class ShmRendererPrivate;
 class ShmRenderer;
 class DirectRendererPrivate;
 class DirectRenderer;
+class CompositorPrivate;
+class Compositor;
 
 /**
  * This class provide a rendering object to be used by clients
@@ -55,6 +59,8 @@ class LIB_EXPORT Renderer : public QObject
    friend class Video::ShmRenderer          ;
    friend class Video::DirectRendererPrivate;
    friend class Video::DirectRenderer       ;
+   friend class Video::CompositorPrivate    ;
+   friend class Video::Compositor           ;
    friend class VideoRendererManagerPrivate ;
 
 public:
@@ -68,6 +74,72 @@ public:
       RGBA , /*!< 32bit ALPHA GREEN RED BLUE  */
    };
 
+   /**
+    * A view on the current frame obtained from acquireFrame().
+    *
+    * As long as the frame is not released, the memory it point to is
+    * neither modified nor freed, even if the renderer moved on to newer
+    * frames. This allow clients to upload it directly to a texture without
+    * holding mutex() for the duration.
+    */
+   struct Frame {
+      const char* data      ; /*!< First byte of the frame, nullptr if there is none */
+      uint        size      ; /*!< Size of the frame in bytes                         */
+      uint        stride    ; /*!< Size of a line in bytes                            */
+      QSize       resolution; /*!< Width and height in pixels                         */
+      ColorSpace  colorSpace; /*!< Pixel format of the data                           */
+      uint        frameGen  ; /*!< Generation of the frame, increase for each frame   */
+      qint64      timestamp ; /*!< Reception time in ms, on a monotonic clock         */
+   };
+
+   /**
+    * A frame owned by its receivers.
+    *
+    * The data is implicitly shared between all the sinks of a renderer and
+    * is never modified once delivered, it can be kept for as long as needed.
+    */
+   struct SharedFrame {
+      QByteArray  data      ; /*!< Tightly packed pixels, empty if there is no frame */
+      QSize       resolution; /*!< Width and height in pixels                         */
+      ColorSpace  colorSpace; /*!< Pixel format of the data                           */
+      uint        frameGen  ; /*!< Generation of the frame, increase for each frame   */
+      qint64      timestamp ; /*!< Reception time in ms, on a monotonic clock         */
+   };
+
+   /**
+    * A consumer of the frames.
+    *
+    * Each frame is fetched and converted once, then handed to every sink
+    * registered with addSink(). The sinks are called from the renderer
+    * thread, in place of a frameUpdated() connection.
+    */
+   class Sink {
+   public:
+      virtual ~Sink() {}
+
+      ///Called for each new frame, this must not block
+      virtual void frameReady(const SharedFrame& frame) = 0;
+   };
+
+   ///Upper bounds (in ms) of the frame age histogram buckets, the last one is open
+   constexpr static const int FRAME_AGE_BUCKETS[] = { 5, 10, 20, 40, 80, 160 };
+   constexpr static const int FRAME_AGE_BUCKET_COUNT = 7;
+
+   /**
+    * Counters of the frame pipeline, see statistics()
+    */
+   struct Statistics {
+      uint   deliveredFrames; /*!< Frames notified with frameUpdated()                      */
+      uint   droppedFrames  ; /*!< Frames lost before or by the renderer, see below         */
+      uint   coalescedFrames; /*!< Frames replaced by a newer one because of the pacing     */
+      uint   staleFrames    ; /*!< Frames skipped because of the stale deadline             */
+      double jitter         ; /*!< Mean deviation of the inter-frame interval, in ms        */
+      qint64 lockWaitTime   ; /*!< Total time waiting for the producer lock, in µs          */
+      uint   remapCount     ; /*!< Number of times the frame memory had to be remapped      */
+      qint64 remapTime      ; /*!< Total time spent remapping the frame memory, in µs       */
+      uint   frameAge[FRAME_AGE_BUCKET_COUNT]; /*!< Age of the frames read by the clients  */
+   };
+
    //Constructor
    Renderer (const QByteArray& id,  const QSize& res);
    virtual ~Renderer();
@@ -78,8 +150,28 @@ public:
    virtual QSize             size            () const;
    virtual QMutex*           mutex           () const;
    virtual ColorSpace        colorSpace      () const = 0;
+   int                       maximumFrameRate  () const;
+   int                       staleFrameDeadline() const;
+   Statistics                statistics        () const;
+
+   //Frame lease
+   Frame acquireFrame(                   ) const;
+   void  releaseFrame(const Frame& frame ) const;
+
+   //Scaled outputs
+   void       addScaledOutput   (const QSize& size);
+   void       removeScaledOutput(const QSize& size);
+   QByteArray scaledFrame       (const QSize& size) const;
+
+   //Sinks
+   void        addSink    (Sink* sink);
+   void        removeSink (Sink* sink);
+   SharedFrame sharedFrame(          ) const;
 
    void setSize(const QSize& size) const;
+   void setPreferredColorSpace(ColorSpace colorSpace);
+   void setMaximumFrameRate   (int fps            );
+   void setStaleFrameDeadline (int ms             );
 
 Q_SIGNALS:
    void frameUpdated(); // Emitted when a new frame is ready
@@ -0,0 +1,246 @@
+/****************************************************************************
+ *   Copyright (C) 2015 by Savoir-Faire Linux                               *
+ *   Author : Emmanuel Lepage Vallee <emmanuel.lepage@savoirfairelinux.com> *
+ *                                                                          *
+ *   This library is free software; you can redistribute it and/or          *
+ *   modify it under the terms of the GNU Lesser General Public             *
+ *   License as published by the Free Software Foundation; either           *
+ *   version 2.1 of the License, or (at your option) any later version.     *
+ *                                                                          *
+ *   This library is distributed in the hope that it will be useful,        *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU      *
+ *   Lesser General Public License for more details.                        *
+ *                                                                          *
+ *   You should have received a copy of the GNU General Public License      *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>.  *
+ ***************************************************************************/
+#include "rendererstatisticsmodel.h"
+
+//Qt
+#include <QtCore/QCoreApplication>
+#include <QtCore/QTimer>
+
+//Ring
+#include "video/renderer.h"
+#include "private/videorenderermanager.h"
+
+Video::RendererStatisticsModel* Video::RendererStatisticsModel::m_spInstance = nullptr;
+
+namespace Video {
+
+class RendererStatisticsModelPrivate : public QObject
+{
+   Q_OBJECT
+public:
+   RendererStatisticsModelPrivate(RendererStatisticsModel* parent);
+
+   //Constants
+   constexpr static const int REFRESH_INTERVAL = 1000;
+
+   //Attributes
+   QList<Video::Renderer*> m_lRenderers;
+   QTimer*                 m_pTimer    ;
+
+private:
+   Video::RendererStatisticsModel* q_ptr;
+
+public Q_SLOTS:
+   void slotRendererAdded  (Video::Renderer* r);
+   void slotRendererRemoved(Video::Renderer* r);
+   void slotRefresh        (                  );
+};
+
+}
+
+Video::RendererStatisticsModelPrivate::RendererStatisticsModelPrivate(RendererStatisticsModel* parent) :
+QObject(parent), q_ptr(parent), m_pTimer(new QTimer(this))
+{
+   m_pTimer->setInterval(REFRESH_INTERVAL);
+   connect(m_pTimer, &QTimer::timeout, this, &RendererStatisticsModelPrivate::slotRefresh);
+}
+
+Video::RendererStatisticsModel::RendererStatisticsModel() : QAbstractTableModel(QCoreApplication::instance()),
+d_ptr(new RendererStatisticsModelPrivate(this))
+{
+   VideoRendererManager* m = VideoRendererManager::instance();
+
+   d_ptr->m_lRenderers = m->renderers();
+
+   connect(m, &VideoRendererManager::rendererAdded  , d_ptr, &RendererStatisticsModelPrivate::slotRendererAdded  );
+   connect(m, &VideoRendererManager::rendererRemoved, d_ptr, &RendererStatisticsModelPrivate::slotRendererRemoved);
+
+   if (d_ptr->m_lRenderers.size())
+      d_ptr->m_pTimer->start();
+}
+
+Video::RendererStatisticsModel::~RendererStatisticsModel()
+{
+   delete d_ptr;
+}
+
+Video::RendererStatisticsModel* Video::RendererStatisticsModel::instance()
+{
+   if (!m_spInstance)
+      m_spInstance = new RendererStatisticsModel();
+
+   return m_spInstance;
+}
+
+QHash<int,QByteArray> Video::RendererStatisticsModel::roleNames() const
+{
+   static QHash<int, QByteArray> roles = QAbstractItemModel::roleNames();
+   static bool initRoles = false;
+   if (!initRoles) {
+      initRoles = true;
+      roles[Role::Object           ] = "object";
+      roles[Role::FrameAgeHistogram] = "frameAgeHistogram";
+   }
+   return roles;
+}
+
+QVariant Video::RendererStatisticsModel::data( const QModelIndex& index, int role) const
+{
+   if (!index.isValid() || index.row() >= d_ptr->m_lRenderers.size())
+      return QVariant();
+
+   Video::Renderer* r = d_ptr->m_lRenderers[index.row()];
+
+   if (role == Role::Object)
+      return QVariant::fromValue(r);
+
+   const Video::Renderer::Statistics s = r->statistics();
+
+   if (role == Role::FrameAgeHistogram) {
+      QVariantList ret;
+      for (const uint bucket : s.frameAge)
+         ret << bucket;
+      return ret;
+   }
+
+   if (role != Qt::DisplayRole)
+      return QVariant();
+
+   switch(static_cast<Columns>(index.column())) {
+      case Columns::NAME:
+         return r->objectName();
+      case Columns::DELIVERED:
+         return s.deliveredFrames;
+      case Columns::DROPPED:
+         return s.droppedFrames;
+      case Columns::JITTER:
+         return s.jitter;
+      case Columns::LOCK_WAIT:
+         return static_cast<double>(s.lockWaitTime) / 1000.0;
+      case Columns::REMAPS:
+         return s.remapCount;
+      case Columns::REMAP_TIME:
+         return static_cast<double>(s.remapTime) / 1000.0;
+      case Columns::FRAME_AGE: {
+         QStringList buckets;
+         for (const uint bucket : s.frameAge)
+            buckets << QString::number(bucket);
+         return buckets.join('/');
+      }
+      case Columns::COUNT__:
+         break;
+   }
+
+   return QVariant();
+}
+
+QVariant Video::RendererStatisticsModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+   if (orientation != Qt::Horizontal || role != Qt::DisplayRole)
+      return QVariant();
+
+   switch(static_cast<Columns>(section)) {
+      case Columns::NAME:
+         return tr("Renderer");
+      case Columns::DELIVERED:
+         return tr("Delivered");
+      case Columns::DROPPED:
+         return tr("Dropped");
+      case Columns::JITTER:
+         return tr("Jitter (ms)");
+      case Columns::LOCK_WAIT:
+         return tr("Lock wait (ms)");
+      case Columns::REMAPS:
+         return tr("Remaps");
+      case Columns::REMAP_TIME:
+         return tr("Remap time (ms)");
+      case Columns::FRAME_AGE:
+         return tr("Frame age");
+      case Columns::COUNT__:
+         break;
+   }
+
+   return QVariant();
+}
+
+int Video::RendererStatisticsModel::rowCount( const QModelIndex& parent ) const
+{
+   return parent.isValid() ? 0 : d_ptr->m_lRenderers.size();
+}
+
+int Video::RendererStatisticsModel::columnCount( const QModelIndex& parent ) const
+{
+   return parent.isValid() ? 0 : enum_class_size<Columns>();
+}
+
+Qt::ItemFlags Video::RendererStatisticsModel::flags( const QModelIndex& index ) const
+{
+   if (!index.isValid())
+      return Qt::NoItemFlags;
+
+   return Qt::ItemIsEnabled | Qt::ItemIsSelectable;
+}
+
+bool Video::RendererStatisticsModel::setData( const QModelIndex& index, const QVariant &value, int role)
+{
+   Q_UNUSED(index)
+   Q_UNUSED(value)
+   Q_UNUSED(role)
+   return false;
+}
+
+void Video::RendererStatisticsModelPrivate::slotRendererAdded(Video::Renderer* r)
+{
+   if (m_lRenderers.indexOf(r) != -1)
+      return;
+
+   q_ptr->beginInsertRows(QModelIndex(), m_lRenderers.size(), m_lRenderers.size());
+   m_lRenderers << r;
+   q_ptr->endInsertRows();
+
+   if (!m_pTimer->isActive())
+      m_pTimer->start();
+}
+
+void Video::RendererStatisticsModelPrivate::slotRendererRemoved(Video::Renderer* r)
+{
+   const int idx = m_lRenderers.indexOf(r);
+
+   if (idx == -1)
+      return;
+
+   q_ptr->beginRemoveRows(QModelIndex(), idx, idx);
+   m_lRenderers.removeAt(idx);
+   q_ptr->endRemoveRows();
+
+   if (m_lRenderers.isEmpty())
+      m_pTimer->stop();
+}
+
+void Video::RendererStatisticsModelPrivate::slotRefresh()
+{
+   if (m_lRenderers.isEmpty())
+      return;
+
+   emit q_ptr->dataChanged(
+      q_ptr->index(0, 1),
+      q_ptr->index(m_lRenderers.size() - 1, enum_class_size<RendererStatisticsModel::Columns>() - 1)
+   );
+}
+
+#include <rendererstatisticsmodel.moc>
@@ -0,0 +1,88 @@
+/****************************************************************************
+ *   Copyright (C) 2015 by Savoir-Faire Linux                               *
+ *   Author : Emmanuel Lepage Vallee <emmanuel.lepage@savoirfairelinux.com> *
+ *                                                                          *
+ *   This library is free software; you can redistribute it and/or          *
+ *   modify it under the terms of the GNU Lesser General Public             *
+ *   License as published by the Free Software Foundation; either           *
+ *   version 2.1 of the License, or (at your option) any later version.     *
+ *                                                                          *
+ *   This library is distributed in the hope that it will be useful,        *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU      *
+ *   Lesser General Public License for more details.                        *
+ *                                                                          *
+ *   You should have received a copy of the GNU General Public License      *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>.  *
+ ***************************************************************************/
+#ifndef VIDEO_RENDERERSTATISTICSMODEL_H
+#define VIDEO_RENDERERSTATISTICSMODEL_H
+
+#include <typedefs.h>
+#include <QtCore/QAbstractTableModel>
+
+namespace Video {
+
+class Renderer;
+class RendererStatisticsModelPrivate;
+
+/**
+ * This model expose the frame pipeline counters of every active renderer,
+ * one row per renderer. It is intended to help finding if a stutter come
+ * from the daemon, the frame handoff or the views.
+ *
+ * The values are refreshed every second while there is at least one
+ * renderer.
+ */
+class LIB_EXPORT RendererStatisticsModel : public QAbstractTableModel {
+   #pragma GCC diagnostic push
+   #pragma GCC diagnostic ignored "-Wzero-as-null-pointer-constant"
+   Q_OBJECT
+   #pragma GCC diagnostic pop
+
+public:
+
+   enum class Columns {
+      NAME      , /*!< The renderer object name                            */
+      DELIVERED , /*!< Frames notified to the views                        */
+      DROPPED   , /*!< Frames missed, coalesced or stale                   */
+      JITTER    , /*!< Inter-frame jitter, in ms                           */
+      LOCK_WAIT , /*!< Time spent waiting for the producer lock, in ms     */
+      REMAPS    , /*!< Number of shared memory remaps                      */
+      REMAP_TIME, /*!< Time spent remapping the shared memory, in ms      */
+      FRAME_AGE , /*!< Histogram of the frame age when read by the views   */
+      COUNT__
+   };
+
+   enum Role {
+      Object            = Qt::UserRole + 1, /*!< The Video::Renderer                 */
+      FrameAgeHistogram = Qt::UserRole + 2, /*!< FRAME_AGE buckets as a QVariantList */
+   };
+
+   //Model functions
+   virtual QVariant      data        ( const QModelIndex& index, int role = Qt::DisplayRole     ) const override;
+   virtual int           rowCount    ( const QModelIndex& parent = QModelIndex()                ) const override;
+   virtual int           columnCount ( const QModelIndex& parent = QModelIndex()                ) const override;
+   virtual Qt::ItemFlags flags       ( const QModelIndex& index                                 ) const override;
+   virtual bool          setData     ( const QModelIndex& index, const QVariant &value, int role)       override;
+   virtual QVariant      headerData  ( int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
+   virtual QHash<int,QByteArray> roleNames() const override;
+
+   //Singleton
+   static RendererStatisticsModel* instance();
+
+private:
+   explicit RendererStatisticsModel();
+   virtual ~RendererStatisticsModel();
+
+   RendererStatisticsModelPrivate* d_ptr;
+   Q_DECLARE_PRIVATE(RendererStatisticsModel)
+
+   static RendererStatisticsModel* m_spInstance;
+};
+
+}
+
+Q_DECLARE_METATYPE(Video::RendererStatisticsModel*)
+
+#endif
@@ -35,8 +35,9 @@ namespace Video {
 ///@struct Resolution Equivalent of "640x480"
 class LIB_EXPORT Resolution : public QAbstractListModel {
    Q_OBJECT
-   //Only Video::Device can add validated rates
+   //Only Video::Device and Video::Channel can add validated rates
    friend class Video::Device;
+   friend class Video::Channel;
 public:
    //Constructor
    Resolution(const QString& size, Video::Channel* chan);